@@ -0,0 +1,316 @@
+#include "lunetix/browser/adblock/lunetix_ad_block_service.h"
+
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/task/thread_pool.h"
+#include "base/time/time.h"
+#include "components/prefs/pref_service.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/render_process_host_creation_observer.h"
+#include "ipc/ipc_channel_proxy.h"
+#include "lunetix/browser/prefs/lunetix_pref_service.h"
+#include "lunetix/common/adblock/ruleset_builder.h"
+#include "lunetix/common/adblock/ruleset_matcher.h"
+#include "lunetix/common/mojom/ad_block.mojom.h"
+#include "mojo/public/cpp/bindings/associated_remote.h"
+
+namespace lunetix {
+
+namespace {
+
+// Written by lunetix_filter_compiler, or compiled from kFilterListFilename.
+const base::FilePath::CharType kRulesetFilename[] =
+    FILE_PATH_LITERAL("Ruleset");
+const base::FilePath::CharType kFilterListFilename[] =
+    FILE_PATH_LITERAL("Filters.txt");
+
+// Hosts whose element hiding style sheet is kept around.
+constexpr size_t kMaxCachedStyleSheets = 64;
+
+bool CompileFilterList(const base::FilePath& list_path,
+                       const base::FilePath& ruleset_path) {
+  std::string filter_list;
+  if (!base::ReadFileToString(list_path, &filter_list)) {
+    return false;
+  }
+  adblock::RulesetBuilder builder;
+  builder.AddFilterList(filter_list);
+  return base::ImportantFileWriter::WriteFileAtomically(ruleset_path,
+                                                        builder.Build());
+}
+
+// One rule per selector, so that a selector this engine does not support
+// only drops itself rather than the whole group.
+std::string BuildStyleSheet(const std::vector<base::StringPiece>& selectors) {
+  std::string style_sheet;
+  for (base::StringPiece selector : selectors) {
+    selector.AppendToString(&style_sheet);
+    style_sheet.append("{display:none !important}\n");
+  }
+  return style_sheet;
+}
+
+}  // namespace
+
+class LunetixAdBlockService::Ruleset
+    : public base::RefCountedThreadSafe<Ruleset> {
+ public:
+  // Runs on a background sequence. Returns null if there is no usable
+  // ruleset, or if neither file changed since |current| was loaded.
+  static scoped_refptr<Ruleset> Load(const base::FilePath& ruleset_dir,
+                                     scoped_refptr<Ruleset> current) {
+    base::FilePath ruleset_path = ruleset_dir.Append(kRulesetFilename);
+    base::FilePath list_path = ruleset_dir.Append(kFilterListFilename);
+    base::File::Info list_info;
+    base::File::Info ruleset_info;
+    bool has_list = base::GetFileInfo(list_path, &list_info);
+    bool has_ruleset = base::GetFileInfo(ruleset_path, &ruleset_info);
+    base::Time list_time = has_list ? list_info.last_modified : base::Time();
+    if (current && has_ruleset && current->list_time_ == list_time &&
+        current->ruleset_time_ == ruleset_info.last_modified) {
+      return nullptr;
+    }
+
+    // A list replaced since |current| was built is compiled even if it is
+    // older than the ruleset, as when a previous list is copied back.
+    bool compiled = false;
+    if (has_list && (!has_ruleset ||
+                     list_time > ruleset_info.last_modified ||
+                     (current && current->list_time_ != list_time))) {
+      compiled = CompileFilterList(list_path, ruleset_path);
+    }
+
+    scoped_refptr<adblock::MappedRuleset> mapped = Open(ruleset_path);
+    // A ruleset written by an older version is rebuilt from the list.
+    if (!mapped && has_list && !compiled &&
+        CompileFilterList(list_path, ruleset_path)) {
+      mapped = Open(ruleset_path);
+    }
+    if (!mapped) {
+      return nullptr;
+    }
+    if (!base::GetFileInfo(ruleset_path, &ruleset_info)) {
+      ruleset_info.last_modified = base::Time();
+    }
+    return base::WrapRefCounted(new Ruleset(
+        std::move(mapped), list_time, ruleset_info.last_modified));
+  }
+
+  const scoped_refptr<const adblock::MappedRuleset>& mapped() const {
+    return mapped_;
+  }
+  const adblock::RulesetMatcher& matcher() const { return mapped_->matcher(); }
+
+  std::string GetHostStyleSheet(const std::string& host) {
+    base::AutoLock lock(style_sheets_lock_);
+    auto it = style_sheets_.Get(host);
+    if (it != style_sheets_.end()) {
+      return it->second;
+    }
+    std::string style_sheet =
+        BuildStyleSheet(matcher().GetHostSelectors(host));
+    style_sheets_.Put(host, style_sheet);
+    return style_sheet;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<Ruleset>;
+
+  static scoped_refptr<adblock::MappedRuleset> Open(
+      const base::FilePath& ruleset_path) {
+    return adblock::MappedRuleset::Open(base::File(
+        ruleset_path, base::File::FLAG_OPEN | base::File::FLAG_READ));
+  }
+
+  Ruleset(scoped_refptr<const adblock::MappedRuleset> mapped,
+          base::Time list_time,
+          base::Time ruleset_time)
+      : mapped_(std::move(mapped)),
+        list_time_(list_time),
+        ruleset_time_(ruleset_time),
+        style_sheets_(kMaxCachedStyleSheets) {}
+  ~Ruleset() = default;
+
+  scoped_refptr<const adblock::MappedRuleset> mapped_;
+
+  // Modification times of the filter list, null without one, and of the
+  // ruleset file this was loaded from.
+  const base::Time list_time_;
+  const base::Time ruleset_time_;
+
+  // Host style sheets built from this ruleset, so that swapping the ruleset
+  // drops them with it.
+  base::Lock style_sheets_lock_;
+  base::MRUCache<std::string, std::string> style_sheets_
+      GUARDED_BY(style_sheets_lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(Ruleset);
+};
+
+// Hands the ruleset file to every renderer, which maps it itself, so that
+// subresource requests are matched before they leave the renderer.
+class LunetixAdBlockService::RendererPublisher
+    : public content::RenderProcessHostCreationObserver {
+ public:
+  explicit RendererPublisher(LunetixAdBlockService* service)
+      : service_(service) {}
+  ~RendererPublisher() override = default;
+
+  void PublishToAll() {
+    for (content::RenderProcessHost::iterator it =
+             content::RenderProcessHost::AllHostsIterator();
+         !it.IsAtEnd(); it.Advance()) {
+      Publish(it.GetCurrentValue());
+    }
+  }
+
+  // content::RenderProcessHostCreationObserver overrides:
+  void OnRenderProcessHostCreated(content::RenderProcessHost* host) override {
+    Publish(host);
+  }
+
+ private:
+  void Publish(content::RenderProcessHost* host) {
+    IPC::ChannelProxy* channel = host->GetChannel();
+    if (!channel) {
+      return;
+    }
+    scoped_refptr<const adblock::MappedRuleset> ruleset =
+        service_->GetMappedRuleset();
+    mojo::AssociatedRemote<mojom::AdBlockRulesetObserver> observer;
+    channel->GetRemoteAssociatedInterface(&observer);
+    observer->SetRuleset(ruleset ? ruleset->DuplicateFile() : base::File());
+    observer->SetTrackerBlockingEnabled(service_->IsTrackerBlockingEnabled());
+  }
+
+  LunetixAdBlockService* const service_;
+
+  DISALLOW_COPY_AND_ASSIGN(RendererPublisher);
+};
+
+// static
+LunetixAdBlockService* LunetixAdBlockService::GetInstance() {
+  static base::NoDestructor<LunetixAdBlockService> instance;
+  return instance.get();
+}
+
+LunetixAdBlockService::LunetixAdBlockService() {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+LunetixAdBlockService::~LunetixAdBlockService() = default;
+
+void LunetixAdBlockService::Start(PrefService* local_state,
+                                  const base::FilePath& ruleset_dir) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  ruleset_dir_ = ruleset_dir;
+  load_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+       base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN});
+  renderer_publisher_ = std::make_unique<RendererPublisher>(this);
+  pref_change_registrar_.Init(local_state);
+  pref_change_registrar_.Add(
+      LunetixPrefService::kLunetixEnableAdBlock,
+      base::BindRepeating(&LunetixAdBlockService::OnEnabledChanged,
+                          base::Unretained(this)));
+  pref_change_registrar_.Add(
+      LunetixPrefService::kLunetixBlockTrackers,
+      base::BindRepeating(&LunetixAdBlockService::OnTrackerBlockingChanged,
+                          base::Unretained(this)));
+  block_trackers_.store(
+      local_state->GetBoolean(LunetixPrefService::kLunetixBlockTrackers),
+      std::memory_order_relaxed);
+  OnEnabledChanged();
+}
+
+scoped_refptr<const adblock::MappedRuleset>
+LunetixAdBlockService::GetMappedRuleset() const {
+  scoped_refptr<Ruleset> ruleset = GetRuleset();
+  if (!IsEnabled() || !ruleset) {
+    return nullptr;
+  }
+  return ruleset->mapped();
+}
+
+std::string LunetixAdBlockService::GetHostStyleSheet(
+    const std::string& host) const {
+  scoped_refptr<Ruleset> ruleset = GetRuleset();
+  if (!IsEnabled() || !ruleset) {
+    return std::string();
+  }
+  return ruleset->GetHostStyleSheet(host);
+}
+
+std::string LunetixAdBlockService::GetKeyedStyleSheet(
+    base::StringPiece host,
+    const std::vector<std::string>& keys) const {
+  scoped_refptr<Ruleset> ruleset = GetRuleset();
+  if (!IsEnabled() || !ruleset) {
+    return std::string();
+  }
+  return BuildStyleSheet(ruleset->matcher().GetKeyedSelectors(host, keys));
+}
+
+bool LunetixAdBlockService::HasKeyedCosmeticRules() const {
+  scoped_refptr<Ruleset> ruleset = GetRuleset();
+  return IsEnabled() && ruleset &&
+         ruleset->matcher().has_keyed_cosmetic_rules();
+}
+
+void LunetixAdBlockService::OnEnabledChanged() {
+  bool enabled = pref_change_registrar_.prefs()->GetBoolean(
+      LunetixPrefService::kLunetixEnableAdBlock);
+  enabled_.store(enabled, std::memory_order_relaxed);
+  // The ruleset is loaded on first use and then kept, so turning blocking
+  // back on is instant. The filter list may have been updated meanwhile,
+  // in which case the new one is compiled and swapped in once it is ready.
+  if (!enabled || GetRuleset()) {
+    renderer_publisher_->PublishToAll();
+  }
+  if (enabled) {
+    LoadRuleset();
+  }
+}
+
+void LunetixAdBlockService::OnTrackerBlockingChanged() {
+  block_trackers_.store(pref_change_registrar_.prefs()->GetBoolean(
+                            LunetixPrefService::kLunetixBlockTrackers),
+                        std::memory_order_relaxed);
+  renderer_publisher_->PublishToAll();
+}
+
+void LunetixAdBlockService::LoadRuleset() {
+  // Loads run in order, so an older ruleset never replaces a newer one.
+  load_task_runner_->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&Ruleset::Load, ruleset_dir_, GetRuleset()),
+      base::BindOnce(&LunetixAdBlockService::OnRulesetLoaded,
+                     base::Unretained(this)));
+}
+
+void LunetixAdBlockService::OnRulesetLoaded(scoped_refptr<Ruleset> ruleset) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!ruleset) {
+    return;
+  }
+  // The previous ruleset is unmapped once the last request using it is
+  // done, in this process and in every renderer.
+  {
+    base::AutoLock lock(ruleset_lock_);
+    ruleset_ = std::move(ruleset);
+  }
+  renderer_publisher_->PublishToAll();
+}
+
+scoped_refptr<LunetixAdBlockService::Ruleset>
+LunetixAdBlockService::GetRuleset() const {
+  base::AutoLock lock(ruleset_lock_);
+  return ruleset_;
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef LUNETIX_BROWSER_ADBLOCK_LUNETIX_AD_BLOCK_SERVICE_H_
+#define LUNETIX_BROWSER_ADBLOCK_LUNETIX_AD_BLOCK_SERVICE_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
+#include "base/sequence_checker.h"
+#include "base/sequenced_task_runner.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "lunetix/common/adblock/mapped_ruleset.h"
+
+class PrefService;
+
+namespace lunetix {
+
+// Owns the content blocking ruleset. The compiled ruleset file is mapped
+// read-only on a background sequence and published as a whole, to this
+// process and to every renderer, so every request is matched against one
+// consistent ruleset while a new one is being loaded.
+class LunetixAdBlockService {
+ public:
+  static LunetixAdBlockService* GetInstance();
+
+  // Follows the ad blocking preference of |local_state| and loads the
+  // ruleset kept in |ruleset_dir|. A filter list next to it that is newer
+  // than the ruleset is compiled first, and again whenever blocking is
+  // turned on after the list changed.
+  void Start(PrefService* local_state, const base::FilePath& ruleset_dir);
+
+  // The ruleset requests are matched against, or null while blocking is
+  // off or no ruleset is loaded. Safe to call from any thread.
+  scoped_refptr<const adblock::MappedRuleset> GetMappedRuleset() const;
+
+  // Style sheet hiding the elements matched by the element hiding rules
+  // that apply to every document on |host|, or an empty string. Style
+  // sheets are cached per host for as long as the ruleset is loaded.
+  std::string GetHostStyleSheet(const std::string& host) const;
+
+  // Style sheet for the generic rules keyed by one of |keys|, the classes
+  // and ids found in a document on |host|.
+  std::string GetKeyedStyleSheet(base::StringPiece host,
+                                 const std::vector<std::string>& keys) const;
+
+  // Whether any generic rule is keyed by a class or id, which is when
+  // documents need to report theirs.
+  bool HasKeyedCosmeticRules() const;
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Whether third-party trackers are blocked, which does not need the
+  // ruleset. Safe to call from any thread.
+  bool IsTrackerBlockingEnabled() const {
+    return block_trackers_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  friend class base::NoDestructor<LunetixAdBlockService>;
+
+  class RendererPublisher;
+  class Ruleset;
+
+  LunetixAdBlockService();
+  ~LunetixAdBlockService();
+
+  void OnEnabledChanged();
+  void OnTrackerBlockingChanged();
+  void LoadRuleset();
+  void OnRulesetLoaded(scoped_refptr<Ruleset> ruleset);
+
+  scoped_refptr<Ruleset> GetRuleset() const;
+
+  base::FilePath ruleset_dir_;
+  scoped_refptr<base::SequencedTaskRunner> load_task_runner_;
+  std::unique_ptr<RendererPublisher> renderer_publisher_;
+  PrefChangeRegistrar pref_change_registrar_;
+  std::atomic<bool> enabled_{false};
+  std::atomic<bool> block_trackers_{false};
+
+  // Only the pointer swap happens under the lock; matching runs on a
+  // reference taken out of it.
+  mutable base::Lock ruleset_lock_;
+  scoped_refptr<Ruleset> ruleset_ GUARDED_BY(ruleset_lock_);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(LunetixAdBlockService);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_ADBLOCK_LUNETIX_AD_BLOCK_SERVICE_H_
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "lunetix/browser/adblock/lunetix_cosmetic_filters_host.h"
+
+#include <memory>
+#include <utility>
+
+#include "lunetix/browser/adblock/lunetix_ad_block_service.h"
+#include "mojo/public/cpp/bindings/self_owned_receiver.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+// Documents report keys in batches; anything beyond this is dropped rather
+// than matched, since the renderer is not trusted to keep batches small.
+constexpr size_t kMaxKeysPerCall = 2000;
+
+}  // namespace
+
+LunetixCosmeticFiltersHost::LunetixCosmeticFiltersHost() = default;
+
+LunetixCosmeticFiltersHost::~LunetixCosmeticFiltersHost() = default;
+
+// static
+void LunetixCosmeticFiltersHost::BindCosmeticFiltersHost(
+    content::RenderFrameHost* render_frame_host,
+    mojo::PendingReceiver<mojom::CosmeticFiltersHost> receiver) {
+  mojo::MakeSelfOwnedReceiver(std::make_unique<LunetixCosmeticFiltersHost>(),
+                              std::move(receiver));
+}
+
+void LunetixCosmeticFiltersHost::GetHostStyleSheet(
+    const GURL& document_url,
+    GetHostStyleSheetCallback callback) {
+  LunetixAdBlockService* service = LunetixAdBlockService::GetInstance();
+  if (!service->IsEnabled() || !document_url.SchemeIsHTTPOrHTTPS()) {
+    std::move(callback).Run(std::string(), false);
+    return;
+  }
+  std::move(callback).Run(service->GetHostStyleSheet(document_url.host()),
+                          service->HasKeyedCosmeticRules());
+}
+
+void LunetixCosmeticFiltersHost::GetKeyedStyleSheet(
+    const GURL& document_url,
+    const std::vector<std::string>& keys,
+    GetKeyedStyleSheetCallback callback) {
+  if (!document_url.SchemeIsHTTPOrHTTPS() || keys.size() > kMaxKeysPerCall) {
+    std::move(callback).Run(std::string());
+    return;
+  }
+  std::move(callback).Run(LunetixAdBlockService::GetInstance()
+                              ->GetKeyedStyleSheet(document_url.host_piece(),
+                                                   keys));
+}
+
+}  // namespace lunetix
\ No newline at end of file
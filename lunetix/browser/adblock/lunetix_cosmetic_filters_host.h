@@ -0,0 +1,40 @@
+#ifndef LUNETIX_BROWSER_ADBLOCK_LUNETIX_COSMETIC_FILTERS_HOST_H_
+#define LUNETIX_BROWSER_ADBLOCK_LUNETIX_COSMETIC_FILTERS_HOST_H_
+
+#include <string>
+#include <vector>
+
+#include "lunetix/common/mojom/cosmetic_filters.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+
+namespace content {
+class RenderFrameHost;
+}
+
+namespace lunetix {
+
+// Answers the element hiding requests of one frame from the ruleset of
+// LunetixAdBlockService.
+class LunetixCosmeticFiltersHost : public mojom::CosmeticFiltersHost {
+ public:
+  LunetixCosmeticFiltersHost();
+  ~LunetixCosmeticFiltersHost() override;
+
+  static void BindCosmeticFiltersHost(
+      content::RenderFrameHost* render_frame_host,
+      mojo::PendingReceiver<mojom::CosmeticFiltersHost> receiver);
+
+  // mojom::CosmeticFiltersHost overrides:
+  void GetHostStyleSheet(const GURL& document_url,
+                         GetHostStyleSheetCallback callback) override;
+  void GetKeyedStyleSheet(const GURL& document_url,
+                          const std::vector<std::string>& keys,
+                          GetKeyedStyleSheetCallback callback) override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LunetixCosmeticFiltersHost);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_ADBLOCK_LUNETIX_COSMETIC_FILTERS_HOST_H_
\ No newline at end of file
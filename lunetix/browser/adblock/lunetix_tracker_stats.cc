@@ -0,0 +1,129 @@
+#include "lunetix/browser/adblock/lunetix_tracker_stats.h"
+
+#include <utility>
+
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/render_frame_host.h"
+#include "lunetix/browser/adblock/lunetix_ad_block_service.h"
+#include "lunetix/common/trackers/tracker_classifier.h"
+#include "net/base/net_errors.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "services/network/public/mojom/fetch_api.mojom-shared.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+using network::mojom::RequestDestination;
+
+void Add(std::atomic<int64_t>& counter, int64_t value) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+int64_t Load(const std::atomic<int64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+// Typical compressed sizes of what trackers serve: tag manager and pixel
+// scripts, widget frames, and tracking pixels and beacons.
+int64_t EstimateResponseSize(RequestDestination destination) {
+  switch (destination) {
+    case RequestDestination::kScript:
+    case RequestDestination::kWorker:
+    case RequestDestination::kSharedWorker:
+    case RequestDestination::kServiceWorker:
+      return 40 * 1024;
+    case RequestDestination::kIframe:
+    case RequestDestination::kFrame:
+      return 20 * 1024;
+    case RequestDestination::kStyle:
+    case RequestDestination::kFont:
+      return 10 * 1024;
+    default:
+      return 1024;
+  }
+}
+
+bool IsFrameNavigation(RequestDestination destination) {
+  return destination == RequestDestination::kDocument ||
+         destination == RequestDestination::kIframe ||
+         destination == RequestDestination::kFrame;
+}
+
+std::string GetSite(const GURL& url) {
+  std::string site = net::registry_controlled_domains::GetDomainAndRegistry(
+      url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return site.empty() ? url.host() : site;
+}
+
+}  // namespace
+
+LunetixTrackerStats::LunetixTrackerStats(content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents) {}
+
+LunetixTrackerStats::~LunetixTrackerStats() = default;
+
+LunetixTrackerStats::Snapshot LunetixTrackerStats::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.blocked_request_count = Load(blocked_request_count_);
+  snapshot.cookie_stripped_request_count =
+      Load(cookie_stripped_request_count_);
+  snapshot.estimated_bytes_saved = Load(estimated_bytes_saved_);
+  return snapshot;
+}
+
+void LunetixTrackerStats::DidFinishNavigation(
+    content::NavigationHandle* navigation_handle) {
+  if (!navigation_handle->IsInMainFrame() ||
+      !navigation_handle->HasCommitted() ||
+      navigation_handle->IsSameDocument()) {
+    return;
+  }
+  std::string site = GetSite(navigation_handle->GetURL());
+  if (site == site_) {
+    return;
+  }
+
+  site_ = std::move(site);
+  blocked_request_count_.store(0, std::memory_order_relaxed);
+  cookie_stripped_request_count_.store(0, std::memory_order_relaxed);
+  estimated_bytes_saved_.store(0, std::memory_order_relaxed);
+}
+
+void LunetixTrackerStats::ResourceLoadComplete(
+    content::RenderFrameHost* render_frame_host,
+    const content::GlobalRequestID& request_id,
+    const blink::mojom::ResourceLoadInfo& resource_load_info) {
+  if (!LunetixAdBlockService::GetInstance()->IsTrackerBlockingEnabled()) {
+    return;
+  }
+
+  const GURL& url = resource_load_info.final_url;
+  if (resource_load_info.net_error == net::ERR_BLOCKED_BY_CLIENT) {
+    // Blocked as a tracker or by a filter list; trackers the lists caught
+    // count as well.
+    const trackers::TrackerDomain* tracker =
+        trackers::FindTrackerDomain(url.host_piece());
+    if (tracker && tracker->category != trackers::TrackerCategory::kContent) {
+      Add(blocked_request_count_, 1);
+      Add(estimated_bytes_saved_,
+          EstimateResponseSize(resource_load_info.request_destination));
+    }
+    return;
+  }
+
+  // Mirrors the throttle, which leaves frame navigations their cookies.
+  if (resource_load_info.net_error == net::OK &&
+      !IsFrameNavigation(resource_load_info.request_destination) &&
+      trackers::GetTrackerAction(
+          url, render_frame_host->GetLastCommittedOrigin()) ==
+          trackers::TrackerAction::kStripCookies) {
+    Add(cookie_stripped_request_count_, 1);
+  }
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(LunetixTrackerStats);
+
+}  // namespace lunetix
\ No newline at end of file
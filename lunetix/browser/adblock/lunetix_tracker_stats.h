@@ -0,0 +1,69 @@
+#ifndef LUNETIX_BROWSER_ADBLOCK_LUNETIX_TRACKER_STATS_H_
+#define LUNETIX_BROWSER_ADBLOCK_LUNETIX_TRACKER_STATS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+namespace lunetix {
+
+// Trackers kept away from the site shown in a tab. Requests are blocked in
+// the process that makes them, so they are counted here from the resource
+// loads that frames report once they complete, a report renderers send for
+// every request anyway. The counters are relaxed atomics that the UI, such as
+// the page info bubble, samples from any thread, so no request costs an IPC
+// of its own.
+//
+// The counters belong to one site and start over when the tab commits a page
+// of another one.
+class LunetixTrackerStats
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<LunetixTrackerStats> {
+ public:
+  struct Snapshot {
+    int64_t blocked_request_count = 0;
+    int64_t cookie_stripped_request_count = 0;
+    // What the blocked requests would have downloaded, estimated from their
+    // kind since they never got a response.
+    int64_t estimated_bytes_saved = 0;
+  };
+
+  ~LunetixTrackerStats() override;
+
+  // Registrable domain of the page in the tab, or its host when it has
+  // none. Only on the UI thread.
+  const std::string& site() const { return site_; }
+
+  Snapshot GetSnapshot() const;
+
+  // WebContentsObserver overrides:
+  void DidFinishNavigation(
+      content::NavigationHandle* navigation_handle) override;
+  void ResourceLoadComplete(
+      content::RenderFrameHost* render_frame_host,
+      const content::GlobalRequestID& request_id,
+      const blink::mojom::ResourceLoadInfo& resource_load_info) override;
+
+ private:
+  friend class content::WebContentsUserData<LunetixTrackerStats>;
+
+  explicit LunetixTrackerStats(content::WebContents* web_contents);
+
+  std::string site_;
+
+  std::atomic<int64_t> blocked_request_count_{0};
+  std::atomic<int64_t> cookie_stripped_request_count_{0};
+  std::atomic<int64_t> estimated_bytes_saved_{0};
+
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+
+  DISALLOW_COPY_AND_ASSIGN(LunetixTrackerStats);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_ADBLOCK_LUNETIX_TRACKER_STATS_H_
\ No newline at end of file
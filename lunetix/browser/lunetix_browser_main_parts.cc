@@ -2,15 +2,36 @@
 
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/files/file_path.h"
 #include "base/path_service.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile_manager.h"
 #include "chrome/common/chrome_paths.h"
+#include "lunetix/browser/adblock/lunetix_ad_block_service.h"
 #include "lunetix/browser/lunetix_browser_process.h"
+#include "lunetix/browser/net/lunetix_user_agent.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor_factory.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache_factory.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager_factory.h"
 #include "lunetix/common/lunetix_paths.h"
 
 namespace lunetix {
 
+namespace {
+
+const base::FilePath::CharType kFiltersDirname[] =
+    FILE_PATH_LITERAL("Lunetix Filters");
+
+// Keyed service factories have to exist before the first profile is
+// created so their dependencies are registered.
+void EnsureLunetixKeyedServiceFactoriesBuilt() {
+  LunetixPreconnectPredictorFactory::GetInstance();
+  LunetixReadingModeCacheFactory::GetInstance();
+  LunetixWorkspaceManagerFactory::GetInstance();
+}
+
+}  // namespace
+
 LunetixBrowserMainParts::LunetixBrowserMainParts(bool is_integration_test)
     : ChromeBrowserMainParts(is_integration_test) {}
 
@@ -38,10 +59,22 @@ int LunetixBrowserMainParts::PreCreateThreads() {
 
 void LunetixBrowserMainParts::PostCreateThreads() {
   ChromeBrowserMainParts::PostCreateThreads();
+  EnsureLunetixKeyedServiceFactoriesBuilt();
 }
 
 int LunetixBrowserMainParts::PreMainMessageLoopRun() {
-  return ChromeBrowserMainParts::PreMainMessageLoopRun();
+  int result = ChromeBrowserMainParts::PreMainMessageLoopRun();
+  
+  LunetixUserAgent::GetInstance()->Start(g_browser_process->local_state());
+  
+  base::FilePath user_data_dir;
+  if (base::PathService::Get(chrome::DIR_USER_DATA, &user_data_dir)) {
+    LunetixAdBlockService::GetInstance()->Start(
+        g_browser_process->local_state(),
+        user_data_dir.Append(kFiltersDirname));
+  }
+  
+  return result;
 }
 
 void LunetixBrowserMainParts::PostMainMessageLoopRun() {
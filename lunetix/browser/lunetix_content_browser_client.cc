@@ -3,10 +3,13 @@
 #include "base/command_line.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/chrome_browser_main.h"
-#include "chrome/common/chrome_version.h"
-#include "content/public/common/user_agent.h"
+#include "lunetix/browser/adblock/lunetix_ad_block_service.h"
+#include "lunetix/browser/adblock/lunetix_cosmetic_filters_host.h"
 #include "lunetix/browser/lunetix_browser_main_parts.h"
+#include "lunetix/browser/net/lunetix_user_agent.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
 #include "lunetix/common/lunetix_constants.h"
+#include "lunetix/common/net/lunetix_url_loader_throttle.h"
 
 namespace lunetix {
 
@@ -26,9 +29,11 @@ std::string LunetixContentBrowserClient::GetApplicationName() {
 }
 
 std::string LunetixContentBrowserClient::GetUserAgent() {
-  std::string user_agent = content::BuildUserAgentFromProduct(
-      kLunetixProductName "/" CHROME_VERSION_STRING);
-  return user_agent;
+  return LunetixUserAgent::GetInstance()->GetUserAgent();
+}
+
+blink::UserAgentMetadata LunetixContentBrowserClient::GetUserAgentMetadata() {
+  return LunetixUserAgent::GetInstance()->GetUserAgentMetadata();
 }
 
 std::u16string LunetixContentBrowserClient::GetApplicationNameForProtocolHandler() {
@@ -42,4 +47,35 @@ void LunetixContentBrowserClient::AppendExtraCommandLineSwitches(
                                                               child_process_id);
 }
 
+void LunetixContentBrowserClient::RegisterBrowserInterfaceBindersForFrame(
+    content::RenderFrameHost* render_frame_host,
+    mojo::BinderMapWithContext<content::RenderFrameHost*>* map) {
+  ChromeContentBrowserClient::RegisterBrowserInterfaceBindersForFrame(
+      render_frame_host, map);
+  map->Add<mojom::ReadabilityHost>(
+      base::BindRepeating(&LunetixReadingMode::BindReadabilityHost));
+  map->Add<mojom::CosmeticFiltersHost>(base::BindRepeating(
+      &LunetixCosmeticFiltersHost::BindCosmeticFiltersHost));
+}
+
+std::vector<std::unique_ptr<blink::URLLoaderThrottle>>
+LunetixContentBrowserClient::CreateURLLoaderThrottles(
+    const network::ResourceRequest& request,
+    content::BrowserContext* browser_context,
+    const base::RepeatingCallback<content::WebContents*()>& wc_getter,
+    content::NavigationUIData* navigation_ui_data,
+    int frame_tree_node_id) {
+  std::vector<std::unique_ptr<blink::URLLoaderThrottle>> throttles =
+      ChromeContentBrowserClient::CreateURLLoaderThrottles(
+          request, browser_context, wc_getter, navigation_ui_data,
+          frame_tree_node_id);
+  // Subresources of documents are matched by the renderer's own throttle.
+  LunetixAdBlockService* ad_block_service =
+      LunetixAdBlockService::GetInstance();
+  throttles.push_back(std::make_unique<LunetixURLLoaderThrottle>(
+      ad_block_service->GetMappedRuleset(),
+      ad_block_service->IsTrackerBlockingEnabled()));
+  return throttles;
+}
+
 }  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "lunetix/browser/net/lunetix_background_network_throttle.h"
+
+#include "base/bind.h"
+#include "chrome/browser/browser_process.h"
+#include "components/prefs/pref_service.h"
+#include "content/public/browser/devtools_agent_host.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/storage_partition.h"
+#include "content/public/browser/web_contents.h"
+#include "lunetix/browser/prefs/lunetix_pref_service.h"
+#include "services/network/public/mojom/network_context.mojom.h"
+
+namespace lunetix {
+
+namespace {
+
+// Leaves a hidden tab enough to finish small requests and keep sockets
+// alive, in bytes per second.
+constexpr double kBackgroundDownloadThroughput = 64 * 1024;
+constexpr double kBackgroundUploadThroughput = 32 * 1024;
+
+network::mojom::NetworkConditionsPtr CreateBackgroundConditions() {
+  auto conditions = network::mojom::NetworkConditions::New();
+  conditions->download_throughput = kBackgroundDownloadThroughput;
+  conditions->upload_throughput = kBackgroundUploadThroughput;
+  return conditions;
+}
+
+}  // namespace
+
+LunetixBackgroundNetworkThrottle::LunetixBackgroundNetworkThrottle(
+    content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents) {
+  pref_change_registrar_.Init(g_browser_process->local_state());
+  pref_change_registrar_.Add(
+      LunetixPrefService::kLunetixThrottleBackgroundTabs,
+      base::BindRepeating(&LunetixBackgroundNetworkThrottle::UpdateThrottling,
+                          base::Unretained(this)));
+  UpdateThrottling();
+}
+
+LunetixBackgroundNetworkThrottle::~LunetixBackgroundNetworkThrottle() =
+    default;
+
+void LunetixBackgroundNetworkThrottle::OnVisibilityChanged(
+    content::Visibility visibility) {
+  UpdateThrottling();
+}
+
+void LunetixBackgroundNetworkThrottle::OnAudioStateChanged(bool audible) {
+  UpdateThrottling();
+}
+
+void LunetixBackgroundNetworkThrottle::RenderFrameCreated(
+    content::RenderFrameHost* render_frame_host) {
+  if (is_throttled_)
+    ThrottleFrame(render_frame_host);
+}
+
+void LunetixBackgroundNetworkThrottle::FrameDeleted(int frame_tree_node_id) {
+  auto it = throttled_frames_.find(frame_tree_node_id);
+  if (it == throttled_frames_.end())
+    return;
+  
+  it->second.storage_partition->GetNetworkContext()->SetNetworkConditions(
+      it->second.devtools_token, nullptr);
+  throttled_frames_.erase(it);
+}
+
+void LunetixBackgroundNetworkThrottle::WebContentsDestroyed() {
+  UnthrottleAllFrames();
+  is_throttled_ = false;
+}
+
+bool LunetixBackgroundNetworkThrottle::ShouldThrottle() const {
+  if (!pref_change_registrar_.prefs()->GetBoolean(
+          LunetixPrefService::kLunetixThrottleBackgroundTabs)) {
+    return false;
+  }
+  
+  // Streaming media would stall, and the developer would see throttling
+  // they did not ask for.
+  return web_contents()->GetVisibility() == content::Visibility::HIDDEN &&
+         !web_contents()->IsCurrentlyAudible() &&
+         !content::DevToolsAgentHost::IsDebuggerAttached(web_contents());
+}
+
+void LunetixBackgroundNetworkThrottle::UpdateThrottling() {
+  bool should_throttle = ShouldThrottle();
+  if (should_throttle == is_throttled_)
+    return;
+  
+  is_throttled_ = should_throttle;
+  if (!is_throttled_) {
+    UnthrottleAllFrames();
+    return;
+  }
+  
+  for (content::RenderFrameHost* render_frame_host :
+       web_contents()->GetAllFrames()) {
+    ThrottleFrame(render_frame_host);
+  }
+}
+
+void LunetixBackgroundNetworkThrottle::ThrottleFrame(
+    content::RenderFrameHost* render_frame_host) {
+  int frame_tree_node_id = render_frame_host->GetFrameTreeNodeId();
+  if (throttled_frames_.count(frame_tree_node_id))
+    return;
+  
+  ThrottledFrame frame{render_frame_host->GetDevToolsFrameToken(),
+                       render_frame_host->GetStoragePartition()};
+  frame.storage_partition->GetNetworkContext()->SetNetworkConditions(
+      frame.devtools_token, CreateBackgroundConditions());
+  throttled_frames_.emplace(frame_tree_node_id, frame);
+}
+
+void LunetixBackgroundNetworkThrottle::UnthrottleAllFrames() {
+  for (const auto& entry : throttled_frames_) {
+    const ThrottledFrame& frame = entry.second;
+    frame.storage_partition->GetNetworkContext()->SetNetworkConditions(
+        frame.devtools_token, nullptr);
+  }
+  throttled_frames_.clear();
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(LunetixBackgroundNetworkThrottle);
+
+}  // namespace lunetix
\ No newline at end of file
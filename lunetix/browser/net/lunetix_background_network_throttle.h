@@ -0,0 +1,70 @@
+#ifndef LUNETIX_BROWSER_NET_LUNETIX_BACKGROUND_NETWORK_THROTTLE_H_
+#define LUNETIX_BROWSER_NET_LUNETIX_BACKGROUND_NETWORK_THROTTLE_H_
+
+#include <map>
+
+#include "base/unguessable_token.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+namespace content {
+class StoragePartition;
+}
+
+namespace lunetix {
+
+// Caps the throughput of a tab while it is hidden, which includes tabs the
+// memory optimizer suspended, so that on a constrained link the foreground
+// tab gets the bandwidth while it loads. Only active while the
+// kLunetixThrottleBackgroundTabs pref is set.
+//
+// The cap uses the network service's per-frame throttling, the same one the
+// DevTools network emulation drives, keyed by each frame's DevTools token.
+// It applies to requests that start after the tab was hidden. Tabs that play
+// audio or are being debugged are left alone.
+class LunetixBackgroundNetworkThrottle
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<LunetixBackgroundNetworkThrottle> {
+ public:
+  ~LunetixBackgroundNetworkThrottle() override;
+  
+  bool IsThrottled() const { return is_throttled_; }
+  
+  // WebContentsObserver overrides:
+  void OnVisibilityChanged(content::Visibility visibility) override;
+  void OnAudioStateChanged(bool audible) override;
+  void RenderFrameCreated(content::RenderFrameHost* render_frame_host) override;
+  void FrameDeleted(int frame_tree_node_id) override;
+  void WebContentsDestroyed() override;
+
+ private:
+  friend class content::WebContentsUserData<LunetixBackgroundNetworkThrottle>;
+  
+  explicit LunetixBackgroundNetworkThrottle(content::WebContents* web_contents);
+  
+  bool ShouldThrottle() const;
+  void UpdateThrottling();
+  void ThrottleFrame(content::RenderFrameHost* render_frame_host);
+  void UnthrottleAllFrames();
+  
+  PrefChangeRegistrar pref_change_registrar_;
+  
+  bool is_throttled_ = false;
+  
+  // The DevTools token belongs to the frame tree node, not to the document,
+  // so conditions are set once per node and survive its navigations.
+  struct ThrottledFrame {
+    base::UnguessableToken devtools_token;
+    content::StoragePartition* storage_partition;
+  };
+  std::map<int, ThrottledFrame> throttled_frames_;
+  
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixBackgroundNetworkThrottle);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_NET_LUNETIX_BACKGROUND_NETWORK_THROTTLE_H_
\ No newline at end of file
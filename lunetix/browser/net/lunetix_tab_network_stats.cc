@@ -0,0 +1,71 @@
+#include "lunetix/browser/net/lunetix_tab_network_stats.h"
+
+#include "net/base/load_timing_info.h"
+#include "net/base/net_errors.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom.h"
+
+namespace lunetix {
+
+namespace {
+
+void Add(std::atomic<int64_t>& counter, int64_t value) {
+  counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+int64_t Load(const std::atomic<int64_t>& counter) {
+  return counter.load(std::memory_order_relaxed);
+}
+
+}  // namespace
+
+LunetixTabNetworkStats::LunetixTabNetworkStats(
+    content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents) {}
+
+LunetixTabNetworkStats::~LunetixTabNetworkStats() = default;
+
+LunetixTabNetworkStats::Snapshot LunetixTabNetworkStats::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.received_bytes = Load(received_bytes_);
+  snapshot.request_count = Load(request_count_);
+  snapshot.failed_request_count = Load(failed_request_count_);
+  snapshot.cached_request_count = Load(cached_request_count_);
+  
+  // The sum and the count are read separately, so the average may be off by
+  // a sample that completes in between.
+  int64_t samples = Load(time_to_first_byte_samples_);
+  if (samples > 0) {
+    snapshot.average_time_to_first_byte =
+        base::Microseconds(Load(time_to_first_byte_us_) / samples);
+  }
+  return snapshot;
+}
+
+void LunetixTabNetworkStats::ResourceLoadComplete(
+    content::RenderFrameHost* render_frame_host,
+    const content::GlobalRequestID& request_id,
+    const blink::mojom::ResourceLoadInfo& resource_load_info) {
+  Add(request_count_, 1);
+  Add(received_bytes_, resource_load_info.total_received_bytes);
+  
+  if (resource_load_info.net_error != net::OK) {
+    Add(failed_request_count_, 1);
+    return;
+  }
+  if (resource_load_info.was_cached) {
+    Add(cached_request_count_, 1);
+    return;
+  }
+  
+  const net::LoadTimingInfo& timing = resource_load_info.load_timing_info;
+  if (timing.send_start.is_null() || timing.receive_headers_start.is_null())
+    return;
+  base::TimeDelta time_to_first_byte =
+      timing.receive_headers_start - timing.send_start;
+  Add(time_to_first_byte_us_, time_to_first_byte.InMicroseconds());
+  Add(time_to_first_byte_samples_, 1);
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(LunetixTabNetworkStats);
+
+}  // namespace lunetix
\ No newline at end of file
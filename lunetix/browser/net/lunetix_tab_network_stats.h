@@ -0,0 +1,63 @@
+#ifndef LUNETIX_BROWSER_NET_LUNETIX_TAB_NETWORK_STATS_H_
+#define LUNETIX_BROWSER_NET_LUNETIX_TAB_NETWORK_STATS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "base/time/time.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+
+namespace lunetix {
+
+// Network usage of one tab, counted from the resource loads its frames
+// report once they complete. The counters are relaxed atomics: they are only
+// ever added to, so readers such as the task manager can sample them from
+// any thread without taking a lock or posting to the UI thread.
+class LunetixTabNetworkStats
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<LunetixTabNetworkStats> {
+ public:
+  struct Snapshot {
+    // Bytes read from the network, headers included. Cache hits add nothing.
+    int64_t received_bytes = 0;
+    int64_t request_count = 0;
+    int64_t failed_request_count = 0;
+    int64_t cached_request_count = 0;
+    // Average time from sending a request to the first response byte, over
+    // the requests that went to the network.
+    base::TimeDelta average_time_to_first_byte;
+  };
+  
+  ~LunetixTabNetworkStats() override;
+  
+  Snapshot GetSnapshot() const;
+  
+  // WebContentsObserver overrides:
+  void ResourceLoadComplete(
+      content::RenderFrameHost* render_frame_host,
+      const content::GlobalRequestID& request_id,
+      const blink::mojom::ResourceLoadInfo& resource_load_info) override;
+
+ private:
+  friend class content::WebContentsUserData<LunetixTabNetworkStats>;
+  
+  explicit LunetixTabNetworkStats(content::WebContents* web_contents);
+  
+  std::atomic<int64_t> received_bytes_{0};
+  std::atomic<int64_t> request_count_{0};
+  std::atomic<int64_t> failed_request_count_{0};
+  std::atomic<int64_t> cached_request_count_{0};
+  // Sum and number of the samples behind the average time to first byte.
+  std::atomic<int64_t> time_to_first_byte_us_{0};
+  std::atomic<int64_t> time_to_first_byte_samples_{0};
+  
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixTabNetworkStats);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_NET_LUNETIX_TAB_NETWORK_STATS_H_
\ No newline at end of file
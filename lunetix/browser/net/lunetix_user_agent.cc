@@ -0,0 +1,80 @@
+#include "lunetix/browser/net/lunetix_user_agent.h"
+
+#include "base/bind.h"
+#include "base/strings/strcat.h"
+#include "base/strings/string_util.h"
+#include "components/embedder_support/user_agent_utils.h"
+#include "components/prefs/pref_service.h"
+#include "components/version_info/version_info.h"
+#include "content/public/common/user_agent.h"
+#include "lunetix/browser/prefs/lunetix_pref_service.h"
+#include "lunetix/common/lunetix_constants.h"
+#include "net/http/http_util.h"
+
+namespace lunetix {
+
+namespace {
+
+std::string BuildDefaultUserAgent() {
+  return content::BuildUserAgentFromProduct(base::StrCat(
+      {kLunetixProductName, "/", version_info::GetVersionNumber()}));
+}
+
+blink::UserAgentMetadata BuildUserAgentMetadata() {
+  blink::UserAgentMetadata metadata = embedder_support::GetUserAgentMetadata();
+  metadata.brand_version_list.emplace_back(
+      kLunetixProductName, version_info::GetMajorVersionNumber());
+  return metadata;
+}
+
+}  // namespace
+
+// static
+LunetixUserAgent* LunetixUserAgent::GetInstance() {
+  static base::NoDestructor<LunetixUserAgent> instance;
+  return instance.get();
+}
+
+LunetixUserAgent::LunetixUserAgent()
+    : default_user_agent_(BuildDefaultUserAgent()),
+      metadata_(BuildUserAgentMetadata()),
+      user_agent_(default_user_agent_) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+LunetixUserAgent::~LunetixUserAgent() = default;
+
+void LunetixUserAgent::Start(PrefService* local_state) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  pref_change_registrar_.Init(local_state);
+  pref_change_registrar_.Add(
+      LunetixPrefService::kLunetixCustomUserAgent,
+      base::BindRepeating(&LunetixUserAgent::OnCustomUserAgentChanged,
+                          base::Unretained(this)));
+  OnCustomUserAgentChanged();
+}
+
+std::string LunetixUserAgent::GetUserAgent() const {
+  base::AutoLock lock(lock_);
+  return user_agent_;
+}
+
+blink::UserAgentMetadata LunetixUserAgent::GetUserAgentMetadata() const {
+  return metadata_;
+}
+
+void LunetixUserAgent::OnCustomUserAgentChanged() {
+  std::string custom_user_agent(base::TrimWhitespaceASCII(
+      pref_change_registrar_.prefs()->GetString(
+          LunetixPrefService::kLunetixCustomUserAgent),
+      base::TRIM_ALL));
+  
+  // A value that is not a valid header would fail every request.
+  bool use_custom = !custom_user_agent.empty() &&
+                    net::HttpUtil::IsValidHeaderValue(custom_user_agent);
+  
+  base::AutoLock lock(lock_);
+  user_agent_ = use_custom ? custom_user_agent : default_user_agent_;
+}
+
+}  // namespace lunetix
\ No newline at end of file
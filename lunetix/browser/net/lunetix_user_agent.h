@@ -0,0 +1,59 @@
+#ifndef LUNETIX_BROWSER_NET_LUNETIX_USER_AGENT_H_
+#define LUNETIX_BROWSER_NET_LUNETIX_USER_AGENT_H_
+
+#include <string>
+
+#include "base/no_destructor.h"
+#include "base/sequence_checker.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "third_party/blink/public/common/user_agent/user_agent_metadata.h"
+
+class PrefService;
+
+namespace lunetix {
+
+// The User-Agent and User-Agent Client Hints Lunetix sends. Both are built
+// once, and again only when the custom User-Agent pref changes, so the
+// content client hands out a ready string instead of every request
+// rewriting its header. Network contexts and renderers pick the values up
+// when they are created.
+class LunetixUserAgent {
+ public:
+  static LunetixUserAgent* GetInstance();
+
+  // Follows the custom User-Agent pref of |local_state|. Until then the
+  // branded default is used.
+  void Start(PrefService* local_state);
+
+  // Safe to call from any thread.
+  std::string GetUserAgent() const;
+  blink::UserAgentMetadata GetUserAgentMetadata() const;
+
+ private:
+  friend class base::NoDestructor<LunetixUserAgent>;
+
+  LunetixUserAgent();
+  ~LunetixUserAgent();
+
+  void OnCustomUserAgentChanged();
+
+  // "Mozilla/5.0 (...) ... Lunetix/<version> Safari/537.36".
+  const std::string default_user_agent_;
+  // Brands Lunetix next to Chromium.
+  const blink::UserAgentMetadata metadata_;
+
+  PrefChangeRegistrar pref_change_registrar_;
+
+  mutable base::Lock lock_;
+  std::string user_agent_ GUARDED_BY(lock_);
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(LunetixUserAgent);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_NET_LUNETIX_USER_AGENT_H_
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/containers/cxx20_erase.h"
+#include "base/files/file_util.h"
+#include "base/pickle.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "chrome/browser/predictors/resolve_host_client_impl.h"
+#include "content/public/browser/browser_context.h"
+#include "content/public/browser/navigation_handle.h"
+#include "content/public/browser/storage_partition.h"
+#include "content/public/browser/web_contents.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor_factory.h"
+#include "net/base/network_isolation_key.h"
+#include "net/base/schemeful_site.h"
+#include "services/network/public/mojom/network_context.mojom.h"
+#include "third_party/blink/public/mojom/loader/resource_load_info.mojom.h"
+
+namespace lunetix {
+
+namespace {
+
+constexpr int kTableVersion = 1;
+
+// Saving is batched; the table changes on every page load.
+constexpr base::TimeDelta kSaveDelay = base::Seconds(30);
+
+constexpr size_t kMaxHosts = 400;
+constexpr size_t kMaxOriginsPerHost = 16;
+constexpr size_t kMaxOriginsPerPage = 64;
+
+// Counts are halved when a host reaches this many page loads, which keeps
+// the ratios but lets origins a site stopped using fade out.
+constexpr uint16_t kMaxPageLoads = 32;
+constexpr uint16_t kMinPageLoads = 2;
+
+constexpr size_t kMaxPredictedOrigins = 4;
+// Share of page loads that needed an origin before it is preconnected, or
+// only resolved.
+constexpr double kPreconnectConfidence = 0.6;
+constexpr double kPreresolveConfidence = 0.25;
+
+constexpr base::TimeDelta kHintInterval = base::Seconds(5);
+constexpr size_t kMaxPendingPreresolves = 8;
+
+std::unique_ptr<std::string> ReadTable(const base::FilePath& path) {
+  auto data = std::make_unique<std::string>();
+  if (!base::ReadFileToString(path, data.get())) {
+    return nullptr;
+  }
+  return data;
+}
+
+bool ReadOrigin(base::PickleIterator* iterator, url::Origin* origin) {
+  std::string serialized;
+  if (!iterator->ReadString(&serialized)) {
+    return false;
+  }
+  GURL url(serialized);
+  if (!url.SchemeIsHTTPOrHTTPS()) {
+    return false;
+  }
+  *origin = url::Origin::Create(url);
+  return true;
+}
+
+}  // namespace
+
+LunetixPreconnectPredictor::HostStats::HostStats() = default;
+
+LunetixPreconnectPredictor::HostStats::HostStats(HostStats&& other) = default;
+
+LunetixPreconnectPredictor::HostStats&
+LunetixPreconnectPredictor::HostStats::operator=(HostStats&& other) = default;
+
+LunetixPreconnectPredictor::HostStats::~HostStats() = default;
+
+LunetixPreconnectPredictor::LunetixPreconnectPredictor(
+    content::BrowserContext* context,
+    const base::FilePath& path)
+    : context_(context),
+      writer_(path,
+              base::ThreadPool::CreateSequencedTaskRunner(
+                  {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+                   base::TaskShutdownBehavior::BLOCK_SHUTDOWN}),
+              kSaveDelay),
+      hosts_(kMaxHosts) {
+  writer_.task_runner()->PostTaskAndReplyWithResult(
+      FROM_HERE, base::BindOnce(&ReadTable, path),
+      base::BindOnce(&LunetixPreconnectPredictor::OnTableRead,
+                     weak_factory_.GetWeakPtr()));
+}
+
+LunetixPreconnectPredictor::~LunetixPreconnectPredictor() = default;
+
+void LunetixPreconnectPredictor::LearnFromPageLoad(
+    const url::Origin& host,
+    const base::flat_set<url::Origin>& origins) {
+  if (!table_loaded_) {
+    return;
+  }
+  
+  auto it = hosts_.Get(host);
+  if (it == hosts_.end()) {
+    it = hosts_.Put(host, HostStats());
+  }
+  HostStats& stats = it->second;
+  
+  if (stats.page_loads == kMaxPageLoads) {
+    stats.page_loads /= 2;
+    for (OriginStat& stat : stats.origins) {
+      stat.hits /= 2;
+    }
+    base::EraseIf(stats.origins,
+                  [](const OriginStat& stat) { return stat.hits == 0; });
+  }
+  ++stats.page_loads;
+  
+  size_t known_origins = stats.origins.size();
+  for (size_t i = 0; i < known_origins; ++i) {
+    if (origins.contains(stats.origins[i].origin)) {
+      ++stats.origins[i].hits;
+    }
+  }
+  for (const url::Origin& origin : origins) {
+    auto known = std::find_if(
+        stats.origins.begin(), stats.origins.begin() + known_origins,
+        [&origin](const OriginStat& stat) { return stat.origin == origin; });
+    if (known == stats.origins.begin() + known_origins) {
+      stats.origins.push_back({origin, 1});
+    }
+  }
+  
+  // New origins sort behind known ones with the same count, so a full list
+  // only takes them in once a known origin has faded out.
+  std::stable_sort(stats.origins.begin(), stats.origins.end(),
+                   [](const OriginStat& a, const OriginStat& b) {
+                     return a.hits > b.hits;
+                   });
+  if (stats.origins.size() > kMaxOriginsPerHost) {
+    stats.origins.resize(kMaxOriginsPerHost);
+  }
+  
+  writer_.ScheduleWrite(this);
+}
+
+LunetixPreconnectPredictor::Prediction LunetixPreconnectPredictor::Predict(
+    const url::Origin& host) const {
+  Prediction prediction;
+  auto it = hosts_.Peek(host);
+  if (it == hosts_.end() || it->second.page_loads < kMinPageLoads) {
+    return prediction;
+  }
+  
+  const HostStats& stats = it->second;
+  size_t count = std::min(stats.origins.size(), kMaxPredictedOrigins);
+  for (size_t i = 0; i < count; ++i) {
+    const OriginStat& stat = stats.origins[i];
+    double confidence = static_cast<double>(stat.hits) / stats.page_loads;
+    if (confidence >= kPreconnectConfidence) {
+      prediction.preconnect_origins.push_back(stat.origin);
+    } else if (confidence >= kPreresolveConfidence) {
+      prediction.preresolve_origins.push_back(stat.origin);
+    } else {
+      break;
+    }
+  }
+  return prediction;
+}
+
+void LunetixPreconnectPredictor::OnNavigationHint(const GURL& url) {
+  if (!url.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+  
+  url::Origin host = url::Origin::Create(url);
+  base::TimeTicks now = base::TimeTicks::Now();
+  if (host == last_hint_host_ && now - last_hint_time_ < kHintInterval) {
+    return;
+  }
+  last_hint_host_ = host;
+  last_hint_time_ = now;
+  
+  // Subresources of a top-level page share its site's network partition.
+  net::SchemefulSite site(host);
+  net::NetworkIsolationKey network_isolation_key(site, site);
+  
+  Preconnect(host, network_isolation_key);
+  Prediction prediction = Predict(host);
+  for (const url::Origin& origin : prediction.preconnect_origins) {
+    Preconnect(origin, network_isolation_key);
+  }
+  for (const url::Origin& origin : prediction.preresolve_origins) {
+    Preresolve(origin, network_isolation_key);
+  }
+}
+
+void LunetixPreconnectPredictor::Shutdown() {
+  if (writer_.HasPendingWrite()) {
+    writer_.DoScheduledWrite();
+  }
+  weak_factory_.InvalidateWeakPtrs();
+  preresolves_.clear();
+}
+
+bool LunetixPreconnectPredictor::SerializeData(std::string* data) {
+  base::Pickle pickle;
+  pickle.WriteInt(kTableVersion);
+  pickle.WriteInt(static_cast<int>(hosts_.size()));
+  // Least recently used first, so reading the file back restores the
+  // eviction order.
+  for (auto it = hosts_.rbegin(); it != hosts_.rend(); ++it) {
+    const HostStats& stats = it->second;
+    pickle.WriteString(it->first.Serialize());
+    pickle.WriteUInt16(stats.page_loads);
+    pickle.WriteInt(static_cast<int>(stats.origins.size()));
+    for (const OriginStat& stat : stats.origins) {
+      pickle.WriteString(stat.origin.Serialize());
+      pickle.WriteUInt16(stat.hits);
+    }
+  }
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
+
+void LunetixPreconnectPredictor::OnTableRead(
+    std::unique_ptr<std::string> data) {
+  table_loaded_ = true;
+  if (!data) {
+    return;
+  }
+  
+  // A table that fails to parse is dropped as a whole and relearned.
+  base::Pickle pickle(data->data(), data->size());
+  base::PickleIterator iterator(pickle);
+  int version = 0;
+  int host_count = 0;
+  if (!iterator.ReadInt(&version) || version != kTableVersion ||
+      !iterator.ReadInt(&host_count) || host_count < 0) {
+    return;
+  }
+  
+  base::MRUCache<url::Origin, HostStats> hosts(kMaxHosts);
+  for (int i = 0; i < host_count; ++i) {
+    url::Origin host;
+    HostStats stats;
+    int origin_count = 0;
+    if (!ReadOrigin(&iterator, &host) ||
+        !iterator.ReadUInt16(&stats.page_loads) ||
+        !iterator.ReadInt(&origin_count) || origin_count < 0 ||
+        static_cast<size_t>(origin_count) > kMaxOriginsPerHost) {
+      return;
+    }
+    for (int j = 0; j < origin_count; ++j) {
+      OriginStat stat;
+      if (!ReadOrigin(&iterator, &stat.origin) ||
+          !iterator.ReadUInt16(&stat.hits)) {
+        return;
+      }
+      stats.origins.push_back(std::move(stat));
+    }
+    hosts.Put(std::move(host), std::move(stats));
+  }
+  hosts_.Swap(hosts);
+}
+
+void LunetixPreconnectPredictor::Preconnect(
+    const url::Origin& origin,
+    const net::NetworkIsolationKey& network_isolation_key) {
+  network::mojom::NetworkContext* network_context =
+      context_->GetDefaultStoragePartition()->GetNetworkContext();
+  network_context->PreconnectSockets(1, origin.GetURL(),
+                                     /*allow_credentials=*/true,
+                                     network_isolation_key);
+}
+
+void LunetixPreconnectPredictor::Preresolve(
+    const url::Origin& origin,
+    const net::NetworkIsolationKey& network_isolation_key) {
+  if (preresolves_.size() >= kMaxPendingPreresolves) {
+    return;
+  }
+  
+  int request_id = next_preresolve_id_++;
+  preresolves_[request_id] =
+      std::make_unique<predictors::ResolveHostClientImpl>(
+          origin.GetURL(), network_isolation_key,
+          base::BindOnce(&LunetixPreconnectPredictor::OnPreresolveDone,
+                         weak_factory_.GetWeakPtr(), request_id),
+          context_->GetDefaultStoragePartition()->GetNetworkContext());
+}
+
+void LunetixPreconnectPredictor::OnPreresolveDone(int request_id,
+                                                  bool success) {
+  auto it = preresolves_.find(request_id);
+  if (it == preresolves_.end()) {
+    return;
+  }
+  
+  // The client is still running the callback.
+  base::SequencedTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE,
+                                                     std::move(it->second));
+  preresolves_.erase(it);
+}
+
+// LunetixPreconnectObserver implementation
+
+LunetixPreconnectObserver::LunetixPreconnectObserver(
+    content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents) {}
+
+LunetixPreconnectObserver::~LunetixPreconnectObserver() = default;
+
+void LunetixPreconnectObserver::DidFinishNavigation(
+    content::NavigationHandle* navigation_handle) {
+  if (!navigation_handle->IsInMainFrame() ||
+      !navigation_handle->HasCommitted() ||
+      navigation_handle->IsSameDocument()) {
+    return;
+  }
+  
+  FlushPageLoad();
+  const GURL& url = navigation_handle->GetURL();
+  page_origin_ =
+      url.SchemeIsHTTPOrHTTPS() ? url::Origin::Create(url) : url::Origin();
+}
+
+void LunetixPreconnectObserver::ResourceLoadComplete(
+    content::RenderFrameHost* render_frame_host,
+    const content::GlobalRequestID& request_id,
+    const blink::mojom::ResourceLoadInfo& resource_load_info) {
+  // Cache hits needed no connection.
+  if (page_origin_.opaque() || resource_load_info.was_cached ||
+      !resource_load_info.final_url.SchemeIsHTTPOrHTTPS() ||
+      page_subresource_origins_.size() >= kMaxOriginsPerPage) {
+    return;
+  }
+  
+  url::Origin origin = url::Origin::Create(resource_load_info.final_url);
+  if (origin != page_origin_) {
+    page_subresource_origins_.insert(std::move(origin));
+  }
+}
+
+void LunetixPreconnectObserver::WebContentsDestroyed() {
+  FlushPageLoad();
+}
+
+void LunetixPreconnectObserver::FlushPageLoad() {
+  if (!page_origin_.opaque()) {
+    // Off-the-record profiles have no predictor and learn nothing.
+    LunetixPreconnectPredictor* predictor =
+        LunetixPreconnectPredictorFactory::GetForBrowserContext(
+            web_contents()->GetBrowserContext());
+    if (predictor) {
+      predictor->LearnFromPageLoad(page_origin_, page_subresource_origins_);
+    }
+  }
+  page_origin_ = url::Origin();
+  page_subresource_origins_.clear();
+}
+
+WEB_CONTENTS_USER_DATA_KEY_IMPL(LunetixPreconnectObserver);
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,154 @@
+#ifndef LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_H_
+#define LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/flat_set.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/important_file_writer.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace content {
+class BrowserContext;
+}
+
+namespace net {
+class NetworkIsolationKey;
+}
+
+namespace predictors {
+class ResolveHostClientImpl;
+}
+
+namespace lunetix {
+
+// Learns which origins the pages of each top-level origin load
+// subresources from, and warms up connections to them before a navigation
+// starts: when the user types an address or hovers a link, the origins a
+// page on the target usually needs are preconnected, or only resolved when
+// they are needed less often.
+//
+// The table is capped in hosts and in origins per host, evicting the least
+// recently used host, and is saved to a small binary file in the profile.
+class LunetixPreconnectPredictor
+    : public KeyedService,
+      public base::ImportantFileWriter::DataSerializer {
+ public:
+  // An origin the pages of a host needed, and on how many page loads.
+  struct OriginStat {
+    url::Origin origin;
+    uint16_t hits = 0;
+  };
+  
+  struct HostStats {
+    HostStats();
+    HostStats(HostStats&& other);
+    HostStats& operator=(HostStats&& other);
+    ~HostStats();
+  
+    uint16_t page_loads = 0;
+    std::vector<OriginStat> origins;
+  };
+  
+  struct Prediction {
+    std::vector<url::Origin> preconnect_origins;
+    std::vector<url::Origin> preresolve_origins;
+  };
+  
+  LunetixPreconnectPredictor(content::BrowserContext* context,
+                             const base::FilePath& path);
+  ~LunetixPreconnectPredictor() override;
+  
+  // Records that a page on |host| loaded subresources from |origins|.
+  void LearnFromPageLoad(const url::Origin& host,
+                         const base::flat_set<url::Origin>& origins);
+  
+  // The origins worth warming up for a navigation to |host|, best first.
+  Prediction Predict(const url::Origin& host) const;
+  
+  // A navigation to |url| is likely: connects to it and to the predicted
+  // origins of its host. Repeated hints for the same host are ignored for a
+  // few seconds, so hovering over a list of links stays cheap.
+  void OnNavigationHint(const GURL& url);
+  
+  // KeyedService overrides:
+  void Shutdown() override;
+  
+  // base::ImportantFileWriter::DataSerializer overrides:
+  bool SerializeData(std::string* data) override;
+
+ private:
+  void OnTableRead(std::unique_ptr<std::string> data);
+  void Preconnect(const url::Origin& origin,
+                  const net::NetworkIsolationKey& network_isolation_key);
+  void Preresolve(const url::Origin& origin,
+                  const net::NetworkIsolationKey& network_isolation_key);
+  void OnPreresolveDone(int request_id, bool success);
+  
+  content::BrowserContext* const context_;
+  base::ImportantFileWriter writer_;
+  
+  // Learning starts once the saved table is read, so it cannot be
+  // overwritten by a partial one.
+  bool table_loaded_ = false;
+  base::MRUCache<url::Origin, HostStats> hosts_;
+  
+  url::Origin last_hint_host_;
+  base::TimeTicks last_hint_time_;
+  
+  int next_preresolve_id_ = 0;
+  std::map<int, std::unique_ptr<predictors::ResolveHostClientImpl>>
+      preresolves_;
+  
+  base::WeakPtrFactory<LunetixPreconnectPredictor> weak_factory_{this};
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixPreconnectPredictor);
+};
+
+// Collects the subresource origins of the page shown in a tab and hands
+// them to the predictor of its profile when the page is left.
+class LunetixPreconnectObserver
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<LunetixPreconnectObserver> {
+ public:
+  ~LunetixPreconnectObserver() override;
+  
+  // WebContentsObserver overrides:
+  void DidFinishNavigation(
+      content::NavigationHandle* navigation_handle) override;
+  void ResourceLoadComplete(
+      content::RenderFrameHost* render_frame_host,
+      const content::GlobalRequestID& request_id,
+      const blink::mojom::ResourceLoadInfo& resource_load_info) override;
+  void WebContentsDestroyed() override;
+
+ private:
+  friend class content::WebContentsUserData<LunetixPreconnectObserver>;
+  
+  explicit LunetixPreconnectObserver(content::WebContents* web_contents);
+  
+  void FlushPageLoad();
+  
+  // Origin of the committed page, opaque if it is not an HTTP(S) page.
+  url::Origin page_origin_;
+  base::flat_set<url::Origin> page_subresource_origins_;
+  
+  WEB_CONTENTS_USER_DATA_KEY_DECL();
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixPreconnectObserver);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_H_
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor_factory.h"
+
+#include "base/memory/singleton.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "content/public/browser/browser_context.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor.h"
+
+namespace lunetix {
+
+namespace {
+
+const base::FilePath::CharType kPredictorFilename[] =
+    FILE_PATH_LITERAL("Lunetix Preconnect Predictor");
+
+}  // namespace
+
+// static
+LunetixPreconnectPredictor*
+LunetixPreconnectPredictorFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<LunetixPreconnectPredictor*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+LunetixPreconnectPredictorFactory*
+LunetixPreconnectPredictorFactory::GetInstance() {
+  return base::Singleton<LunetixPreconnectPredictorFactory>::get();
+}
+
+LunetixPreconnectPredictorFactory::LunetixPreconnectPredictorFactory()
+    : BrowserContextKeyedServiceFactory(
+          "LunetixPreconnectPredictor",
+          BrowserContextDependencyManager::GetInstance()) {}
+
+LunetixPreconnectPredictorFactory::~LunetixPreconnectPredictorFactory() =
+    default;
+
+KeyedService* LunetixPreconnectPredictorFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new LunetixPreconnectPredictor(
+      context, context->GetPath().Append(kPredictorFilename));
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_FACTORY_H_
+#define LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_FACTORY_H_
+
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}
+
+namespace content {
+class BrowserContext;
+}
+
+namespace lunetix {
+
+class LunetixPreconnectPredictor;
+
+// Off-the-record profiles get no predictor, so their browsing is neither
+// learned nor persisted.
+class LunetixPreconnectPredictorFactory
+    : public BrowserContextKeyedServiceFactory {
+ public:
+  static LunetixPreconnectPredictor* GetForBrowserContext(
+      content::BrowserContext* context);
+  static LunetixPreconnectPredictorFactory* GetInstance();
+  
+ private:
+  friend struct base::DefaultSingletonTraits<
+      LunetixPreconnectPredictorFactory>;
+  
+  LunetixPreconnectPredictorFactory();
+  ~LunetixPreconnectPredictorFactory() override;
+  
+  // BrowserContextKeyedServiceFactory overrides:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixPreconnectPredictorFactory);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_PREDICTORS_LUNETIX_PRECONNECT_PREDICTOR_FACTORY_H_
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "lunetix/browser/prefs/lunetix_pref_service.h"
+
+#include "base/files/file_path.h"
+#include "base/values.h"
+#include "components/prefs/pref_registry_simple.h"
+#include "lunetix/common/lunetix_constants.h"
+
+namespace lunetix {
+
+const char LunetixPrefService::kLunetixHomePage[] = "lunetix.home_page";
+const char LunetixPrefService::kLunetixShowHomeButton[] =
+    "lunetix.show_home_button";
+const char LunetixPrefService::kLunetixBlockTrackers[] =
+    "lunetix.block_trackers";
+const char LunetixPrefService::kLunetixEnableAdBlock[] =
+    "lunetix.enable_ad_block";
+const char LunetixPrefService::kLunetixPrivacyMode[] = "lunetix.privacy_mode";
+const char LunetixPrefService::kLunetixUpdateChannel[] =
+    "lunetix.update_channel";
+const char LunetixPrefService::kLunetixTelemetryEnabled[] =
+    "lunetix.telemetry_enabled";
+const char LunetixPrefService::kLunetixCustomUserAgent[] =
+    "lunetix.custom_user_agent";
+const char LunetixPrefService::kLunetixSearchEngine[] =
+    "lunetix.search_engine";
+const char LunetixPrefService::kLunetixDownloadDirectory[] =
+    "lunetix.download_directory";
+const char LunetixPrefService::kLunetixStartupAction[] =
+    "lunetix.startup_action";
+const char LunetixPrefService::kLunetixNewTabPage[] = "lunetix.new_tab_page";
+const char LunetixPrefService::kLunetixTheme[] = "lunetix.theme";
+const char LunetixPrefService::kLunetixLanguage[] = "lunetix.language";
+const char LunetixPrefService::kLunetixProxySettings[] =
+    "lunetix.proxy_settings";
+const char LunetixPrefService::kLunetixSecurityLevel[] =
+    "lunetix.security_level";
+const char LunetixPrefService::kLunetixThrottleBackgroundTabs[] =
+    "lunetix.throttle_background_tabs";
+
+// static
+void LunetixPrefService::RegisterLunetixPrefs(PrefRegistrySimple* registry) {
+  registry->RegisterStringPref(kLunetixHomePage, kLunetixHomepageURL);
+  registry->RegisterBooleanPref(kLunetixShowHomeButton, true);
+  registry->RegisterBooleanPref(kLunetixBlockTrackers, true);
+  registry->RegisterBooleanPref(kLunetixEnableAdBlock, true);
+  registry->RegisterBooleanPref(kLunetixPrivacyMode, false);
+  registry->RegisterStringPref(kLunetixUpdateChannel, "stable");
+  registry->RegisterBooleanPref(kLunetixTelemetryEnabled, false);
+  registry->RegisterStringPref(kLunetixCustomUserAgent, std::string());
+  registry->RegisterStringPref(kLunetixSearchEngine, "google");
+  registry->RegisterFilePathPref(kLunetixDownloadDirectory, base::FilePath());
+  registry->RegisterIntegerPref(kLunetixStartupAction, 0);
+  registry->RegisterStringPref(kLunetixNewTabPage, "lunetix://newtab");
+  registry->RegisterStringPref(kLunetixTheme, "system");
+  registry->RegisterStringPref(kLunetixLanguage, std::string());
+  registry->RegisterDictionaryPref(kLunetixProxySettings);
+  registry->RegisterIntegerPref(kLunetixSecurityLevel, 1);
+  registry->RegisterBooleanPref(kLunetixThrottleBackgroundTabs, false);
+}
+
+// static
+void LunetixPrefService::SetLunetixDefaults(PrefService* prefs) {
+  // Clearing a user value falls back to the registered default.
+  for (const char* pref :
+       {kLunetixHomePage, kLunetixShowHomeButton, kLunetixBlockTrackers,
+        kLunetixEnableAdBlock, kLunetixPrivacyMode, kLunetixUpdateChannel,
+        kLunetixTelemetryEnabled, kLunetixCustomUserAgent,
+        kLunetixSearchEngine, kLunetixDownloadDirectory,
+        kLunetixStartupAction, kLunetixNewTabPage, kLunetixTheme,
+        kLunetixLanguage, kLunetixProxySettings, kLunetixSecurityLevel,
+        kLunetixThrottleBackgroundTabs}) {
+    prefs->ClearPref(pref);
+  }
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include "components/prefs/pref_service.h"
 
+class PrefRegistrySimple;
+
 namespace lunetix {
 
 class LunetixPrefService {
@@ -27,6 +29,7 @@ class LunetixPrefService {
   static const char kLunetixLanguage[];
   static const char kLunetixProxySettings[];
   static const char kLunetixSecurityLevel[];
+  static const char kLunetixThrottleBackgroundTabs[];
 
  private:
   LunetixPrefService() = delete;
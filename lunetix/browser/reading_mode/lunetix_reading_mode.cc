@@ -1,20 +1,133 @@
 #include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
 
+#include <algorithm>
+
+#include "base/base64.h"
+#include "base/json/string_escape.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "content/public/browser/navigation_controller.h"
 #include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/service_process_host.h"
 #include "content/public/browser/web_contents.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache_factory.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_speech.h"
+#include "mojo/public/cpp/bindings/callback_helpers.h"
+#include "ui/base/page_transition_types.h"
+#include "url/origin.h"
 
 namespace lunetix {
 
+namespace {
+
+// The extractor process is torn down after this much idle time.
+constexpr base::TimeDelta kExtractorIdleTimeout = base::Seconds(30);
+
+// Cached articles older than this are shown, then refreshed from the live
+// page in the background.
+constexpr base::TimeDelta kCacheRevalidateAge = base::Hours(24);
+
+// Chunks rendered together with the article shell, and the number of
+// chunks pushed per task afterwards.
+constexpr size_t kInitialChunkCount = 3;
+constexpr size_t kChunkBatchSize = 8;
+
+// Pages scoring below this are not offered reading mode.
+constexpr float kReadableScoreThreshold = 0.5f;
+
+// Counts at which the length signals saturate.
+constexpr float kSaturatingParagraphCount = 10.0f;
+constexpr float kSaturatingWordCount = 1000.0f;
+
+}  // namespace
+
+// Watches the reader contents so the article is only pushed into the
+// template once it has finished loading.
+class LunetixReadingMode::ReaderContentsObserver
+    : public content::WebContentsObserver {
+ public:
+  ReaderContentsObserver(content::WebContents* reader_contents,
+                         LunetixReadingMode* owner)
+      : content::WebContentsObserver(reader_contents), owner_(owner) {}
+  ~ReaderContentsObserver() override = default;
+  
+  // WebContentsObserver overrides:
+  void DocumentOnLoadCompletedInMainFrame() override {
+    owner_->OnReaderDocumentReady();
+  }
+
+ private:
+  LunetixReadingMode* owner_;
+  
+  DISALLOW_COPY_AND_ASSIGN(ReaderContentsObserver);
+};
+
 // LunetixReadingMode implementation
 
 LunetixReadingMode::LunetixReadingMode(content::WebContents* web_contents)
-    : content::WebContentsObserver(web_contents) {}
+    : content::WebContentsObserver(web_contents),
+      readability_receivers_(web_contents, this) {}
 
 LunetixReadingMode::~LunetixReadingMode() = default;
 
+// static
+void LunetixReadingMode::BindReadabilityHost(
+    content::RenderFrameHost* render_frame_host,
+    mojo::PendingReceiver<mojom::ReadabilityHost> receiver) {
+  content::WebContents* web_contents =
+      content::WebContents::FromRenderFrameHost(render_frame_host);
+  if (!web_contents || render_frame_host != web_contents->GetMainFrame()) {
+    return;
+  }
+  
+  LunetixReadingMode::CreateForWebContents(web_contents);
+  LunetixReadingMode::FromWebContents(web_contents)
+      ->readability_receivers_.Bind(render_frame_host, std::move(receiver));
+}
+
+// static
+GURL LunetixReadingMode::GetCanonicalUrl(const GURL& page_url,
+                                         const std::string& canonical_href) {
+  // Any page can name any URL as canonical. Only same-origin ones are
+  // trusted, so a page cannot plant its article under another site's URL.
+  GURL canonical_url(canonical_href);
+  if (!canonical_url.SchemeIsHTTPOrHTTPS() ||
+      !url::Origin::Create(canonical_url)
+           .IsSameOriginWith(url::Origin::Create(page_url))) {
+    return GURL();
+  }
+  return canonical_url;
+}
+
+// static
+float LunetixReadingMode::ComputeReadabilityScore(
+    const mojom::ReadabilitySignals& signals) {
+  // Body text carries most of the weight, discounted by how much of it is
+  // links. Markup only nudges the score, since index pages often use
+  // <article> for every teaser. A link density that is not a number counts
+  // as all links.
+  float paragraphs =
+      std::min(signals.paragraph_count / kSaturatingParagraphCount, 1.0f);
+  float words = std::min(signals.word_count / kSaturatingWordCount, 1.0f);
+  float link_penalty =
+      1.0f - std::max(0.0f, std::min(1.0f, signals.link_density));
+  
+  float score = (0.4f * paragraphs + 0.3f * words) * link_penalty;
+  if (signals.has_article_element) {
+    score += 0.1f;
+  }
+  if (signals.has_article_schema) {
+    score += 0.15f;
+  }
+  if (signals.has_open_graph_article) {
+    score += 0.1f;
+  }
+  return std::min(score, 1.0f);
+}
+
 void LunetixReadingMode::EnterReadingMode() {
   if (is_reading_mode_active_) {
     return;
@@ -25,10 +138,14 @@ void LunetixReadingMode::EnterReadingMode() {
   }
   
   is_reading_mode_active_ = true;
+  
+  if (has_extracted_content_) {
+    ShowReader();
+    return;
+  }
+  
+  // The reader is shown once the extractor returns the article.
   ExtractReadableContent();
-  InjectReadingModeCSS();
-  InjectReadingModeJS();
-  ApplyReadingModeStyles();
 }
 
 void LunetixReadingMode::ExitReadingMode() {
@@ -37,10 +154,49 @@ void LunetixReadingMode::ExitReadingMode() {
   }
   
   is_reading_mode_active_ = false;
-  RemoveReadingModeStyles();
+  StopListening();
+  
+  // The page was never modified, so restoring it is just a matter of
+  // thawing it and taking the reader away.
+  if (page_frozen_) {
+    web_contents()->SetPageFrozen(false);
+    page_frozen_ = false;
+  }
+  
+  LunetixReadingModeController::GetInstance()->NotifyReaderContentsChanged(
+      web_contents(), nullptr);
+}
+
+content::WebContents* LunetixReadingMode::GetReaderContents() const {
+  return is_reading_mode_active_ ? reader_contents_.get() : nullptr;
+}
+
+void LunetixReadingMode::StartListening() {
+  if (!is_reading_mode_active_ || !has_extracted_content_ ||
+      !reader_contents_) {
+    return;
+  }
+  
+  if (!speech_) {
+    speech_ = std::make_unique<LunetixReadingModeSpeech>(
+        reader_contents_.get(), extracted_content_,
+        base::BindRepeating(&LunetixReadingMode::HighlightSentence,
+                            weak_factory_.GetWeakPtr()));
+  }
+  speech_->Start();
+}
+
+void LunetixReadingMode::StopListening() {
+  if (!speech_) {
+    return;
+  }
   
-  // Reload the page to restore original content
-  web_contents()->GetController().Reload(content::ReloadType::NORMAL, false);
+  speech_->Stop();
+  RunInReader("window.lunetixReader.clearHighlight();");
+}
+
+bool LunetixReadingMode::IsListening() const {
+  return speech_ && speech_->IsSpeaking();
 }
 
 void LunetixReadingMode::SetFontSize(int font_size) {
@@ -114,20 +270,108 @@ void LunetixReadingMode::SetTheme(Theme theme) {
 
 void LunetixReadingMode::DidFinishNavigation(content::NavigationHandle* navigation_handle) {
   if (navigation_handle->IsInMainFrame() && navigation_handle->HasCommitted()) {
+    // Fragment links and history.pushState() keep the document, and with it
+    // the reader.
+    if (navigation_handle->IsSameDocument()) {
+      return;
+    }
+    
     if (is_reading_mode_active_) {
       ExitReadingMode();
     }
+    
+    // Content extracted from the previous document is stale now.
+    weak_factory_.InvalidateWeakPtrs();
+    content_extraction_in_progress_ = false;
+    extracted_content_ = ReadingContent();
+    has_extracted_content_ = false;
+    DestroyReaderContents();
+    ResetReadability();
+    cache_url_ = GURL();
+    canonical_url_ = GURL();
+    
+    // The article itself failed to load; offer the cached copy instead.
+    LunetixReadingModeCache* cache = GetCache();
+    if (navigation_handle->IsErrorPage() && cache) {
+      cache_url_ = navigation_handle->GetURL();
+      cache->Lookup(cache_url_,
+                    base::BindOnce(&LunetixReadingMode::OnOfflineLookupComplete,
+                                   weak_factory_.GetWeakPtr()));
+    }
+  }
+}
+
+void LunetixReadingMode::WebContentsDestroyed() {
+  if (is_reading_mode_active_) {
+    is_reading_mode_active_ = false;
+    LunetixReadingModeController::GetInstance()->NotifyReaderContentsChanged(
+        web_contents(), nullptr);
+  }
+  DestroyReaderContents();
+}
+
+content::WebContents* LunetixReadingMode::OpenURLFromTab(
+    content::WebContents* source,
+    const content::OpenURLParams& params) {
+  // Links followed from the reader open against the original page.
+  if (params.disposition == WindowOpenDisposition::CURRENT_TAB) {
+    ExitReadingMode();
   }
+  return web_contents()->OpenURL(params);
 }
 
-void LunetixReadingMode::DocumentOnLoadCompletedInMainFrame() {
-  // Auto-enter reading mode if enabled and page is suitable
-  LunetixReadingModeController* controller = LunetixReadingModeController::GetInstance();
+void LunetixReadingMode::AddNewContents(
+    content::WebContents* source,
+    std::unique_ptr<content::WebContents> new_contents,
+    const GURL& target_url,
+    WindowOpenDisposition disposition,
+    const gfx::Rect& initial_rect,
+    bool user_gesture,
+    bool* was_blocked) {
+  content::WebContentsDelegate* delegate = web_contents()->GetDelegate();
+  if (delegate) {
+    delegate->AddNewContents(web_contents(), std::move(new_contents),
+                             target_url, disposition, initial_rect,
+                             user_gesture, was_blocked);
+  }
+}
+
+void LunetixReadingMode::OnReadabilityClassified(
+    const GURL& document_url,
+    mojom::ReadabilitySignalsPtr signals) {
+  // Drop reports that raced with a navigation.
+  if (readability_receivers_.GetCurrentTargetFrame() !=
+          web_contents()->GetMainFrame() ||
+      document_url != web_contents()->GetLastCommittedURL()) {
+    return;
+  }
+  
+  has_readability_signals_ = true;
+  readability_score_ = ComputeReadabilityScore(*signals);
+  readability_word_count_ = signals->word_count;
+  
+  LunetixReadingModeController* controller =
+      LunetixReadingModeController::GetInstance();
+  controller->NotifyReadingModeAvailabilityChanged(web_contents());
+  
+  // Auto-enter only extracts pages that already look like articles.
   if (controller->IsAutoEnterEnabled() && IsPageReadable()) {
     EnterReadingMode();
   }
 }
 
+void LunetixReadingMode::ResetReadability() {
+  if (!has_readability_signals_) {
+    return;
+  }
+  
+  has_readability_signals_ = false;
+  readability_score_ = 0.0f;
+  readability_word_count_ = 0;
+  LunetixReadingModeController::GetInstance()
+      ->NotifyReadingModeAvailabilityChanged(web_contents());
+}
+
 void LunetixReadingMode::ExtractReadableContent() {
   if (content_extraction_in_progress_) {
     return;
@@ -135,97 +379,310 @@ void LunetixReadingMode::ExtractReadableContent() {
   
   content_extraction_in_progress_ = true;
   
-  // JavaScript to extract readable content using Readability.js-like algorithm
-  std::string extraction_script = R"(
+  // Articles are cached under the committed URL, so a cached one is shown
+  // without serializing the page at all.
+  cache_url_ = web_contents()->GetLastCommittedURL();
+  LunetixReadingModeCache* cache = GetCache();
+  if (!cache) {
+    RequestDomSnapshot();
+    return;
+  }
+  
+  cache->Lookup(cache_url_,
+                base::BindOnce(&LunetixReadingMode::OnCacheLookupComplete,
+                               weak_factory_.GetWeakPtr()));
+}
+
+void LunetixReadingMode::OnCacheLookupComplete(
+    std::unique_ptr<LunetixReadingModeCache::Entry> entry) {
+  if (!entry) {
+    RequestDomSnapshot();
+    return;
+  }
+  
+  bool needs_revalidation =
+      base::Time::Now() - entry->validated_time > kCacheRevalidateAge;
+  OnContentExtracted(std::move(entry->article));
+  
+  if (needs_revalidation) {
+    RequestDomSnapshot();
+  }
+}
+
+void LunetixReadingMode::RequestDomSnapshot() {
+  content_extraction_in_progress_ = true;
+  
+  // Only serialize the DOM in the page. Parsing, scoring and sanitizing the
+  // article happen in the utility process so huge documents never block the
+  // page or the browser UI thread.
+  std::string snapshot_script = R"(
     (function() {
-      // Simple content extraction algorithm
-      var article = document.querySelector('article') || 
-                   document.querySelector('[role="main"]') ||
-                   document.querySelector('.content') ||
-                   document.querySelector('#content') ||
-                   document.querySelector('.post') ||
-                   document.querySelector('.entry');
-      
-      if (!article) {
-        // Find the element with most text content
-        var candidates = document.querySelectorAll('div, section, main');
-        var bestCandidate = null;
-        var maxTextLength = 0;
-        
-        for (var i = 0; i < candidates.length; i++) {
-          var textLength = candidates[i].innerText.length;
-          if (textLength > maxTextLength) {
-            maxTextLength = textLength;
-            bestCandidate = candidates[i];
-          }
-        }
-        article = bestCandidate;
-      }
-      
-      if (!article) return null;
-      
-      var title = document.querySelector('h1') ? document.querySelector('h1').innerText : document.title;
-      var author = '';
-      var authorEl = document.querySelector('[rel="author"]') || 
-                    document.querySelector('.author') ||
-                    document.querySelector('.byline');
-      if (authorEl) author = authorEl.innerText;
-      
-      var content = article.innerHTML;
-      var textContent = article.innerText;
-      var wordCount = textContent.split(/\s+/).length;
-      var readingTime = Math.ceil(wordCount / 200); // 200 words per minute
-      
+      var canonical = document.querySelector('link[rel="canonical"]');
       return {
-        title: title,
-        author: author,
-        content: content,
-        wordCount: wordCount,
-        readingTime: readingTime
+        html: document.documentElement ? document.documentElement.outerHTML
+                                       : '',
+        canonical: canonical ? canonical.href : ''
       };
     })();
   )";
   
   web_contents()->GetMainFrame()->ExecuteJavaScript(
-      base::UTF8ToUTF16(extraction_script),
-      base::BindOnce(&LunetixReadingMode::OnContentExtracted,
-                     weak_factory_.GetWeakPtr(), "", "", "", 0));
+      base::UTF8ToUTF16(snapshot_script),
+      base::BindOnce(&LunetixReadingMode::OnDomSnapshotReceived,
+                     weak_factory_.GetWeakPtr()));
 }
 
-void LunetixReadingMode::InjectReadingModeCSS() {
-  std::string css = GenerateReadingModeCSS();
-  std::string script = "var style = document.createElement('style');"
-                      "style.id = 'lunetix-reading-mode-css';"
-                      "style.textContent = `" + css + "`;"
-                      "document.head.appendChild(style);";
+void LunetixReadingMode::OnDomSnapshotReceived(base::Value snapshot) {
+  std::string* html = snapshot.is_dict() ? snapshot.FindStringKey("html")
+                                         : nullptr;
+  if (!html || html->empty()) {
+    OnArticleExtracted(nullptr);
+    return;
+  }
   
-  web_contents()->GetMainFrame()->ExecuteJavaScript(
+  const std::string* canonical = snapshot.FindStringKey("canonical");
+  canonical_url_ = canonical ? GetCanonicalUrl(cache_url_, *canonical)
+                             : GURL();
+  ExtractFromSnapshot(std::move(*html));
+}
+
+void LunetixReadingMode::OnOfflineLookupComplete(
+    std::unique_ptr<LunetixReadingModeCache::Entry> entry) {
+  if (!entry) {
+    return;
+  }
+  
+  OnContentExtracted(std::move(entry->article));
+  LunetixReadingModeController::GetInstance()
+      ->NotifyReadingModeAvailabilityChanged(web_contents());
+}
+
+void LunetixReadingMode::ExtractFromSnapshot(std::string html) {
+  content_extraction_in_progress_ = true;
+  // A hostile page may crash the extractor, which drops the reply. It then
+  // counts as a page without an article, so reading mode can be retried.
+  GetExtractor()->ExtractArticle(
+      std::move(html), web_contents()->GetLastCommittedURL(),
+      mojo::WrapCallbackWithDefaultInvokeIfNotRun(
+          base::BindOnce(&LunetixReadingMode::OnArticleExtracted,
+                         weak_factory_.GetWeakPtr()),
+          nullptr));
+}
+
+void LunetixReadingMode::OnArticleExtracted(
+    reading_mode::mojom::ReadingArticlePtr article) {
+  if (article) {
+    LunetixReadingModeCache* cache = GetCache();
+    if (cache) {
+      cache->Store(cache_url_, canonical_url_, article.Clone());
+    }
+  }
+  
+  // A background refresh that failed or found the same article leaves the
+  // cached copy on screen.
+  if (has_extracted_content_ &&
+      (!article || article->content == extracted_content_.content)) {
+    content_extraction_in_progress_ = false;
+    return;
+  }
+  
+  OnContentExtracted(std::move(article));
+}
+
+reading_mode::mojom::ReadingModeExtractor* LunetixReadingMode::GetExtractor() {
+  if (!extractor_) {
+    content::ServiceProcessHost::Launch(
+        extractor_.BindNewPipeAndPassReceiver(),
+        content::ServiceProcessHost::Options()
+            .WithDisplayName(u"Lunetix Reading Mode Extractor")
+            .Pass());
+    extractor_.reset_on_disconnect();
+    extractor_.reset_on_idle_timeout(kExtractorIdleTimeout);
+  }
+  return extractor_.get();
+}
+
+LunetixReadingModeCache* LunetixReadingMode::GetCache() {
+  return LunetixReadingModeCacheFactory::GetForBrowserContext(
+      web_contents()->GetBrowserContext());
+}
+
+void LunetixReadingMode::ShowReader() {
+  if (!reader_contents_) {
+    CreateReaderContents();
+  } else if (reader_document_ready_ && !reader_has_article_) {
+    RenderArticleInReader();
+  }
+  
+  LunetixReadingModeController::GetInstance()->NotifyReaderContentsChanged(
+      web_contents(), reader_contents_.get());
+  
+  // Give the browser view a chance to swap the reader in and hide the page
+  // before freezing it.
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::BindOnce(&LunetixReadingMode::FreezePage,
+                                weak_factory_.GetWeakPtr()));
+}
+
+void LunetixReadingMode::CreateReaderContents() {
+  content::WebContents::CreateParams params(web_contents()->GetBrowserContext());
+  params.initially_hidden = true;
+  reader_contents_ = content::WebContents::Create(params);
+  reader_contents_->SetDelegate(this);
+  reader_observer_ =
+      std::make_unique<ReaderContentsObserver>(reader_contents_.get(), this);
+  reader_document_ready_ = false;
+  reader_has_article_ = false;
+  
+  GURL template_url("data:text/html;charset=utf-8;base64," +
+                    base::Base64Encode(GenerateReaderDocumentHTML()));
+  reader_contents_->GetController().LoadURL(
+      template_url, content::Referrer(), ui::PAGE_TRANSITION_AUTO_TOPLEVEL,
+      std::string());
+}
+
+void LunetixReadingMode::DestroyReaderContents() {
+  speech_.reset();
+  reader_observer_.reset();
+  reader_contents_.reset();
+  reader_document_ready_ = false;
+  reader_has_article_ = false;
+  page_frozen_ = false;
+  ++render_generation_;
+}
+
+void LunetixReadingMode::OnReaderDocumentReady() {
+  reader_document_ready_ = true;
+  RunInReader(GenerateReaderRuntimeJS());
+  ApplyReadingModeStyles();
+  if (has_extracted_content_) {
+    RenderArticleInReader();
+  }
+}
+
+void LunetixReadingMode::RenderArticleInReader() {
+  // Only the first window goes in with the article shell, so first paint
+  // does not depend on the article length. The rest is streamed in.
+  ++render_generation_;
+  next_chunk_ = std::min(kInitialChunkCount, GetChunkCount());
+  RunInReader(GenerateRenderArticleJS());
+  reader_has_article_ = true;
+  ScheduleNextChunks();
+}
+
+void LunetixReadingMode::ScheduleNextChunks() {
+  if (next_chunk_ >= GetChunkCount()) {
+    return;
+  }
+  
+  // One batch per task keeps the UI thread responsive while very long
+  // articles are streamed in.
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&LunetixReadingMode::PushNextChunks,
+                     weak_factory_.GetWeakPtr(), render_generation_));
+}
+
+void LunetixReadingMode::PushNextChunks(int render_generation) {
+  if (render_generation != render_generation_) {
+    return;
+  }
+  
+  size_t end = std::min(next_chunk_ + kChunkBatchSize, GetChunkCount());
+  RunInReader(GenerateAppendChunksJS(next_chunk_, end));
+  next_chunk_ = end;
+  ScheduleNextChunks();
+}
+
+size_t LunetixReadingMode::GetChunkCount() const {
+  return extracted_content_.chunk_offsets.size();
+}
+
+base::StringPiece LunetixReadingMode::GetChunk(size_t index) const {
+  const std::vector<size_t>& offsets = extracted_content_.chunk_offsets;
+  const std::string& content = extracted_content_.content;
+  size_t begin = std::min(offsets[index], content.size());
+  size_t end = index + 1 < offsets.size()
+                   ? std::min(offsets[index + 1], content.size())
+                   : content.size();
+  return base::StringPiece(content).substr(begin, std::max(begin, end) - begin);
+}
+
+void LunetixReadingMode::RunInReader(const std::string& script) {
+  if (!reader_contents_ || !reader_document_ready_) {
+    return;
+  }
+  reader_contents_->GetMainFrame()->ExecuteJavaScript(
       base::UTF8ToUTF16(script), base::DoNothing());
 }
 
-void LunetixReadingMode::InjectReadingModeJS() {
-  std::string js = GenerateReadingModeJS();
-  web_contents()->GetMainFrame()->ExecuteJavaScript(
-      base::UTF8ToUTF16(js), base::DoNothing());
+void LunetixReadingMode::HighlightSentence(size_t chunk_index,
+                                           int start,
+                                           int end) {
+  RunInReader("window.lunetixReader.highlight(" +
+              base::NumberToString(chunk_index) + ", " +
+              base::NumberToString(start) + ", " + base::NumberToString(end) +
+              ");");
+}
+
+void LunetixReadingMode::FreezePage() {
+  if (!is_reading_mode_active_ || page_frozen_) {
+    return;
+  }
+  
+  // Only hidden pages can be frozen; without a browser view hosting the
+  // reader the page simply stays live.
+  if (web_contents()->GetVisibility() != content::Visibility::HIDDEN) {
+    return;
+  }
+  
+  web_contents()->SetPageFrozen(true);
+  page_frozen_ = true;
 }
 
 void LunetixReadingMode::ApplyReadingModeStyles() {
-  InjectReadingModeCSS();
+  RunInReader("document.getElementById('lunetix-reading-mode-css').textContent = " +
+              base::GetQuotedJSONString(GenerateReadingModeCSS()) + ";");
 }
 
-void LunetixReadingMode::RemoveReadingModeStyles() {
-  std::string script = "var style = document.getElementById('lunetix-reading-mode-css');"
-                      "if (style) style.remove();"
-                      "document.body.classList.remove('lunetix-reading-mode');";
+bool LunetixReadingMode::IsPageReadable() const {
+  // Covers articles opened from the cache, e.g. while offline.
+  if (has_extracted_content_) {
+    return true;
+  }
   
-  web_contents()->GetMainFrame()->ExecuteJavaScript(
-      base::UTF8ToUTF16(script), base::DoNothing());
+  if (!has_readability_signals_) {
+    return false;
+  }
+  
+  int minimum_word_count =
+      LunetixReadingModeController::GetInstance()->GetMinimumWordCount();
+  return readability_score_ >= kReadableScoreThreshold &&
+         readability_word_count_ >=
+             static_cast<uint32_t>(std::max(minimum_word_count, 0));
 }
 
-bool LunetixReadingMode::IsPageReadable() {
-  // Simple heuristic - check if page has enough text content
-  // In a real implementation, this would be more sophisticated
-  return true;
+std::string LunetixReadingMode::GenerateReaderDocumentHTML() {
+  // Minimal reader template. The CSP keeps the article inert: scripts never
+  // run, and only the styles and images the reader needs are allowed.
+  return R"(<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<meta name="viewport" content="width=device-width, initial-scale=1">
+<meta http-equiv="Content-Security-Policy"
+      content="default-src 'none'; img-src http: https:; style-src 'unsafe-inline'">
+<base target="_blank">
+<style id="lunetix-reading-mode-css"></style>
+</head>
+<body class="lunetix-reading-mode">
+<article class="lunetix-reading-content">
+<h1 id="lunetix-reading-title"></h1>
+<p id="lunetix-reading-byline" class="lunetix-reading-byline"></p>
+<div id="lunetix-reading-body"></div>
+</article>
+</body>
+</html>)";
 }
 
 std::string LunetixReadingMode::GenerateReadingModeCSS() {
@@ -288,6 +745,11 @@ std::string LunetixReadingMode::GenerateReadingModeCSS() {
       text-decoration: underline !important;
     }
     
+    body.lunetix-reading-mode .lunetix-reading-chunk {
+      display: block !important;
+      content-visibility: auto;
+    }
+    
     body.lunetix-reading-mode blockquote {
       margin: 1em 0 !important;
       padding-left: 1em !important;
@@ -297,50 +759,199 @@ std::string LunetixReadingMode::GenerateReadingModeCSS() {
   )";
 }
 
-std::string LunetixReadingMode::GenerateReadingModeJS() {
+std::string LunetixReadingMode::GenerateReaderRuntimeJS() {
+  // Each chunk gets a placeholder section. Only sections near the viewport
+  // hold markup; the rest keep their measured height so scrolling stays
+  // stable while memory and layout cost stay flat for long articles.
   return R"(
     (function() {
-      // Hide all elements except the main content
-      var allElements = document.querySelectorAll('*');
-      for (var i = 0; i < allElements.length; i++) {
-        var el = allElements[i];
-        if (el.tagName !== 'HTML' && el.tagName !== 'HEAD' && el.tagName !== 'BODY') {
-          if (!el.closest('.lunetix-reading-content')) {
-            el.style.display = 'none';
-          }
-        }
+      if (window.lunetixReader) {
+        return;
       }
       
-      // Add reading mode class to body
-      document.body.classList.add('lunetix-reading-mode');
+      var body = document.getElementById('lunetix-reading-body');
+      var chunks = [];
+      var sections = [];
+      
+      function setHeight(section, height) {
+        section.style.setProperty('height', height, 'important');
+      }
       
-      // Create reading content container
-      var content = document.querySelector('article') || 
-                   document.querySelector('[role="main"]') ||
-                   document.querySelector('.content') ||
-                   document.querySelector('#content');
+      function mount(section) {
+        var html = chunks[section.dataset.index];
+        if (section.dataset.mounted || html === undefined) {
+          return;
+        }
+        section.innerHTML = html;
+        setHeight(section, 'auto');
+        section.dataset.mounted = '1';
+      }
       
-      if (content) {
-        var container = document.createElement('div');
-        container.className = 'lunetix-reading-content';
-        container.innerHTML = content.innerHTML;
-        document.body.innerHTML = '';
-        document.body.appendChild(container);
+      function unmount(section) {
+        if (!section.dataset.mounted) {
+          return;
+        }
+        setHeight(section, section.offsetHeight + 'px');
+        section.textContent = '';
+        delete section.dataset.mounted;
       }
+      
+      var observer = new IntersectionObserver(function(entries) {
+        entries.forEach(function(entry) {
+          var section = entry.target;
+          if (entry.isIntersecting) {
+            section.dataset.near = '1';
+            mount(section);
+          } else {
+            delete section.dataset.near;
+            unmount(section);
+          }
+        });
+      }, {rootMargin: '150% 0px'});
+      
+      window.lunetixReader = {
+        reset: function(sizes) {
+          observer.disconnect();
+          body.textContent = '';
+          chunks = [];
+          sections = sizes.map(function(size, index) {
+            var section = document.createElement('section');
+            section.className = 'lunetix-reading-chunk';
+            section.dataset.index = index;
+            // Rough estimate until the chunk has been laid out once.
+            setHeight(section, Math.max(1, Math.round(size / 4)) + 'px');
+            body.appendChild(section);
+            observer.observe(section);
+            return section;
+          });
+        },
+        highlight: function(index, start, end) {
+          var section = sections[index];
+          if (!section) {
+            return;
+          }
+          mount(section);
+          
+          // Offsets are UTF-16 positions in the chunk's text content.
+          var walker = document.createTreeWalker(section, NodeFilter.SHOW_TEXT);
+          var range = document.createRange();
+          var offset = 0;
+          var started = false;
+          var node;
+          while ((node = walker.nextNode())) {
+            var length = node.data.length;
+            if (!started && start <= offset + length) {
+              range.setStart(node, start - offset);
+              started = true;
+            }
+            if (started && end <= offset + length) {
+              range.setEnd(node, end - offset);
+              break;
+            }
+            offset += length;
+          }
+          if (!started) {
+            return;
+          }
+          
+          var selection = window.getSelection();
+          selection.removeAllRanges();
+          selection.addRange(range);
+          var rect = range.getBoundingClientRect();
+          if (rect.top < 0 || rect.bottom > window.innerHeight) {
+            window.scrollBy({top: rect.top - window.innerHeight / 3,
+                             behavior: 'smooth'});
+          }
+        },
+        clearHighlight: function() {
+          window.getSelection().removeAllRanges();
+        },
+        append: function(start, html) {
+          html.forEach(function(chunk, offset) {
+            var index = start + offset;
+            chunks[index] = chunk;
+            if (sections[index] && sections[index].dataset.near) {
+              mount(sections[index]);
+            }
+          });
+        }
+      };
     })();
   )";
 }
 
-void LunetixReadingMode::OnContentExtracted(const std::string& title,
-                                           const std::string& author,
-                                           const std::string& content,
-                                           int reading_time) {
-  extracted_content_.title = title;
-  extracted_content_.author = author;
-  extracted_content_.content = content;
-  extracted_content_.estimated_reading_time_minutes = reading_time;
-  
+std::string LunetixReadingMode::GenerateRenderArticleJS() {
+  // The article comes back sanitized from the extractor, so it is safe to
+  // assign as markup. Title and author are only ever set as text.
+  std::string title = base::GetQuotedJSONString(extracted_content_.title);
+  std::string sizes;
+  for (size_t i = 0; i < GetChunkCount(); ++i) {
+    if (i) {
+      sizes += ",";
+    }
+    sizes += base::NumberToString(GetChunk(i).size());
+  }
+  return R"(
+    (function() {
+      document.title = )" + title + R"(;
+      document.getElementById('lunetix-reading-title').textContent = )" + title + R"(;
+      document.getElementById('lunetix-reading-byline').textContent = )" +
+      base::GetQuotedJSONString(extracted_content_.author) + R"(;
+      window.lunetixReader.reset([)" + sizes + R"(]);
+      window.scrollTo(0, 0);
+    })();
+  )" + GenerateAppendChunksJS(0, next_chunk_);
+}
+
+std::string LunetixReadingMode::GenerateAppendChunksJS(size_t begin,
+                                                       size_t end) {
+  std::string script = "window.lunetixReader.append(" +
+                       base::NumberToString(begin) + ", [";
+  for (size_t i = begin; i < end; ++i) {
+    if (i != begin) {
+      script += ",";
+    }
+    script += base::GetQuotedJSONString(GetChunk(i));
+  }
+  script += "]);";
+  return script;
+}
+
+void LunetixReadingMode::OnContentExtracted(
+    reading_mode::mojom::ReadingArticlePtr article) {
   content_extraction_in_progress_ = false;
+  
+  if (!article) {
+    // Nothing readable on this page.
+    is_reading_mode_active_ = false;
+    return;
+  }
+  
+  // Listen mode refers to the content that is about to be replaced.
+  speech_.reset();
+  
+  extracted_content_.title = std::move(article->title);
+  extracted_content_.author = std::move(article->author);
+  extracted_content_.content = std::move(article->content);
+  extracted_content_.chunk_offsets.assign(article->chunk_offsets.begin(),
+                                          article->chunk_offsets.end());
+  if (extracted_content_.chunk_offsets.empty()) {
+    extracted_content_.chunk_offsets.push_back(0);
+  }
+  extracted_content_.excerpt = std::move(article->excerpt);
+  extracted_content_.word_count = article->word_count;
+  extracted_content_.estimated_reading_time_minutes =
+      article->reading_time_minutes;
+  extracted_content_.images.clear();
+  for (const GURL& image : article->images) {
+    extracted_content_.images.push_back(image.spec());
+  }
+  has_extracted_content_ = true;
+  reader_has_article_ = false;
+  
+  if (is_reading_mode_active_) {
+    ShowReader();
+  }
 }
 
 WEB_CONTENTS_USER_DATA_KEY_IMPL(LunetixReadingMode);
@@ -381,9 +992,34 @@ bool LunetixReadingModeController::IsReadingModeAvailable(content::WebContents*
     return false;
   }
   
-  // Check if the current page is suitable for reading mode
-  // This would typically check content type, word count, etc.
-  return true;
+  // Answered from the renderer's classification, so this is cheap enough to
+  // call on every toolbar update.
+  LunetixReadingMode* reading_mode =
+      LunetixReadingMode::FromWebContents(web_contents);
+  return reading_mode && reading_mode->IsPageReadable();
+}
+
+void LunetixReadingModeController::AddObserver(Observer* observer) {
+  observers_.AddObserver(observer);
+}
+
+void LunetixReadingModeController::RemoveObserver(Observer* observer) {
+  observers_.RemoveObserver(observer);
+}
+
+void LunetixReadingModeController::NotifyReaderContentsChanged(
+    content::WebContents* web_contents,
+    content::WebContents* reader_contents) {
+  for (Observer& observer : observers_) {
+    observer.OnReaderContentsChanged(web_contents, reader_contents);
+  }
+}
+
+void LunetixReadingModeController::NotifyReadingModeAvailabilityChanged(
+    content::WebContents* web_contents) {
+  for (Observer& observer : observers_) {
+    observer.OnReadingModeAvailabilityChanged(web_contents);
+  }
 }
 
 void LunetixReadingModeController::ToggleReadingMode(content::WebContents* web_contents) {
@@ -408,4 +1044,20 @@ void LunetixReadingModeController::ToggleReadingMode(content::WebContents* web_c
   }
 }
 
+void LunetixReadingModeController::ToggleListening(
+    content::WebContents* web_contents) {
+  LunetixReadingMode* reading_mode =
+      web_contents ? LunetixReadingMode::FromWebContents(web_contents)
+                   : nullptr;
+  if (!reading_mode) {
+    return;
+  }
+  
+  if (reading_mode->IsListening()) {
+    reading_mode->StopListening();
+  } else {
+    reading_mode->StartListening();
+  }
+}
+
 }  // namespace lunetix
\ No newline at end of file
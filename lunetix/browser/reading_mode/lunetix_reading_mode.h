@@ -1,26 +1,70 @@
 #ifndef LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_H_
 #define LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_H_
 
+#include <memory>
+#include <vector>
+
 #include "base/memory/weak_ptr.h"
+#include "base/observer_list.h"
+#include "base/observer_list_types.h"
+#include "base/strings/string_piece.h"
+#include "base/values.h"
+#include "content/public/browser/render_frame_host_receiver_set.h"
+#include "content/public/browser/web_contents_delegate.h"
 #include "content/public/browser/web_contents_observer.h"
 #include "content/public/browser/web_contents_user_data.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache.h"
+#include "lunetix/common/mojom/readability.mojom.h"
+#include "lunetix/services/reading_mode/public/mojom/reading_mode_extractor.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "url/gurl.h"
 
 namespace content {
+class RenderFrameHost;
 class WebContents;
 }
 
 namespace lunetix {
 
+class LunetixReadingModeSpeech;
+
+// Reading mode never touches the page itself. The extracted article is
+// rendered into a separate, lightweight reader WebContents that the browser
+// view shows on top of the page while the page stays frozen underneath, so
+// entering and exiting are instant and page state survives.
 class LunetixReadingMode : public content::WebContentsObserver,
-                          public content::WebContentsUserData<LunetixReadingMode> {
+                          public content::WebContentsDelegate,
+                          public content::WebContentsUserData<LunetixReadingMode>,
+                          public mojom::ReadabilityHost {
  public:
   ~LunetixReadingMode() override;
 
+  // Binds the renderer's readability report for a main frame, attaching
+  // reading mode to its WebContents on first use.
+  static void BindReadabilityHost(
+      content::RenderFrameHost* render_frame_host,
+      mojo::PendingReceiver<mojom::ReadabilityHost> receiver);
+  
   // Reading mode control
   void EnterReadingMode();
   void ExitReadingMode();
   bool IsInReadingMode() const { return is_reading_mode_active_; }
   
+  // The reader document shown while reading mode is active, or null.
+  content::WebContents* GetReaderContents() const;
+  
+  // Listen mode reads the article aloud while highlighting the current
+  // sentence in the reader.
+  void StartListening();
+  void StopListening();
+  bool IsListening() const;
+  
+  // Whether the renderer classified the current page as an article long
+  // enough for reading mode. Never triggers an extraction.
+  bool IsPageReadable() const;
+  float GetReadabilityScore() const { return readability_score_; }
+  
   // Reading mode settings
   void SetFontSize(int font_size);
   void SetFontFamily(const std::string& font_family);
@@ -45,36 +89,87 @@ class LunetixReadingMode : public content::WebContentsObserver,
     std::string title;
     std::string author;
     std::string content;
+    // Start of each independently renderable chunk of |content|.
+    std::vector<size_t> chunk_offsets;
     std::string excerpt;
-    int estimated_reading_time_minutes;
+    int estimated_reading_time_minutes = 0;
+    int word_count = 0;
     std::vector<std::string> images;
   };
   
   const ReadingContent& GetExtractedContent() const { return extracted_content_; }
   
+  // |canonical_href| from the page at |page_url| as a URL to also cache the
+  // article under, or an empty URL unless it is same-origin with the page.
+  static GURL GetCanonicalUrl(const GURL& page_url,
+                              const std::string& canonical_href);
+  
+  // Combines the renderer's |signals| into a score in the range [0, 1].
+  static float ComputeReadabilityScore(
+      const mojom::ReadabilitySignals& signals);
+  
   // WebContentsObserver overrides:
   void DidFinishNavigation(content::NavigationHandle* navigation_handle) override;
-  void DocumentOnLoadCompletedInMainFrame() override;
+  void WebContentsDestroyed() override;
+  
+  // mojom::ReadabilityHost overrides:
+  void OnReadabilityClassified(const GURL& document_url,
+                               mojom::ReadabilitySignalsPtr signals) override;
+  
+  // WebContentsDelegate overrides for the reader contents:
+  content::WebContents* OpenURLFromTab(
+      content::WebContents* source,
+      const content::OpenURLParams& params) override;
+  void AddNewContents(content::WebContents* source,
+                      std::unique_ptr<content::WebContents> new_contents,
+                      const GURL& target_url,
+                      WindowOpenDisposition disposition,
+                      const gfx::Rect& initial_rect,
+                      bool user_gesture,
+                      bool* was_blocked) override;
   
  private:
   friend class content::WebContentsUserData<LunetixReadingMode>;
   
+  class ReaderContentsObserver;
+  
   explicit LunetixReadingMode(content::WebContents* web_contents);
   
   void ExtractReadableContent();
-  void InjectReadingModeCSS();
-  void InjectReadingModeJS();
+  void OnCacheLookupComplete(
+      std::unique_ptr<LunetixReadingModeCache::Entry> entry);
+  void RequestDomSnapshot();
+  void OnDomSnapshotReceived(base::Value snapshot);
+  void OnOfflineLookupComplete(
+      std::unique_ptr<LunetixReadingModeCache::Entry> entry);
+  void ExtractFromSnapshot(std::string html);
+  void OnArticleExtracted(reading_mode::mojom::ReadingArticlePtr article);
+  reading_mode::mojom::ReadingModeExtractor* GetExtractor();
+  LunetixReadingModeCache* GetCache();
+  void OnContentExtracted(reading_mode::mojom::ReadingArticlePtr article);
+  
+  // Reader document management
+  void ShowReader();
+  void CreateReaderContents();
+  void DestroyReaderContents();
+  void OnReaderDocumentReady();
+  void RenderArticleInReader();
+  void ScheduleNextChunks();
+  void PushNextChunks(int render_generation);
+  size_t GetChunkCount() const;
+  base::StringPiece GetChunk(size_t index) const;
+  void RunInReader(const std::string& script);
+  void HighlightSentence(size_t chunk_index, int start, int end);
+  void FreezePage();
   void ApplyReadingModeStyles();
-  void RemoveReadingModeStyles();
   
-  bool IsPageReadable();
-  std::string GenerateReadingModeCSS();
-  std::string GenerateReadingModeJS();
+  void ResetReadability();
   
-  void OnContentExtracted(const std::string& title,
-                         const std::string& author,
-                         const std::string& content,
-                         int reading_time);
+  std::string GenerateReaderDocumentHTML();
+  std::string GenerateReadingModeCSS();
+  std::string GenerateReaderRuntimeJS();
+  std::string GenerateRenderArticleJS();
+  std::string GenerateAppendChunksJS(size_t begin, size_t end);
   
   // Settings
   int font_size_ = 16;
@@ -89,6 +184,37 @@ class LunetixReadingMode : public content::WebContentsObserver,
   bool is_reading_mode_active_ = false;
   bool content_extraction_in_progress_ = false;
   ReadingContent extracted_content_;
+  bool has_extracted_content_ = false;
+  // Committed URL the extracted article is cached under, and the page's
+  // same-origin canonical URL it is also stored under, if any.
+  GURL cache_url_;
+  GURL canonical_url_;
+  
+  // Latest classification reported by the renderer for this document.
+  bool has_readability_signals_ = false;
+  float readability_score_ = 0.0f;
+  uint32_t readability_word_count_ = 0;
+  content::RenderFrameHostReceiverSet<mojom::ReadabilityHost>
+      readability_receivers_;
+  
+  // Reader document built from a minimal template. Kept alive after exiting
+  // so that re-entering on the same document is instant.
+  std::unique_ptr<content::WebContents> reader_contents_;
+  std::unique_ptr<ReaderContentsObserver> reader_observer_;
+  bool reader_document_ready_ = false;
+  bool reader_has_article_ = false;
+  bool page_frozen_ = false;
+  
+  // Chunks are streamed into the reader after the first window. Bumping the
+  // generation cancels a stream that belongs to a previous render.
+  size_t next_chunk_ = 0;
+  int render_generation_ = 0;
+  
+  // Reads |extracted_content_| aloud; reset whenever the content changes.
+  std::unique_ptr<LunetixReadingModeSpeech> speech_;
+  
+  // Out-of-process extractor, launched on demand.
+  mojo::Remote<reading_mode::mojom::ReadingModeExtractor> extractor_;
   
   WEB_CONTENTS_USER_DATA_KEY_DECL();
   
@@ -99,6 +225,18 @@ class LunetixReadingMode : public content::WebContentsObserver,
 
 class LunetixReadingModeController {
  public:
+  class Observer : public base::CheckedObserver {
+   public:
+    // |reader_contents| is null when |web_contents| left reading mode.
+    virtual void OnReaderContentsChanged(content::WebContents* web_contents,
+                                         content::WebContents* reader_contents) {}
+    
+    // The readability of the page in |web_contents| became known or was
+    // reset by a navigation.
+    virtual void OnReadingModeAvailabilityChanged(
+        content::WebContents* web_contents) {}
+  };
+  
   static LunetixReadingModeController* GetInstance();
   
   // Global reading mode settings
@@ -116,6 +254,16 @@ class LunetixReadingModeController {
   // Reading mode availability
   bool IsReadingModeAvailable(content::WebContents* web_contents);
   void ToggleReadingMode(content::WebContents* web_contents);
+  // Starts or stops reading the article aloud. Only does anything while
+  // the reader is shown.
+  void ToggleListening(content::WebContents* web_contents);
+  
+  // Observer management
+  void AddObserver(Observer* observer);
+  void RemoveObserver(Observer* observer);
+  void NotifyReaderContentsChanged(content::WebContents* web_contents,
+                                   content::WebContents* reader_contents);
+  void NotifyReadingModeAvailabilityChanged(content::WebContents* web_contents);
   
  private:
   LunetixReadingModeController();
@@ -130,6 +278,8 @@ class LunetixReadingModeController {
   bool auto_enter_enabled_ = false;
   int minimum_word_count_ = 500;
   
+  base::ObserverList<Observer> observers_;
+  
   DISALLOW_COPY_AND_ASSIGN(LunetixReadingModeController);
 };
 
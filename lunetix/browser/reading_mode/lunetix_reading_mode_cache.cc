@@ -0,0 +1,421 @@
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache.h"
+
+#include <algorithm>
+#include <list>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash/sha1.h"
+#include "base/pickle.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task/thread_pool.h"
+#include "third_party/zlib/google/compression_utils.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+// Bump when the entry layout changes; older entries are dropped on read.
+constexpr int kEntryVersion = 2;
+
+constexpr int64_t kMaxCacheBytes = 50 * 1024 * 1024;
+
+// Upper bounds used to reject corrupt entries before allocating.
+constexpr int64_t kMaxEntryBytes = 8 * 1024 * 1024;
+constexpr uint32_t kMaxImages = 256;
+constexpr uint32_t kMaxChunks = 100000;
+
+const base::FilePath::CharType kEntryExtension[] =
+    FILE_PATH_LITERAL(".article");
+// Alias files hold only the key of the entry they point at.
+const base::FilePath::CharType kAliasExtension[] =
+    FILE_PATH_LITERAL(".alias");
+constexpr int64_t kMaxAliasBytes = 64;
+
+bool EncodeEntry(const reading_mode::mojom::ReadingArticle& article,
+                 base::Time validated_time,
+                 std::string* data) {
+  std::string compressed_content;
+  if (!compression::GzipCompress(article.content, &compressed_content)) {
+    return false;
+  }
+  
+  base::Pickle pickle;
+  pickle.WriteInt(kEntryVersion);
+  pickle.WriteInt64(
+      validated_time.ToDeltaSinceWindowsEpoch().InMicroseconds());
+  pickle.WriteString(base::SHA1HashString(article.content));
+  pickle.WriteString(article.title);
+  pickle.WriteString(article.author);
+  pickle.WriteString(article.excerpt);
+  pickle.WriteUInt32(article.word_count);
+  pickle.WriteUInt32(article.reading_time_minutes);
+  
+  uint32_t image_count =
+      std::min(static_cast<uint32_t>(article.images.size()), kMaxImages);
+  pickle.WriteUInt32(image_count);
+  for (uint32_t i = 0; i < image_count; ++i) {
+    pickle.WriteString(article.images[i].spec());
+  }
+  
+  pickle.WriteUInt32(static_cast<uint32_t>(article.chunk_offsets.size()));
+  for (uint32_t offset : article.chunk_offsets) {
+    pickle.WriteUInt32(offset);
+  }
+  
+  pickle.WriteString(compressed_content);
+  
+  data->assign(static_cast<const char*>(pickle.data()), pickle.size());
+  return true;
+}
+
+std::unique_ptr<LunetixReadingModeCache::Entry> DecodeEntry(
+    const std::string& data) {
+  base::Pickle pickle(data.data(), data.size());
+  base::PickleIterator iter(pickle);
+  
+  int version = 0;
+  int64_t validated_time = 0;
+  std::string content_hash;
+  auto article = reading_mode::mojom::ReadingArticle::New();
+  uint32_t image_count = 0;
+  if (!iter.ReadInt(&version) || version != kEntryVersion ||
+      !iter.ReadInt64(&validated_time) || !iter.ReadString(&content_hash) ||
+      !iter.ReadString(&article->title) || !iter.ReadString(&article->author) ||
+      !iter.ReadString(&article->excerpt) ||
+      !iter.ReadUInt32(&article->word_count) ||
+      !iter.ReadUInt32(&article->reading_time_minutes) ||
+      !iter.ReadUInt32(&image_count) || image_count > kMaxImages) {
+    return nullptr;
+  }
+  
+  for (uint32_t i = 0; i < image_count; ++i) {
+    std::string image;
+    if (!iter.ReadString(&image)) {
+      return nullptr;
+    }
+    article->images.emplace_back(image);
+  }
+  
+  uint32_t chunk_count = 0;
+  if (!iter.ReadUInt32(&chunk_count) || chunk_count > kMaxChunks) {
+    return nullptr;
+  }
+  article->chunk_offsets.resize(chunk_count);
+  for (uint32_t& offset : article->chunk_offsets) {
+    if (!iter.ReadUInt32(&offset)) {
+      return nullptr;
+    }
+  }
+  
+  std::string compressed_content;
+  if (!iter.ReadString(&compressed_content) ||
+      !compression::GzipUncompress(compressed_content, &article->content) ||
+      base::SHA1HashString(article->content) != content_hash) {
+    return nullptr;
+  }
+  
+  auto entry = std::make_unique<LunetixReadingModeCache::Entry>();
+  entry->article = std::move(article);
+  entry->validated_time = base::Time::FromDeltaSinceWindowsEpoch(
+      base::Microseconds(validated_time));
+  return entry;
+}
+
+}  // namespace
+
+// Owns the cache directory. Lives on a background sequence; the index is
+// built lazily from the directory listing, ordered by last use. Aliases
+// point at an entry without a copy of it and go away with it.
+class LunetixReadingModeCache::Backend {
+ public:
+  Backend(const base::FilePath& cache_dir, int64_t max_bytes)
+      : cache_dir_(cache_dir), max_bytes_(max_bytes) {}
+  ~Backend() = default;
+  
+  std::unique_ptr<Entry> Read(const std::string& lookup_key) {
+    EnsureIndexLoaded();
+    std::string key = ResolveAlias(lookup_key);
+    if (index_.find(key) == index_.end()) {
+      return nullptr;
+    }
+    
+    std::string data;
+    std::unique_ptr<Entry> entry;
+    if (base::ReadFileToStringWithMaxSize(GetEntryPath(key), &data,
+                                          kMaxEntryBytes)) {
+      entry = DecodeEntry(data);
+    }
+    
+    if (!entry) {
+      Remove(key);
+      return nullptr;
+    }
+    
+    Touch(key);
+    return entry;
+  }
+  
+  void Write(const std::string& key,
+             const std::string& alias_key,
+             reading_mode::mojom::ReadingArticlePtr article,
+             base::Time validated_time) {
+    EnsureIndexLoaded();
+    
+    std::string data;
+    if (!EncodeEntry(*article, validated_time, &data) ||
+        static_cast<int64_t>(data.size()) > kMaxEntryBytes) {
+      return;
+    }
+    
+    // An address that was an alias so far gets an entry of its own.
+    RemoveAlias(key);
+    if (!base::ImportantFileWriter::WriteFileAtomically(GetEntryPath(key),
+                                                        data)) {
+      return;
+    }
+    
+    std::vector<std::string> aliases;
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      aliases = std::move(it->second.aliases);
+    }
+    RemoveFromIndex(key);
+    lru_.push_front(key);
+    index_[key] = {static_cast<int64_t>(data.size()), lru_.begin(),
+                   std::move(aliases)};
+    total_bytes_ += data.size();
+    
+    if (!alias_key.empty() && alias_key != key) {
+      AddAlias(alias_key, key);
+    }
+    Evict();
+  }
+  
+  // Removes the entry |key| resolves to, along with all of its aliases.
+  void Remove(const std::string& lookup_key) {
+    EnsureIndexLoaded();
+    std::string key = ResolveAlias(lookup_key);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      for (const std::string& alias_key : it->second.aliases) {
+        aliases_.erase(alias_key);
+        base::DeleteFile(GetAliasPath(alias_key));
+      }
+    }
+    RemoveFromIndex(key);
+    base::DeleteFile(GetEntryPath(key));
+  }
+  
+ private:
+  struct IndexEntry {
+    int64_t size;
+    std::list<std::string>::iterator lru_position;
+    std::vector<std::string> aliases;
+  };
+  
+  void EnsureIndexLoaded() {
+    if (index_loaded_) {
+      return;
+    }
+    index_loaded_ = true;
+    
+    if (!base::CreateDirectory(cache_dir_)) {
+      return;
+    }
+    
+    struct FileRecord {
+      std::string key;
+      int64_t size;
+      base::Time last_used;
+    };
+    std::vector<FileRecord> records;
+    
+    base::FileEnumerator enumerator(
+        cache_dir_, false, base::FileEnumerator::FILES,
+        FILE_PATH_LITERAL("*") + base::FilePath::StringType(kEntryExtension));
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      base::FileEnumerator::FileInfo info = enumerator.GetInfo();
+      records.push_back({path.BaseName().RemoveExtension().MaybeAsASCII(),
+                         info.GetSize(), info.GetLastModifiedTime()});
+    }
+    
+    std::sort(records.begin(), records.end(),
+              [](const FileRecord& a, const FileRecord& b) {
+                return a.last_used > b.last_used;
+              });
+    for (const FileRecord& record : records) {
+      if (record.key.empty()) {
+        continue;
+      }
+      lru_.push_back(record.key);
+      index_[record.key] = {record.size, std::prev(lru_.end())};
+      total_bytes_ += record.size;
+    }
+    
+    base::FileEnumerator alias_enumerator(
+        cache_dir_, false, base::FileEnumerator::FILES,
+        FILE_PATH_LITERAL("*") + base::FilePath::StringType(kAliasExtension));
+    for (base::FilePath path = alias_enumerator.Next(); !path.empty();
+         path = alias_enumerator.Next()) {
+      std::string alias_key = path.BaseName().RemoveExtension().MaybeAsASCII();
+      std::string key;
+      auto it = index_.end();
+      if (base::ReadFileToStringWithMaxSize(path, &key, kMaxAliasBytes)) {
+        it = index_.find(key);
+      }
+      // Aliases outlive their entry only if a removal was cut short.
+      if (alias_key.empty() || it == index_.end() ||
+          index_.count(alias_key)) {
+        base::DeleteFile(path);
+        continue;
+      }
+      aliases_[alias_key] = key;
+      it->second.aliases.push_back(alias_key);
+    }
+    
+    Evict();
+  }
+  
+  std::string ResolveAlias(const std::string& key) const {
+    auto it = aliases_.find(key);
+    return it != aliases_.end() ? it->second : key;
+  }
+  
+  // Points |alias_key| at the entry |key|, replacing whatever was stored
+  // under |alias_key| before.
+  void AddAlias(const std::string& alias_key, const std::string& key) {
+    RemoveAlias(alias_key);
+    if (index_.count(alias_key)) {
+      Remove(alias_key);
+    }
+    if (!base::ImportantFileWriter::WriteFileAtomically(
+            GetAliasPath(alias_key), key)) {
+      return;
+    }
+    aliases_[alias_key] = key;
+    index_[key].aliases.push_back(alias_key);
+  }
+  
+  void RemoveAlias(const std::string& alias_key) {
+    auto it = aliases_.find(alias_key);
+    if (it == aliases_.end()) {
+      return;
+    }
+    auto entry = index_.find(it->second);
+    if (entry != index_.end()) {
+      std::vector<std::string>& aliases = entry->second.aliases;
+      aliases.erase(std::remove(aliases.begin(), aliases.end(), alias_key),
+                    aliases.end());
+    }
+    aliases_.erase(it);
+    base::DeleteFile(GetAliasPath(alias_key));
+  }
+  
+  // Moves |key| to the front of the LRU list. The file's modification time
+  // is updated too, so the order survives a restart.
+  void Touch(const std::string& key) {
+    auto it = index_.find(key);
+    lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+    base::Time now = base::Time::Now();
+    base::TouchFile(GetEntryPath(key), now, now);
+  }
+  
+  void Evict() {
+    while (total_bytes_ > max_bytes_ && !lru_.empty()) {
+      std::string key = lru_.back();
+      Remove(key);
+    }
+  }
+  
+  void RemoveFromIndex(const std::string& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return;
+    }
+    total_bytes_ -= it->second.size;
+    lru_.erase(it->second.lru_position);
+    index_.erase(it);
+  }
+  
+  base::FilePath GetEntryPath(const std::string& key) const {
+    return cache_dir_.AppendASCII(key).AddExtension(kEntryExtension);
+  }
+  
+  base::FilePath GetAliasPath(const std::string& alias_key) const {
+    return cache_dir_.AppendASCII(alias_key).AddExtension(kAliasExtension);
+  }
+  
+  const base::FilePath cache_dir_;
+  const int64_t max_bytes_;
+  
+  bool index_loaded_ = false;
+  // Most recently used first.
+  std::list<std::string> lru_;
+  std::map<std::string, IndexEntry> index_;
+  // Alias key to the key of the entry it points at.
+  std::map<std::string, std::string> aliases_;
+  int64_t total_bytes_ = 0;
+  
+  DISALLOW_COPY_AND_ASSIGN(Backend);
+};
+
+LunetixReadingModeCache::Entry::Entry() = default;
+
+LunetixReadingModeCache::Entry::Entry(Entry&& other) = default;
+
+LunetixReadingModeCache::Entry& LunetixReadingModeCache::Entry::operator=(
+    Entry&& other) = default;
+
+LunetixReadingModeCache::Entry::~Entry() = default;
+
+LunetixReadingModeCache::LunetixReadingModeCache(
+    const base::FilePath& cache_dir)
+    : backend_(base::ThreadPool::CreateSequencedTaskRunner(
+                   {base::MayBlock(), base::TaskPriority::USER_VISIBLE,
+                    base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN}),
+               cache_dir,
+               kMaxCacheBytes) {}
+
+LunetixReadingModeCache::~LunetixReadingModeCache() = default;
+
+void LunetixReadingModeCache::Lookup(const GURL& url,
+                                     LookupCallback callback) {
+  backend_.AsyncCall(&Backend::Read)
+      .WithArgs(GetKey(url))
+      .Then(std::move(callback));
+}
+
+void LunetixReadingModeCache::Store(
+    const GURL& url,
+    const GURL& alias_url,
+    reading_mode::mojom::ReadingArticlePtr article) {
+  if (!article) {
+    return;
+  }
+  backend_.AsyncCall(&Backend::Write)
+      .WithArgs(GetKey(url),
+                alias_url.is_valid() ? GetKey(alias_url) : std::string(),
+                std::move(article), base::Time::Now());
+}
+
+void LunetixReadingModeCache::Remove(const GURL& url) {
+  backend_.AsyncCall(&Backend::Remove).WithArgs(GetKey(url));
+}
+
+// static
+std::string LunetixReadingModeCache::GetKey(const GURL& url) {
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  std::string digest =
+      base::SHA1HashString(url.ReplaceComponents(replacements).spec());
+  return base::HexEncode(digest.data(), digest.size());
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_H_
+#define LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/threading/sequence_bound.h"
+#include "base/time/time.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "lunetix/services/reading_mode/public/mojom/reading_mode_extractor.mojom.h"
+
+class GURL;
+
+namespace lunetix {
+
+// Per-profile disk cache of extracted reading mode articles. Entries hold
+// the article metadata plus gzip-compressed content, are keyed by the URL
+// of the page it was extracted from and verified against a hash of the
+// content.
+// Once the cache outgrows its budget the least recently used entries are
+// evicted. All file work happens on a background sequence.
+class LunetixReadingModeCache : public KeyedService {
+ public:
+  struct Entry {
+    Entry();
+    Entry(Entry&& other);
+    Entry& operator=(Entry&& other);
+    ~Entry();
+    
+    reading_mode::mojom::ReadingArticlePtr article;
+    // When the article was last extracted from a live page.
+    base::Time validated_time;
+  };
+  
+  // |entry| is null when nothing is cached for the URL.
+  using LookupCallback = base::OnceCallback<void(std::unique_ptr<Entry> entry)>;
+  
+  explicit LunetixReadingModeCache(const base::FilePath& cache_dir);
+  ~LunetixReadingModeCache() override;
+  
+  void Lookup(const GURL& url, LookupCallback callback);
+  // Stores |article| under |url|. If |alias_url| is valid, it is pointed at
+  // the same entry, so that loading either address finds the one copy.
+  void Store(const GURL& url,
+             const GURL& alias_url,
+             reading_mode::mojom::ReadingArticlePtr article);
+  // Removes the article found under |url| and every address pointing at it.
+  void Remove(const GURL& url);
+  
+ private:
+  class Backend;
+  
+  // Hex digest of |url| without its fragment. Also used as the file name.
+  static std::string GetKey(const GURL& url);
+  
+  base::SequenceBound<Backend> backend_;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixReadingModeCache);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_H_
\ No newline at end of file
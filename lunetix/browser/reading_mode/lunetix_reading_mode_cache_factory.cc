@@ -0,0 +1,42 @@
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache_factory.h"
+
+#include "base/memory/singleton.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "content/public/browser/browser_context.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache.h"
+
+namespace lunetix {
+
+namespace {
+
+const base::FilePath::CharType kReaderCacheDirname[] =
+    FILE_PATH_LITERAL("Lunetix Reader Cache");
+
+}  // namespace
+
+// static
+LunetixReadingModeCache* LunetixReadingModeCacheFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<LunetixReadingModeCache*>(
+      GetInstance()->GetServiceForBrowserContext(context, true));
+}
+
+// static
+LunetixReadingModeCacheFactory* LunetixReadingModeCacheFactory::GetInstance() {
+  return base::Singleton<LunetixReadingModeCacheFactory>::get();
+}
+
+LunetixReadingModeCacheFactory::LunetixReadingModeCacheFactory()
+    : BrowserContextKeyedServiceFactory(
+          "LunetixReadingModeCache",
+          BrowserContextDependencyManager::GetInstance()) {}
+
+LunetixReadingModeCacheFactory::~LunetixReadingModeCacheFactory() = default;
+
+KeyedService* LunetixReadingModeCacheFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new LunetixReadingModeCache(
+      context->GetPath().Append(kReaderCacheDirname));
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_FACTORY_H_
+#define LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_FACTORY_H_
+
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}
+
+namespace content {
+class BrowserContext;
+}
+
+namespace lunetix {
+
+class LunetixReadingModeCache;
+
+// Off-the-record profiles get no cache, so nothing they read is persisted.
+class LunetixReadingModeCacheFactory
+    : public BrowserContextKeyedServiceFactory {
+ public:
+  static LunetixReadingModeCache* GetForBrowserContext(
+      content::BrowserContext* context);
+  static LunetixReadingModeCacheFactory* GetInstance();
+  
+ private:
+  friend struct base::DefaultSingletonTraits<LunetixReadingModeCacheFactory>;
+  
+  LunetixReadingModeCacheFactory();
+  ~LunetixReadingModeCacheFactory() override;
+  
+  // BrowserContextKeyedServiceFactory overrides:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixReadingModeCacheFactory);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_CACHE_FACTORY_H_
\ No newline at end of file
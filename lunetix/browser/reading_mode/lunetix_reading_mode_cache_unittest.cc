@@ -0,0 +1,104 @@
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_cache.h"
+
+#include <memory>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+class LunetixReadingModeCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    cache_ = std::make_unique<LunetixReadingModeCache>(temp_dir_.GetPath());
+  }
+  
+  reading_mode::mojom::ReadingArticlePtr CreateArticle() {
+    auto article = reading_mode::mojom::ReadingArticle::New();
+    article->title = "Why the Moon Drifts Away";
+    article->content = "<p>The Moon moves away from Earth every year.</p>";
+    article->word_count = 9;
+    article->reading_time_minutes = 1;
+    article->chunk_offsets = {0};
+    return article;
+  }
+  
+  std::unique_ptr<LunetixReadingModeCache::Entry> Lookup(const GURL& url) {
+    std::unique_ptr<LunetixReadingModeCache::Entry> result;
+    base::RunLoop run_loop;
+    cache_->Lookup(
+        url, base::BindOnce(
+                 [](base::OnceClosure quit,
+                    std::unique_ptr<LunetixReadingModeCache::Entry>* result,
+                    std::unique_ptr<LunetixReadingModeCache::Entry> entry) {
+                   *result = std::move(entry);
+                   std::move(quit).Run();
+                 },
+                 run_loop.QuitClosure(), &result));
+    run_loop.Run();
+    return result;
+  }
+  
+  int CountArticleFiles() {
+    base::FileEnumerator enumerator(temp_dir_.GetPath(), false,
+                                    base::FileEnumerator::FILES,
+                                    FILE_PATH_LITERAL("*.article"));
+    int count = 0;
+    for (base::FilePath path = enumerator.Next(); !path.empty();
+         path = enumerator.Next()) {
+      ++count;
+    }
+    return count;
+  }
+  
+  base::test::TaskEnvironment task_environment_;
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<LunetixReadingModeCache> cache_;
+};
+
+TEST_F(LunetixReadingModeCacheTest, FindsArticleUnderUrlAndAlias) {
+  GURL url("https://news.example/story?utm_source=feed");
+  GURL alias_url("https://news.example/story");
+  cache_->Store(url, alias_url, CreateArticle());
+  
+  std::unique_ptr<LunetixReadingModeCache::Entry> entry = Lookup(url);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("Why the Moon Drifts Away", entry->article->title);
+  
+  entry = Lookup(alias_url);
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(CreateArticle()->content, entry->article->content);
+  
+  EXPECT_FALSE(Lookup(GURL("https://news.example/other")));
+}
+
+TEST_F(LunetixReadingModeCacheTest, StoresAliasedArticleOnce) {
+  GURL url("https://news.example/story?utm_source=feed");
+  GURL alias_url("https://news.example/story");
+  cache_->Store(url, alias_url, CreateArticle());
+  ASSERT_TRUE(Lookup(url));
+  EXPECT_EQ(1, CountArticleFiles());
+  
+  // The alias is picked up again from disk.
+  cache_ = std::make_unique<LunetixReadingModeCache>(temp_dir_.GetPath());
+  EXPECT_TRUE(Lookup(alias_url));
+  
+  // Removing either address removes the article for both.
+  cache_->Remove(alias_url);
+  EXPECT_FALSE(Lookup(url));
+  EXPECT_FALSE(Lookup(alias_url));
+  EXPECT_EQ(0, CountArticleFiles());
+}
+
+TEST_F(LunetixReadingModeCacheTest, IgnoresFragment) {
+  cache_->Store(GURL("https://news.example/story"), GURL(), CreateArticle());
+  EXPECT_TRUE(Lookup(GURL("https://news.example/story#comments")));
+}
+
+}  // namespace lunetix
\ No newline at end of file
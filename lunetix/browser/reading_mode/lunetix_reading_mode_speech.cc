@@ -0,0 +1,275 @@
+#include "lunetix/browser/reading_mode/lunetix_reading_mode_speech.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/i18n/break_iterator.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+#include "content/public/browser/tts_controller.h"
+#include "content/public/browser/web_contents.h"
+
+namespace lunetix {
+
+namespace {
+
+// Utterances queued ahead of the one being spoken.
+constexpr size_t kLookaheadUtterances = 3;
+
+// Closing tags after which a sentence always ends, even without
+// punctuation, e.g. headings and list items.
+const char* const kSentenceEndingTags[] = {
+    "p",  "h1", "h2", "h3", "h4",         "h5",      "h6",
+    "li", "dt", "dd", "blockquote", "pre", "figcaption", "caption",
+    "td", "th",
+};
+
+bool IsSentenceEndingTag(base::StringPiece tag) {
+  for (const char* ending_tag : kSentenceEndingTags) {
+    if (tag == ending_tag) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Converts a sanitized chunk to the text the reader shows for it, so the
+// UTF-16 offsets line up with the chunk's DOM text. Block ends are
+// recorded as forced sentence boundaries.
+void ExtractChunkText(base::StringPiece html,
+                      std::u16string* text,
+                      std::vector<size_t>* block_ends) {
+  std::string run;
+  auto flush = [&]() {
+    text->append(base::UTF8ToUTF16(run));
+    run.clear();
+  };
+  
+  size_t pos = 0;
+  while (pos < html.size()) {
+    char c = html[pos];
+    if (c == '<') {
+      size_t close = html.find('>', pos);
+      if (close == base::StringPiece::npos) {
+        break;
+      }
+      base::StringPiece tag = html.substr(pos + 1, close - pos - 1);
+      if (!tag.empty() && tag[0] == '/' &&
+          IsSentenceEndingTag(tag.substr(1))) {
+        flush();
+        block_ends->push_back(text->size());
+      }
+      pos = close + 1;
+    } else if (c == '&') {
+      // The sanitizer only ever escapes these three.
+      if (html.substr(pos, 5) == "&amp;") {
+        run.push_back('&');
+        pos += 5;
+      } else if (html.substr(pos, 4) == "&lt;") {
+        run.push_back('<');
+        pos += 4;
+      } else if (html.substr(pos, 4) == "&gt;") {
+        run.push_back('>');
+        pos += 4;
+      } else {
+        run.push_back(c);
+        ++pos;
+      }
+    } else {
+      run.push_back(c);
+      ++pos;
+    }
+  }
+  flush();
+  block_ends->push_back(text->size());
+}
+
+}  // namespace
+
+LunetixReadingModeSpeech::LunetixReadingModeSpeech(
+    content::WebContents* reader_contents,
+    const LunetixReadingMode::ReadingContent& content,
+    HighlightCallback highlight_callback)
+    : content::WebContentsObserver(reader_contents),
+      content_(content),
+      highlight_callback_(std::move(highlight_callback)) {}
+
+LunetixReadingModeSpeech::~LunetixReadingModeSpeech() {
+  Stop();
+  // Stop() leaves utterances the backend has not started yet queued, still
+  // pointing at this delegate.
+  content::TtsController::GetInstance()->RemoveUtteranceEventDelegate(this);
+}
+
+void LunetixReadingModeSpeech::Start() {
+  if (speaking_) {
+    return;
+  }
+  
+  speaking_ = true;
+  paused_for_visibility_ =
+      web_contents()->GetVisibility() == content::Visibility::HIDDEN;
+  if (!paused_for_visibility_) {
+    FillPipeline();
+  }
+}
+
+void LunetixReadingModeSpeech::Stop() {
+  if (!speaking_) {
+    return;
+  }
+  
+  speaking_ = false;
+  paused_for_visibility_ = false;
+  Interrupt();
+  pending_.clear();
+  next_chunk_ = 0;
+}
+
+void LunetixReadingModeSpeech::OnTtsEvent(content::TtsUtterance* utterance,
+                                          content::TtsEventType event_type,
+                                          int char_index,
+                                          int length,
+                                          const std::string& error_message) {
+  auto it = in_flight_.find(utterance->GetId());
+  if (it == in_flight_.end()) {
+    return;
+  }
+  
+  switch (event_type) {
+    case content::TTS_EVENT_START:
+      highlight_callback_.Run(it->second.chunk_index, it->second.start,
+                              it->second.end);
+      break;
+    case content::TTS_EVENT_END:
+    case content::TTS_EVENT_ERROR:
+      in_flight_.erase(it);
+      FillPipeline();
+      if (in_flight_.empty() && pending_.empty()) {
+        // Reached the end of the article.
+        speaking_ = false;
+        next_chunk_ = 0;
+      }
+      break;
+    case content::TTS_EVENT_INTERRUPTED:
+    case content::TTS_EVENT_CANCELLED:
+      in_flight_.erase(it);
+      break;
+    default:
+      break;
+  }
+}
+
+void LunetixReadingModeSpeech::OnVisibilityChanged(
+    content::Visibility visibility) {
+  if (!speaking_) {
+    return;
+  }
+  
+  bool hidden = visibility == content::Visibility::HIDDEN;
+  if (hidden == paused_for_visibility_) {
+    return;
+  }
+  
+  paused_for_visibility_ = hidden;
+  if (hidden) {
+    Interrupt();
+  } else {
+    FillPipeline();
+  }
+}
+
+bool LunetixReadingModeSpeech::LoadNextChunk() {
+  const std::vector<size_t>& offsets = content_.chunk_offsets;
+  if (next_chunk_ >= offsets.size()) {
+    return false;
+  }
+  
+  size_t chunk_index = next_chunk_++;
+  size_t begin = std::min(offsets[chunk_index], content_.content.size());
+  size_t end = chunk_index + 1 < offsets.size()
+                   ? std::min(offsets[chunk_index + 1], content_.content.size())
+                   : content_.content.size();
+  
+  std::u16string text;
+  std::vector<size_t> block_ends;
+  base::StringPiece html = base::StringPiece(content_.content)
+                              .substr(begin, std::max(begin, end) - begin);
+  ExtractChunkText(html, &text, &block_ends);
+  
+  base::i18n::BreakIterator iter(text,
+                                 base::i18n::BreakIterator::BREAK_SENTENCE);
+  if (!iter.Init()) {
+    return true;
+  }
+  
+  size_t block = 0;
+  size_t sentence_start = 0;
+  auto add_sentence = [&](size_t start, size_t end) {
+    std::u16string sentence;
+    base::TrimWhitespace(text.substr(start, end - start), base::TRIM_ALL,
+                         &sentence);
+    if (!sentence.empty()) {
+      pending_.push_back({chunk_index, static_cast<int>(start),
+                          static_cast<int>(end), std::move(sentence)});
+    }
+  };
+  
+  while (iter.Advance()) {
+    size_t sentence_end = iter.pos();
+    // Break at block ends the iterator does not see, e.g. after a heading
+    // that runs straight into the next paragraph.
+    while (block < block_ends.size() && block_ends[block] < sentence_end) {
+      if (block_ends[block] > sentence_start) {
+        add_sentence(sentence_start, block_ends[block]);
+        sentence_start = block_ends[block];
+      }
+      ++block;
+    }
+    add_sentence(sentence_start, sentence_end);
+    sentence_start = sentence_end;
+  }
+  return true;
+}
+
+void LunetixReadingModeSpeech::FillPipeline() {
+  if (!speaking_ || paused_for_visibility_) {
+    return;
+  }
+  
+  content::TtsController* controller = content::TtsController::GetInstance();
+  while (in_flight_.size() < kLookaheadUtterances) {
+    if (pending_.empty() && !LoadNextChunk()) {
+      return;
+    }
+    if (pending_.empty()) {
+      continue;
+    }
+    
+    Sentence sentence = std::move(pending_.front());
+    pending_.pop_front();
+    
+    std::unique_ptr<content::TtsUtterance> utterance =
+        content::TtsUtterance::Create(web_contents());
+    utterance->SetText(base::UTF16ToUTF8(sentence.text));
+    utterance->SetSrcUrl(web_contents()->GetLastCommittedURL());
+    utterance->SetCanEnqueue(true);
+    utterance->SetEventDelegate(this);
+    
+    int id = utterance->GetId();
+    in_flight_.emplace(id, std::move(sentence));
+    controller->SpeakOrEnqueue(std::move(utterance));
+  }
+}
+
+void LunetixReadingModeSpeech::Interrupt() {
+  // Put the queued sentences back in order, the interrupted one first.
+  for (auto it = in_flight_.rbegin(); it != in_flight_.rend(); ++it) {
+    pending_.push_front(std::move(it->second));
+  }
+  in_flight_.clear();
+  content::TtsController::GetInstance()->Stop(
+      web_contents()->GetLastCommittedURL());
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,80 @@
+#ifndef LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_SPEECH_H_
+#define LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_SPEECH_H_
+
+#include <deque>
+#include <map>
+#include <string>
+
+#include "base/callback.h"
+#include "content/public/browser/tts_utterance.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
+
+namespace lunetix {
+
+// Reads an extracted article aloud. Chunks are split into sentences only
+// when the pipeline reaches them and just a few utterances are queued with
+// the speech backend at a time, so startup cost does not depend on the
+// article length. Speech stops while the reader is hidden and picks up at
+// the interrupted sentence when it becomes visible again.
+class LunetixReadingModeSpeech : public content::WebContentsObserver,
+                                 public content::UtteranceEventDelegate {
+ public:
+  // Called with the chunk and UTF-16 range of the sentence being spoken.
+  using HighlightCallback =
+      base::RepeatingCallback<void(size_t chunk_index, int start, int end)>;
+  
+  // |content| must outlive this object.
+  LunetixReadingModeSpeech(
+      content::WebContents* reader_contents,
+      const LunetixReadingMode::ReadingContent& content,
+      HighlightCallback highlight_callback);
+  ~LunetixReadingModeSpeech() override;
+  
+  void Start();
+  void Stop();
+  bool IsSpeaking() const { return speaking_; }
+  
+  // content::UtteranceEventDelegate overrides:
+  void OnTtsEvent(content::TtsUtterance* utterance,
+                  content::TtsEventType event_type,
+                  int char_index,
+                  int length,
+                  const std::string& error_message) override;
+  
+  // content::WebContentsObserver overrides:
+  void OnVisibilityChanged(content::Visibility visibility) override;
+  
+ private:
+  struct Sentence {
+    size_t chunk_index;
+    int start;
+    int end;
+    std::u16string text;
+  };
+  
+  // Splits the next chunk into sentences. Returns false at the end.
+  bool LoadNextChunk();
+  // Queues sentences until the lookahead is full.
+  void FillPipeline();
+  // Cancels queued utterances, keeping their sentences for later.
+  void Interrupt();
+  
+  const LunetixReadingMode::ReadingContent& content_;
+  HighlightCallback highlight_callback_;
+  
+  bool speaking_ = false;
+  bool paused_for_visibility_ = false;
+  size_t next_chunk_ = 0;
+  
+  // Split but not yet handed to the speech backend.
+  std::deque<Sentence> pending_;
+  // Handed to the backend, keyed by utterance id in speaking order.
+  std::map<int, Sentence> in_flight_;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixReadingModeSpeech);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_READING_MODE_LUNETIX_READING_MODE_SPEECH_H_
\ No newline at end of file
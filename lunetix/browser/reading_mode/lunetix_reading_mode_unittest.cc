@@ -0,0 +1,107 @@
+#include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
+
+#include <limits>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+// Pages scoring at least this are offered reading mode.
+constexpr float kReadableScore = 0.5f;
+
+mojom::ReadabilitySignals MakeSignals(uint32_t paragraph_count,
+                                      uint32_t word_count,
+                                      float link_density) {
+  mojom::ReadabilitySignals signals;
+  signals.paragraph_count = paragraph_count;
+  signals.word_count = word_count;
+  signals.link_density = link_density;
+  return signals;
+}
+
+}  // namespace
+
+TEST(LunetixReadingModeTest, UsesSameOriginCanonicalUrl) {
+  GURL page_url("https://news.example/story?utm_source=feed");
+  EXPECT_EQ(GURL("https://news.example/story"),
+            LunetixReadingMode::GetCanonicalUrl(
+                page_url, "https://news.example/story"));
+}
+
+TEST(LunetixReadingModeTest, IgnoresCrossOriginCanonicalUrl) {
+  GURL page_url("https://attacker.example/story");
+  EXPECT_TRUE(LunetixReadingMode::GetCanonicalUrl(
+                  page_url, "https://bank.example/account")
+                  .is_empty());
+  EXPECT_TRUE(LunetixReadingMode::GetCanonicalUrl(
+                  page_url, "https://www.attacker.example/story")
+                  .is_empty());
+  EXPECT_TRUE(LunetixReadingMode::GetCanonicalUrl(
+                  page_url, "http://attacker.example/story")
+                  .is_empty());
+}
+
+TEST(LunetixReadingModeTest, IgnoresInvalidCanonicalUrl) {
+  GURL page_url("https://news.example/story");
+  EXPECT_TRUE(LunetixReadingMode::GetCanonicalUrl(page_url, "").is_empty());
+  EXPECT_TRUE(
+      LunetixReadingMode::GetCanonicalUrl(page_url, "javascript:alert(1)")
+          .is_empty());
+}
+
+TEST(LunetixReadingModeTest, ScoresLongArticleAsReadable) {
+  mojom::ReadabilitySignals signals = MakeSignals(20, 1500, 0.05f);
+  EXPECT_GE(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+}
+
+TEST(LunetixReadingModeTest, ScoresLinkHeavyIndexAsUnreadable) {
+  // Lots of teaser text, mostly links, each teaser in its own <article>.
+  mojom::ReadabilitySignals signals = MakeSignals(20, 1500, 0.8f);
+  signals.has_article_element = true;
+  EXPECT_LT(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+}
+
+TEST(LunetixReadingModeTest, ScoresShortPageAsUnreadable) {
+  mojom::ReadabilitySignals signals = MakeSignals(2, 150, 0.0f);
+  EXPECT_LT(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+  
+  // Markup alone does not make a short page an article.
+  signals.has_article_element = true;
+  signals.has_article_schema = true;
+  signals.has_open_graph_article = true;
+  EXPECT_LT(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+}
+
+TEST(LunetixReadingModeTest, ArticleMarkupTipsMediumPage) {
+  mojom::ReadabilitySignals signals = MakeSignals(5, 600, 0.1f);
+  EXPECT_LT(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+  
+  signals.has_article_schema = true;
+  signals.has_open_graph_article = true;
+  EXPECT_GE(LunetixReadingMode::ComputeReadabilityScore(signals),
+            kReadableScore);
+}
+
+TEST(LunetixReadingModeTest, KeepsScoreInRange) {
+  mojom::ReadabilitySignals signals = MakeSignals(100, 10000, -1.0f);
+  signals.has_article_element = true;
+  signals.has_article_schema = true;
+  signals.has_open_graph_article = true;
+  EXPECT_EQ(1.0f, LunetixReadingMode::ComputeReadabilityScore(signals));
+  
+  // Signals come from the renderer and are not trusted.
+  signals = MakeSignals(100, 10000, std::numeric_limits<float>::quiet_NaN());
+  EXPECT_EQ(0.0f, LunetixReadingMode::ComputeReadabilityScore(signals));
+  signals.link_density = 7.0f;
+  EXPECT_EQ(0.0f, LunetixReadingMode::ComputeReadabilityScore(signals));
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include "lunetix/browser/tab_search/lunetix_tab_search_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "base/i18n/case_conversion.h"
+#include "base/strings/string_util.h"
+#include "base/strings/utf_string_conversions.h"
+
+namespace lunetix {
+
+namespace {
+
+// Queries walk at most this many posting lists, those of their rarest
+// trigrams, which bounds the cost of long queries. Trigrams no tab has are
+// never walked but still count against the overlap.
+constexpr size_t kMaxQueryTrigrams = 12;
+
+// A fuzzy match must share at least this fraction of the query trigrams.
+constexpr float kMinTrigramOverlap = 0.6f;
+
+constexpr float kSubstringBonus = 1.0f;
+constexpr float kTitleBonus = 0.5f;
+constexpr float kWordStartBonus = 0.25f;
+constexpr float kWorkspaceBonus = 0.1f;
+
+constexpr char kFieldSeparator = '\n';
+
+// Scheme and "www." carry no meaning for search but would put the same
+// trigrams into every posting list.
+base::StringPiece StripUrlNoise(base::StringPiece url) {
+  for (base::StringPiece prefix : {"https://", "http://"}) {
+    if (base::StartsWith(url, prefix)) {
+      url.remove_prefix(prefix.size());
+      break;
+    }
+  }
+  if (base::StartsWith(url, "www.")) {
+    url.remove_prefix(4);
+  }
+  return url;
+}
+
+std::string Fold(base::StringPiece16 text) {
+  return base::UTF16ToUTF8(base::i18n::ToLower(text));
+}
+
+uint32_t MakeTrigram(const char* text) {
+  return (static_cast<uint32_t>(static_cast<uint8_t>(text[0])) << 16) |
+         (static_cast<uint32_t>(static_cast<uint8_t>(text[1])) << 8) |
+         static_cast<uint32_t>(static_cast<uint8_t>(text[2]));
+}
+
+// Trigrams never span the separator between fields.
+std::vector<uint32_t> ExtractTrigrams(base::StringPiece text) {
+  std::vector<uint32_t> trigrams;
+  for (size_t i = 0; i + 3 <= text.size(); ++i) {
+    if (text[i] == kFieldSeparator || text[i + 1] == kFieldSeparator ||
+        text[i + 2] == kFieldSeparator) {
+      continue;
+    }
+    trigrams.push_back(MakeTrigram(text.data() + i));
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+  return trigrams;
+}
+
+bool IsWordStart(base::StringPiece text, size_t position) {
+  if (position == 0) {
+    return true;
+  }
+  char previous = text[position - 1];
+  return !base::IsAsciiAlpha(previous) && !base::IsAsciiDigit(previous);
+}
+
+}  // namespace
+
+LunetixTabSearchIndex::Document::Document() = default;
+
+LunetixTabSearchIndex::Document::Document(Document&& other) = default;
+
+LunetixTabSearchIndex::Document& LunetixTabSearchIndex::Document::operator=(
+    Document&& other) = default;
+
+LunetixTabSearchIndex::Document::~Document() = default;
+
+LunetixTabSearchIndex::LunetixTabSearchIndex() = default;
+
+LunetixTabSearchIndex::~LunetixTabSearchIndex() = default;
+
+void LunetixTabSearchIndex::Update(int tab_id,
+                                   base::StringPiece16 title,
+                                   base::StringPiece url,
+                                   base::StringPiece16 workspace_name) {
+  Document document;
+  document.text = Fold(title);
+  document.title_end = document.text.size();
+  document.text.push_back(kFieldSeparator);
+  document.text.append(base::ToLowerASCII(StripUrlNoise(url)));
+  document.url_end = document.text.size();
+  document.text.push_back(kFieldSeparator);
+  document.text.append(Fold(workspace_name));
+  
+  Document& current = documents_[tab_id];
+  if (current.text == document.text) {
+    return;
+  }
+  document.trigrams = ExtractTrigrams(document.text);
+  
+  // Title changes usually keep most trigrams, so only the difference
+  // touches the posting lists.
+  std::vector<uint32_t> removed;
+  std::set_difference(current.trigrams.begin(), current.trigrams.end(),
+                      document.trigrams.begin(), document.trigrams.end(),
+                      std::back_inserter(removed));
+  std::vector<uint32_t> added;
+  std::set_difference(document.trigrams.begin(), document.trigrams.end(),
+                      current.trigrams.begin(), current.trigrams.end(),
+                      std::back_inserter(added));
+  for (uint32_t trigram : removed) {
+    RemovePosting(trigram, tab_id);
+  }
+  for (uint32_t trigram : added) {
+    AddPosting(trigram, tab_id);
+  }
+  
+  current = std::move(document);
+}
+
+void LunetixTabSearchIndex::Remove(int tab_id) {
+  auto it = documents_.find(tab_id);
+  if (it == documents_.end()) {
+    return;
+  }
+  for (uint32_t trigram : it->second.trigrams) {
+    RemovePosting(trigram, tab_id);
+  }
+  documents_.erase(it);
+}
+
+std::vector<LunetixTabSearchIndex::Result> LunetixTabSearchIndex::Search(
+    base::StringPiece16 query,
+    size_t max_results) const {
+  std::vector<Result> results;
+  std::string folded = Fold(base::TrimWhitespace(query, base::TRIM_ALL));
+  if (folded.empty() || !max_results) {
+    return results;
+  }
+  
+  std::unordered_map<int, int> hits;
+  float query_trigram_count = 0;
+  if (folded.size() < 3) {
+    // Too short for trigrams; a scan for the substring is cheap enough.
+    for (const auto& entry : documents_) {
+      if (entry.second.text.find(folded) != std::string::npos) {
+        hits[entry.first] = 1;
+      }
+    }
+    query_trigram_count = 1;
+  } else {
+    std::vector<uint32_t> trigrams = ExtractTrigrams(folded);
+    std::vector<const std::vector<int>*> postings;
+    for (uint32_t trigram : trigrams) {
+      auto it = postings_.find(trigram);
+      if (it != postings_.end()) {
+        postings.push_back(&it->second);
+      }
+    }
+    if (postings.empty()) {
+      return results;
+    }
+    
+    // Typos make up trigrams no tab has. They must not take the place of
+    // the rare trigrams that narrow down the candidates.
+    size_t known_trigram_count = postings.size();
+    if (postings.size() > kMaxQueryTrigrams) {
+      std::partial_sort(postings.begin(), postings.begin() + kMaxQueryTrigrams,
+                        postings.end(),
+                        [](const std::vector<int>* a,
+                           const std::vector<int>* b) {
+                          return a->size() < b->size();
+                        });
+      postings.resize(kMaxQueryTrigrams);
+    }
+    for (const std::vector<int>* posting : postings) {
+      for (int tab_id : *posting) {
+        ++hits[tab_id];
+      }
+    }
+    
+    // Hits are counted over the walked trigrams only, so scale the whole
+    // query, unknown trigrams included, down to that sample.
+    query_trigram_count = static_cast<float>(postings.size()) *
+                          trigrams.size() / known_trigram_count;
+  }
+  
+  const int min_hits = std::max(
+      1, static_cast<int>(kMinTrigramOverlap * query_trigram_count + 0.5f));
+  for (const auto& hit : hits) {
+    if (hit.second < min_hits) {
+      continue;
+    }
+    const Document& document = documents_.at(hit.first);
+    float score = static_cast<float>(hit.second) / query_trigram_count;
+    
+    size_t position = document.text.find(folded);
+    if (position != std::string::npos) {
+      score += kSubstringBonus;
+      if (position < document.title_end) {
+        score += kTitleBonus;
+      } else if (position > document.url_end) {
+        score += kWorkspaceBonus;
+      }
+      if (IsWordStart(document.text, position)) {
+        score += kWordStartBonus;
+      }
+    }
+    results.push_back({hit.first, score});
+  }
+  
+  auto by_score = [](const Result& a, const Result& b) {
+    return a.score != b.score ? a.score > b.score : a.tab_id < b.tab_id;
+  };
+  if (results.size() > max_results) {
+    std::partial_sort(results.begin(), results.begin() + max_results,
+                      results.end(), by_score);
+    results.resize(max_results);
+  } else {
+    std::sort(results.begin(), results.end(), by_score);
+  }
+  return results;
+}
+
+void LunetixTabSearchIndex::AddPosting(uint32_t trigram, int tab_id) {
+  std::vector<int>& posting = postings_[trigram];
+  posting.insert(std::lower_bound(posting.begin(), posting.end(), tab_id),
+                 tab_id);
+}
+
+void LunetixTabSearchIndex::RemovePosting(uint32_t trigram, int tab_id) {
+  auto it = postings_.find(trigram);
+  if (it == postings_.end()) {
+    return;
+  }
+  std::vector<int>& posting = it->second;
+  auto position = std::lower_bound(posting.begin(), posting.end(), tab_id);
+  if (position != posting.end() && *position == tab_id) {
+    posting.erase(position);
+  }
+  if (posting.empty()) {
+    postings_.erase(it);
+  }
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,70 @@
+#ifndef LUNETIX_BROWSER_TAB_SEARCH_LUNETIX_TAB_SEARCH_INDEX_H_
+#define LUNETIX_BROWSER_TAB_SEARCH_LUNETIX_TAB_SEARCH_INDEX_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+
+namespace lunetix {
+
+// In-memory trigram index over the title, URL and workspace name of every
+// open tab. Text is case folded and split into overlapping three byte
+// trigrams, each with a sorted posting list of tab ids. A query only visits
+// the postings of its own trigrams, so it stays fast with thousands of
+// tabs, and updates only touch the trigrams that changed.
+class LunetixTabSearchIndex {
+ public:
+  struct Result {
+    int tab_id;
+    float score;
+  };
+  
+  LunetixTabSearchIndex();
+  ~LunetixTabSearchIndex();
+  
+  // Indexes a tab, replacing what was indexed for |tab_id| before.
+  void Update(int tab_id,
+              base::StringPiece16 title,
+              base::StringPiece url,
+              base::StringPiece16 workspace_name);
+  void Remove(int tab_id);
+  
+  // Best matches first. Tabs that contain the query verbatim rank above
+  // fuzzy matches that only share most of its trigrams, and title matches
+  // rank above URL and workspace matches.
+  std::vector<Result> Search(base::StringPiece16 query,
+                             size_t max_results) const;
+  
+  size_t size() const { return documents_.size(); }
+  
+ private:
+  struct Document {
+    Document();
+    Document(Document&& other);
+    Document& operator=(Document&& other);
+    ~Document();
+    
+    // Folded "title \n url \n workspace".
+    std::string text;
+    size_t title_end = 0;
+    size_t url_end = 0;
+    // Sorted and unique.
+    std::vector<uint32_t> trigrams;
+  };
+  
+  void AddPosting(uint32_t trigram, int tab_id);
+  void RemovePosting(uint32_t trigram, int tab_id);
+  
+  std::unordered_map<int, Document> documents_;
+  std::unordered_map<uint32_t, std::vector<int>> postings_;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixTabSearchIndex);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_TAB_SEARCH_LUNETIX_TAB_SEARCH_INDEX_H_
\ No newline at end of file
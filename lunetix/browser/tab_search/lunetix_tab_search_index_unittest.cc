@@ -0,0 +1,118 @@
+#include "lunetix/browser/tab_search/lunetix_tab_search_index.h"
+
+#include "base/strings/utf_string_conversions.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace lunetix {
+
+class LunetixTabSearchIndexTest : public testing::Test {
+ protected:
+  void Add(int tab_id,
+           const char* title,
+           const char* url,
+           const char* workspace = "") {
+    index_.Update(tab_id, base::UTF8ToUTF16(title), url,
+                  base::UTF8ToUTF16(workspace));
+  }
+
+  std::vector<int> Search(const char* query, size_t max_results = 10) {
+    std::vector<int> tab_ids;
+    for (const auto& result :
+         index_.Search(base::UTF8ToUTF16(query), max_results)) {
+      tab_ids.push_back(result.tab_id);
+    }
+    return tab_ids;
+  }
+
+  LunetixTabSearchIndex index_;
+};
+
+TEST_F(LunetixTabSearchIndexTest, FindsTitleUrlAndWorkspace) {
+  Add(1, "Quarterly Report - Docs", "https://docs.example/report", "Work");
+  Add(2, "Cat videos", "https://www.video.example/cats", "Fun");
+  Add(3, "Inbox", "https://mail.example/inbox", "Work");
+
+  EXPECT_EQ(Search("quarterly"), std::vector<int>({1}));
+  EXPECT_EQ(Search("video.example"), std::vector<int>({2}));
+  EXPECT_EQ(Search("work"), std::vector<int>({1, 3}));
+  EXPECT_TRUE(Search("nothing like this").empty());
+}
+
+TEST_F(LunetixTabSearchIndexTest, IsCaseInsensitive) {
+  Add(1, "GitHub Pull Requests", "https://github.example/pulls");
+  EXPECT_EQ(Search("PULL req"), std::vector<int>({1}));
+}
+
+TEST_F(LunetixTabSearchIndexTest, ToleratesTypos) {
+  Add(1, "Kubernetes documentation", "https://k8s.example/docs");
+  Add(2, "Weather forecast", "https://weather.example");
+  EXPECT_EQ(Search("kubernets documentation"), std::vector<int>({1}));
+}
+
+TEST_F(LunetixTabSearchIndexTest, ToleratesTyposInLongQueries) {
+  Add(1, "Kubernetes deployment strategies and rollback documentation",
+      "https://k8s.example/docs/deployments");
+  for (int i = 2; i < 40; ++i) {
+    Add(i, "Deployment documentation", "https://docs.example/service");
+  }
+  // Misspellings make up more trigrams than a query walks. They must not
+  // crowd out the rare trigrams only the first tab has.
+  std::vector<int> results =
+      Search("kubernetse deploymnet stratgeies rolbakc documentaiton");
+  ASSERT_FALSE(results.empty());
+  EXPECT_EQ(results.front(), 1);
+}
+
+TEST_F(LunetixTabSearchIndexTest, RanksExactTitleMatchesFirst) {
+  Add(1, "Travel plans", "https://notes.example/maps");
+  Add(2, "Maps", "https://maps.example");
+  Add(3, "Mapping tools", "https://tools.example");
+
+  std::vector<int> results = Search("maps");
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_EQ(results[0], 2);
+  EXPECT_EQ(results[1], 1);
+  EXPECT_EQ(results[2], 3);
+}
+
+TEST_F(LunetixTabSearchIndexTest, IgnoresSchemeAndWww) {
+  Add(1, "Home", "https://www.example.com/");
+  Add(2, "Other", "https://other.example/");
+  EXPECT_TRUE(Search("https").empty());
+  EXPECT_TRUE(Search("www").empty());
+}
+
+TEST_F(LunetixTabSearchIndexTest, ShortQueriesScan) {
+  Add(1, "Go playground", "https://go.example");
+  Add(2, "Rust book", "https://rust.example");
+  EXPECT_EQ(Search("go"), std::vector<int>({1}));
+  EXPECT_EQ(Search("ru"), std::vector<int>({2}));
+}
+
+TEST_F(LunetixTabSearchIndexTest, UpdateReplacesOldText) {
+  Add(1, "Loading...", "https://news.example");
+  Add(1, "Morning headlines", "https://news.example");
+  EXPECT_TRUE(Search("loading").empty());
+  EXPECT_EQ(Search("headlines"), std::vector<int>({1}));
+  EXPECT_EQ(index_.size(), 1u);
+}
+
+TEST_F(LunetixTabSearchIndexTest, RemoveDropsTab) {
+  Add(1, "Shopping list", "https://list.example");
+  Add(2, "Shopping cart", "https://cart.example");
+  index_.Remove(1);
+  index_.Remove(42);
+  EXPECT_EQ(Search("shopping"), std::vector<int>({2}));
+  EXPECT_EQ(index_.size(), 1u);
+}
+
+TEST_F(LunetixTabSearchIndexTest, LimitsResults) {
+  for (int i = 0; i < 100; ++i) {
+    Add(i, "Search result page", "https://search.example");
+  }
+  std::vector<int> results = Search("result", 5);
+  EXPECT_EQ(results, std::vector<int>({0, 1, 2, 3, 4}));
+  EXPECT_TRUE(Search("result", 0).empty());
+}
+
+}  // namespace lunetix
\ No newline at end of file
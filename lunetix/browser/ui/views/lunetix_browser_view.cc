@@ -2,14 +2,18 @@
 
 #include "chrome/browser/ui/browser.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/browser/ui/views/frame/contents_web_view.h"
 #include "lunetix/common/lunetix_constants.h"
+#include "ui/views/controls/webview/webview.h"
 
 namespace lunetix {
 
 LunetixBrowserView::LunetixBrowserView(std::unique_ptr<Browser> browser)
     : BrowserView(std::move(browser)) {}
 
-LunetixBrowserView::~LunetixBrowserView() = default;
+LunetixBrowserView::~LunetixBrowserView() {
+  LunetixReadingModeController::GetInstance()->RemoveObserver(this);
+}
 
 void LunetixBrowserView::InitViews() {
   BrowserView::InitViews();
@@ -25,6 +29,10 @@ void LunetixBrowserView::OnTabStripModelChanged(
     const TabStripModelChange& change,
     const TabStripSelectionChange& selection) {
   BrowserView::OnTabStripModelChanged(tab_strip_model, change, selection);
+  
+  if (selection.active_tab_changed()) {
+    UpdateReaderView(selection.new_contents);
+  }
 }
 
 void LunetixBrowserView::UpdateToolbar(content::WebContents* contents) {
@@ -75,8 +83,20 @@ void LunetixBrowserView::ShowTranslateBubble(
                                   target_language, error_type, is_user_gesture);
 }
 
+void LunetixBrowserView::OnReaderContentsChanged(
+    content::WebContents* web_contents,
+    content::WebContents* reader_contents) {
+  if (web_contents == GetActiveWebContents()) {
+    UpdateReaderView(web_contents);
+  }
+}
+
 void LunetixBrowserView::Layout() {
   BrowserView::Layout();
+  
+  if (reader_web_view_ && reader_web_view_->GetVisible()) {
+    reader_web_view_->SetBoundsRect(contents_web_view()->bounds());
+  }
 }
 
 void LunetixBrowserView::ViewHierarchyChanged(
@@ -94,7 +114,38 @@ void LunetixBrowserView::GetAccessibleNodeData(ui::AXNodeData* node_data) {
 }
 
 void LunetixBrowserView::InitLunetixSpecificViews() {
-  // Initialize Lunetix-specific UI components here
+  // The reader sits next to the page contents view in the same container,
+  // so it follows the page's bounds without touching the page itself.
+  auto reader_web_view =
+      std::make_unique<views::WebView>(browser()->profile());
+  reader_web_view->SetVisible(false);
+  reader_web_view_ = contents_web_view()->parent()->AddChildView(
+      std::move(reader_web_view));
+  
+  LunetixReadingModeController::GetInstance()->AddObserver(this);
+}
+
+void LunetixBrowserView::UpdateReaderView(content::WebContents* contents) {
+  if (!reader_web_view_) {
+    return;
+  }
+  
+  content::WebContents* reader_contents = nullptr;
+  if (contents) {
+    LunetixReadingMode* reading_mode =
+        LunetixReadingMode::FromWebContents(contents);
+    if (reading_mode) {
+      reader_contents = reading_mode->GetReaderContents();
+    }
+  }
+  
+  reader_web_view_->SetWebContents(reader_contents);
+  reader_web_view_->SetVisible(reader_contents != nullptr);
+  
+  // Hiding the page's view lets it drop to hidden visibility, which is what
+  // allows reading mode to freeze it.
+  contents_web_view()->SetVisible(reader_contents == nullptr);
+  InvalidateLayout();
 }
 
 }  // namespace lunetix
\ No newline at end of file
@@ -2,10 +2,16 @@
 #define LUNETIX_BROWSER_UI_VIEWS_LUNETIX_BROWSER_VIEW_H_
 
 #include "chrome/browser/ui/views/frame/browser_view.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
+
+namespace views {
+class WebView;
+}
 
 namespace lunetix {
 
-class LunetixBrowserView : public BrowserView {
+class LunetixBrowserView : public BrowserView,
+                           public LunetixReadingModeController::Observer {
  public:
   explicit LunetixBrowserView(std::unique_ptr<Browser> browser);
   ~LunetixBrowserView() override;
@@ -33,6 +39,10 @@ class LunetixBrowserView : public BrowserView {
                           translate::TranslateErrors::Type error_type,
                           bool is_user_gesture) override;
 
+  // LunetixReadingModeController::Observer overrides:
+  void OnReaderContentsChanged(content::WebContents* web_contents,
+                               content::WebContents* reader_contents) override;
+
  protected:
   // BrowserView overrides:
   void Layout() override;
@@ -44,6 +54,13 @@ class LunetixBrowserView : public BrowserView {
  private:
   void InitLunetixSpecificViews();
   
+  // Shows the reader document of |contents| in place of the page, or the
+  // page itself when it is not in reading mode.
+  void UpdateReaderView(content::WebContents* contents);
+  
+  // Hosts the reading mode document on top of the page contents.
+  views::WebView* reader_web_view_ = nullptr;
+  
   DISALLOW_COPY_AND_ASSIGN(LunetixBrowserView);
 };
 
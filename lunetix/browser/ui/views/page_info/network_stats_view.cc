@@ -0,0 +1,59 @@
+#include "lunetix/browser/ui/views/page_info/network_stats_view.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "chrome/browser/ui/views/chrome_layout_provider.h"
+#include "lunetix/browser/net/lunetix_tab_network_stats.h"
+#include "ui/base/text/bytes_formatting.h"
+#include "ui/views/border.h"
+
+namespace lunetix {
+
+namespace {
+
+std::u16string GetStatsText(const LunetixTabNetworkStats::Snapshot& snapshot) {
+  std::u16string text =
+      ui::FormatBytes(snapshot.received_bytes) + u" loaded in " +
+      base::NumberToString16(snapshot.request_count) +
+      (snapshot.request_count == 1 ? u" request" : u" requests");
+  if (snapshot.cached_request_count) {
+    text += u", " + base::NumberToString16(snapshot.cached_request_count) +
+            u" from cache";
+  }
+  if (snapshot.failed_request_count) {
+    text += u", " + base::NumberToString16(snapshot.failed_request_count) +
+            u" failed";
+  }
+  if (!snapshot.average_time_to_first_byte.is_zero()) {
+    text += u", first byte after " +
+            base::NumberToString16(
+                snapshot.average_time_to_first_byte.InMilliseconds()) +
+            u" ms on average";
+  }
+  return text;
+}
+
+}  // namespace
+
+NetworkStatsView::NetworkStatsView(content::WebContents* web_contents) {
+  SetMultiLine(true);
+  SetHorizontalAlignment(gfx::ALIGN_LEFT);
+  SetBorder(views::CreateEmptyBorder(
+      ChromeLayoutProvider::Get()->GetInsetsMetric(views::INSETS_DIALOG)));
+  
+  LunetixTabNetworkStats* network_stats =
+      web_contents ? LunetixTabNetworkStats::FromWebContents(web_contents)
+                   : nullptr;
+  LunetixTabNetworkStats::Snapshot snapshot;
+  if (network_stats) {
+    snapshot = network_stats->GetSnapshot();
+  }
+  if (!snapshot.request_count) {
+    SetVisible(false);
+    return;
+  }
+  SetText(GetStatsText(snapshot));
+}
+
+NetworkStatsView::~NetworkStatsView() = default;
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_NETWORK_STATS_VIEW_H_
+#define LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_NETWORK_STATS_VIEW_H_
+
+#include "ui/views/controls/label.h"
+
+namespace content {
+class WebContents;
+}
+
+namespace lunetix {
+
+// The row of the page info bubble that tells how much the tab has loaded
+// from the network. Like the tracker row, it samples the counters when the
+// bubble opens and stays hidden for tabs that have not loaded anything.
+class NetworkStatsView : public views::Label {
+ public:
+  explicit NetworkStatsView(content::WebContents* web_contents);
+  ~NetworkStatsView() override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(NetworkStatsView);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_NETWORK_STATS_VIEW_H_
\ No newline at end of file
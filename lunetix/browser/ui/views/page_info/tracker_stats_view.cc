@@ -0,0 +1,58 @@
+#include "lunetix/browser/ui/views/page_info/tracker_stats_view.h"
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "chrome/browser/ui/views/chrome_layout_provider.h"
+#include "lunetix/browser/adblock/lunetix_tracker_stats.h"
+#include "ui/base/text/bytes_formatting.h"
+#include "ui/views/border.h"
+
+namespace lunetix {
+
+namespace {
+
+std::u16string GetStatsText(const LunetixTrackerStats& tracker_stats) {
+  LunetixTrackerStats::Snapshot snapshot = tracker_stats.GetSnapshot();
+  std::u16string site = base::UTF8ToUTF16(tracker_stats.site());
+  if (!snapshot.blocked_request_count &&
+      !snapshot.cookie_stripped_request_count) {
+    return u"No trackers found on " + site;
+  }
+  
+  std::u16string text =
+      base::NumberToString16(snapshot.blocked_request_count) +
+      (snapshot.blocked_request_count == 1 ? u" tracker" : u" trackers") +
+      u" blocked on " + site;
+  if (snapshot.cookie_stripped_request_count) {
+    text += u", " +
+            base::NumberToString16(snapshot.cookie_stripped_request_count) +
+            u" sent without cookies";
+  }
+  if (snapshot.estimated_bytes_saved) {
+    text += u", about " + ui::FormatBytes(snapshot.estimated_bytes_saved) +
+            u" saved";
+  }
+  return text;
+}
+
+}  // namespace
+
+TrackerStatsView::TrackerStatsView(content::WebContents* web_contents) {
+  SetMultiLine(true);
+  SetHorizontalAlignment(gfx::ALIGN_LEFT);
+  SetBorder(views::CreateEmptyBorder(
+      ChromeLayoutProvider::Get()->GetInsetsMetric(views::INSETS_DIALOG)));
+  
+  LunetixTrackerStats* tracker_stats =
+      web_contents ? LunetixTrackerStats::FromWebContents(web_contents)
+                   : nullptr;
+  if (!tracker_stats || tracker_stats->site().empty()) {
+    SetVisible(false);
+    return;
+  }
+  SetText(GetStatsText(*tracker_stats));
+}
+
+TrackerStatsView::~TrackerStatsView() = default;
+
+}  // namespace lunetix
\ No newline at end of file
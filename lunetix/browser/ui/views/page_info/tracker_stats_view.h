@@ -0,0 +1,27 @@
+#ifndef LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_TRACKER_STATS_VIEW_H_
+#define LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_TRACKER_STATS_VIEW_H_
+
+#include "ui/views/controls/label.h"
+
+namespace content {
+class WebContents;
+}
+
+namespace lunetix {
+
+// The row of the page info bubble that tells how many trackers were kept
+// away from the site in the tab. The counters are sampled when the bubble
+// opens; the view stays hidden for tabs without tracker stats, such as
+// pages that are not on the web.
+class TrackerStatsView : public views::Label {
+ public:
+  explicit TrackerStatsView(content::WebContents* web_contents);
+  ~TrackerStatsView() override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(TrackerStatsView);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_UI_VIEWS_PAGE_INFO_TRACKER_STATS_VIEW_H_
\ No newline at end of file
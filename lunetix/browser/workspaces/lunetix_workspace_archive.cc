@@ -0,0 +1,170 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_archive.h"
+
+#include <algorithm>
+
+#include "base/callback_helpers.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/pickle.h"
+#include "chrome/browser/favicon/favicon_service_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_tabrestore.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "components/favicon/content/content_favicon_driver.h"
+#include "components/favicon/core/favicon_service.h"
+#include "components/keyed_service/core/service_access_type.h"
+#include "components/sessions/content/content_serialized_navigation_builder.h"
+#include "components/sessions/core/serialized_user_agent_override.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/navigation_entry.h"
+#include "content/public/browser/web_contents.h"
+#include "ui/gfx/image/image.h"
+
+namespace lunetix {
+
+namespace {
+
+constexpr int kArchiveVersion = 1;
+
+// Same window as session restore: a few entries on either side of the
+// current one keep back and forward useful without bloating the record.
+constexpr int kMaxNavigationsAroundCurrent = 6;
+
+// Upper bound for a single serialized navigation, mostly page state.
+constexpr int kMaxNavigationSize = 256 * 1024;
+
+}  // namespace
+
+LunetixArchivedTab::LunetixArchivedTab() = default;
+
+LunetixArchivedTab::LunetixArchivedTab(LunetixArchivedTab&& other) = default;
+
+LunetixArchivedTab& LunetixArchivedTab::operator=(LunetixArchivedTab&& other) =
+    default;
+
+LunetixArchivedTab::~LunetixArchivedTab() = default;
+
+LunetixArchivedTab ArchiveTab(content::WebContents* web_contents, bool pinned) {
+  LunetixArchivedTab tab;
+  tab.pinned = pinned;
+  
+  content::NavigationController& controller = web_contents->GetController();
+  int current = controller.GetCurrentEntryIndex();
+  int begin = std::max(0, current - kMaxNavigationsAroundCurrent);
+  int end = std::min(controller.GetEntryCount(),
+                     current + kMaxNavigationsAroundCurrent + 1);
+  for (int i = begin; i < end; ++i) {
+    tab.navigations.push_back(
+        sessions::ContentSerializedNavigationBuilder::FromNavigationEntry(
+            i, controller.GetEntryAtIndex(i)));
+  }
+  tab.current_navigation_index = std::max(0, current - begin);
+  
+  favicon::ContentFaviconDriver* favicon_driver =
+      favicon::ContentFaviconDriver::FromWebContents(web_contents);
+  if (favicon_driver && favicon_driver->FaviconIsValid()) {
+    scoped_refptr<base::RefCountedMemory> png =
+        favicon_driver->GetFavicon().As1xPNGBytes();
+    if (png && png->size()) {
+      tab.favicon_url = favicon_driver->GetFaviconURL();
+      tab.favicon_png.assign(png->front_as<char>(), png->size());
+    }
+  }
+  return tab;
+}
+
+content::WebContents* RestoreArchivedTab(Browser* browser,
+                                         const LunetixArchivedTab& tab,
+                                         bool select) {
+  if (tab.navigations.empty()) {
+    return nullptr;
+  }
+  int current = std::min(tab.current_navigation_index,
+                         static_cast<int>(tab.navigations.size()) - 1);
+  
+  // The placeholder shows its favicon from history, which may have expired
+  // it while the workspace was parked.
+  if (!tab.favicon_png.empty() && tab.favicon_url.is_valid()) {
+    favicon::FaviconService* favicon_service =
+        FaviconServiceFactory::GetForProfile(
+            browser->profile(), ServiceAccessType::EXPLICIT_ACCESS);
+    if (favicon_service) {
+      favicon_service->SetOnDemandFavicons(
+          tab.navigations[current].virtual_url(), tab.favicon_url,
+          favicon_base::IconType::kFavicon,
+          gfx::Image::CreateFrom1xPNGBytes(
+              reinterpret_cast<const unsigned char*>(tab.favicon_png.data()),
+              tab.favicon_png.size()),
+          base::DoNothing());
+    }
+  }
+  
+  // Restored tabs that are not selected have no renderer until they are
+  // first activated.
+  return chrome::AddRestoredTab(
+      browser, tab.navigations, browser->tab_strip_model()->count(), current,
+      std::string(), absl::nullopt, select, tab.pinned, base::TimeTicks(),
+      nullptr, sessions::SerializedUserAgentOverride(),
+      /*from_session_restore=*/true);
+}
+
+std::string SerializeArchivedTabs(const std::vector<LunetixArchivedTab>& tabs) {
+  base::Pickle pickle;
+  pickle.WriteInt(kArchiveVersion);
+  pickle.WriteInt(static_cast<int>(tabs.size()));
+  for (const LunetixArchivedTab& tab : tabs) {
+    pickle.WriteInt(tab.current_navigation_index);
+    pickle.WriteBool(tab.pinned);
+    pickle.WriteInt(static_cast<int>(tab.navigations.size()));
+    for (const sessions::SerializedNavigationEntry& navigation :
+         tab.navigations) {
+      navigation.WriteToPickle(kMaxNavigationSize, &pickle);
+    }
+    pickle.WriteString(tab.favicon_url.spec());
+    pickle.WriteString(tab.favicon_png);
+  }
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+bool DeserializeArchivedTabs(const std::string& data,
+                             std::vector<LunetixArchivedTab>* tabs) {
+  base::Pickle pickle(data.data(), data.size());
+  base::PickleIterator iterator(pickle);
+  
+  int version = 0;
+  int tab_count = 0;
+  if (!iterator.ReadInt(&version) || version != kArchiveVersion ||
+      !iterator.ReadInt(&tab_count) || tab_count < 0) {
+    return false;
+  }
+  
+  tabs->clear();
+  tabs->reserve(tab_count);
+  for (int i = 0; i < tab_count; ++i) {
+    LunetixArchivedTab tab;
+    int navigation_count = 0;
+    if (!iterator.ReadInt(&tab.current_navigation_index) ||
+        !iterator.ReadBool(&tab.pinned) ||
+        !iterator.ReadInt(&navigation_count) || navigation_count < 0) {
+      return false;
+    }
+    
+    tab.navigations.resize(navigation_count);
+    for (sessions::SerializedNavigationEntry& navigation : tab.navigations) {
+      if (!navigation.ReadFromPickle(&iterator)) {
+        return false;
+      }
+    }
+    
+    std::string favicon_url;
+    if (!iterator.ReadString(&favicon_url) ||
+        !iterator.ReadString(&tab.favicon_png)) {
+      return false;
+    }
+    tab.favicon_url = GURL(favicon_url);
+    tabs->push_back(std::move(tab));
+  }
+  return true;
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_ARCHIVE_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_ARCHIVE_H_
+
+#include <string>
+#include <vector>
+
+#include "components/sessions/core/serialized_navigation_entry.h"
+#include "url/gurl.h"
+
+class Browser;
+
+namespace content {
+class WebContents;
+}
+
+namespace lunetix {
+
+// Everything needed to bring a tab of a parked workspace back without
+// loading it. The scroll offset travels in each navigation's page state.
+struct LunetixArchivedTab {
+  LunetixArchivedTab();
+  LunetixArchivedTab(LunetixArchivedTab&& other);
+  LunetixArchivedTab& operator=(LunetixArchivedTab&& other);
+  ~LunetixArchivedTab();
+  
+  std::vector<sessions::SerializedNavigationEntry> navigations;
+  int current_navigation_index = 0;
+  bool pinned = false;
+  GURL favicon_url;
+  std::string favicon_png;
+};
+
+// Captures the navigation stack and favicon of a tab.
+LunetixArchivedTab ArchiveTab(content::WebContents* web_contents, bool pinned);
+
+// Appends |tab| to |browser| as an unloaded placeholder that loads when it
+// is first activated, unless |select| is set.
+content::WebContents* RestoreArchivedTab(Browser* browser,
+                                         const LunetixArchivedTab& tab,
+                                         bool select);
+
+// Binary record of a parked workspace's tabs.
+std::string SerializeArchivedTabs(const std::vector<LunetixArchivedTab>& tabs);
+bool DeserializeArchivedTabs(const std::string& data,
+                             std::vector<LunetixArchivedTab>* tabs);
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_ARCHIVE_H_
\ No newline at end of file
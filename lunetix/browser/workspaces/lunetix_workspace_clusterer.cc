@@ -0,0 +1,360 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_clusterer.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+#include "base/bind.h"
+#include "base/bind_post_task.h"
+#include "base/task/thread_pool.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "components/sessions/content/session_tab_helper.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+constexpr base::TimeDelta kPassInterval = base::Minutes(10);
+
+// CPU a pass may use before yielding its sequence.
+constexpr base::TimeDelta kSliceBudget = base::Milliseconds(4);
+
+// Only switches made in quick succession say the tabs are used together.
+constexpr base::TimeDelta kCoActivationWindow = base::Minutes(2);
+constexpr int kMinCoActivations = 3;
+constexpr size_t kMaxCoActivationPairs = 4096;
+
+constexpr size_t kMaxTabsPerPass = 2000;
+constexpr size_t kMinClusterSize = 3;
+
+// Work items between two deadline checks.
+constexpr size_t kDeadlineCheckInterval = 64;
+
+int GetTabId(content::WebContents* web_contents) {
+  return sessions::SessionTabHelper::IdForTab(web_contents).id();
+}
+
+}  // namespace
+
+WorkspaceProposal::WorkspaceProposal() = default;
+
+WorkspaceProposal::WorkspaceProposal(const WorkspaceProposal& other) = default;
+
+WorkspaceProposal& WorkspaceProposal::operator=(
+    const WorkspaceProposal& other) = default;
+
+WorkspaceProposal::~WorkspaceProposal() = default;
+
+LunetixWorkspaceClusterer::Cluster::Cluster() = default;
+
+LunetixWorkspaceClusterer::Cluster::Cluster(Cluster&& other) = default;
+
+LunetixWorkspaceClusterer::Cluster&
+LunetixWorkspaceClusterer::Cluster::operator=(Cluster&& other) = default;
+
+LunetixWorkspaceClusterer::Cluster::~Cluster() = default;
+
+// One clustering run over a snapshot of the tabs. Tabs are joined with a
+// union-find over three kinds of edges, processed in stages so the pass can
+// stop at any point and pick up where it left off in the next slice.
+class LunetixWorkspaceClusterer::Pass {
+ public:
+  struct Tab {
+    int id;
+    GURL url;
+    int opener_id;
+  };
+  
+  using Callback = base::OnceCallback<void(std::vector<Cluster>)>;
+  
+  Pass(std::vector<Tab> tabs,
+       std::vector<std::pair<int, int>> co_activated,
+       Callback callback)
+      : tabs_(std::move(tabs)),
+        co_activated_(std::move(co_activated)),
+        callback_(std::move(callback)),
+        domains_(tabs_.size()),
+        parents_(tabs_.size()) {
+    std::iota(parents_.begin(), parents_.end(), 0);
+    for (size_t i = 0; i < tabs_.size(); ++i) {
+      index_by_id_[tabs_[i].id] = i;
+    }
+  }
+  
+  // Runs slices on the current sequence until the pass is done.
+  static void RunSlice(std::unique_ptr<Pass> pass) {
+    if (!pass->Run(base::TimeTicks::Now() + kSliceBudget)) {
+      base::SequencedTaskRunnerHandle::Get()->PostTask(
+          FROM_HERE, base::BindOnce(&Pass::RunSlice, std::move(pass)));
+      return;
+    }
+    std::move(pass->callback_).Run(pass->TakeClusters());
+  }
+  
+ private:
+  enum class Stage { kDomains, kOpeners, kCoActivations, kDone };
+  
+  // Returns true once every stage is complete.
+  bool Run(base::TimeTicks deadline) {
+    while (stage_ != Stage::kDone) {
+      if (++steps_ % kDeadlineCheckInterval == 0 &&
+          base::TimeTicks::Now() >= deadline) {
+        return false;
+      }
+      Step();
+    }
+    return true;
+  }
+  
+  void Step() {
+    switch (stage_) {
+      case Stage::kDomains: {
+        if (cursor_ == tabs_.size()) {
+          NextStage(Stage::kOpeners);
+          return;
+        }
+        std::string domain =
+            net::registry_controlled_domains::GetDomainAndRegistry(
+                tabs_[cursor_].url,
+                net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+        if (!domain.empty()) {
+          auto first = first_by_domain_.emplace(domain, cursor_).first;
+          Union(first->second, cursor_);
+        }
+        domains_[cursor_++] = std::move(domain);
+        return;
+      }
+      case Stage::kOpeners: {
+        if (cursor_ == tabs_.size()) {
+          NextStage(Stage::kCoActivations);
+          return;
+        }
+        auto opener = index_by_id_.find(tabs_[cursor_].opener_id);
+        if (opener != index_by_id_.end()) {
+          Union(opener->second, cursor_);
+        }
+        ++cursor_;
+        return;
+      }
+      case Stage::kCoActivations: {
+        if (cursor_ == co_activated_.size()) {
+          NextStage(Stage::kDone);
+          return;
+        }
+        auto a = index_by_id_.find(co_activated_[cursor_].first);
+        auto b = index_by_id_.find(co_activated_[cursor_].second);
+        if (a != index_by_id_.end() && b != index_by_id_.end()) {
+          Union(a->second, b->second);
+        }
+        ++cursor_;
+        return;
+      }
+      case Stage::kDone:
+        return;
+    }
+  }
+  
+  void NextStage(Stage stage) {
+    stage_ = stage;
+    cursor_ = 0;
+  }
+  
+  size_t Find(size_t index) {
+    while (parents_[index] != index) {
+      parents_[index] = parents_[parents_[index]];
+      index = parents_[index];
+    }
+    return index;
+  }
+  
+  void Union(size_t a, size_t b) {
+    a = Find(a);
+    b = Find(b);
+    if (a != b) {
+      parents_[std::max(a, b)] = std::min(a, b);
+    }
+  }
+  
+  std::vector<Cluster> TakeClusters() {
+    std::map<size_t, std::vector<size_t>> members;
+    for (size_t i = 0; i < tabs_.size(); ++i) {
+      members[Find(i)].push_back(i);
+    }
+    
+    std::vector<Cluster> clusters;
+    for (const auto& entry : members) {
+      const std::vector<size_t>& indices = entry.second;
+      // Moving every tab into a new workspace would not organize anything.
+      if (indices.size() < kMinClusterSize || indices.size() == tabs_.size()) {
+        continue;
+      }
+      
+      Cluster cluster;
+      std::map<std::string, int> domain_counts;
+      int best_count = 0;
+      for (size_t index : indices) {
+        cluster.tab_ids.push_back(tabs_[index].id);
+        if (domains_[index].empty()) {
+          continue;
+        }
+        int count = ++domain_counts[domains_[index]];
+        if (count > best_count) {
+          best_count = count;
+          cluster.name = domains_[index];
+        }
+      }
+      if (!cluster.name.empty()) {
+        clusters.push_back(std::move(cluster));
+      }
+    }
+    return clusters;
+  }
+  
+  const std::vector<Tab> tabs_;
+  const std::vector<std::pair<int, int>> co_activated_;
+  Callback callback_;
+  
+  std::unordered_map<int, size_t> index_by_id_;
+  std::unordered_map<std::string, size_t> first_by_domain_;
+  std::vector<std::string> domains_;
+  std::vector<size_t> parents_;
+  
+  Stage stage_ = Stage::kDomains;
+  size_t cursor_ = 0;
+  size_t steps_ = 0;
+  
+  DISALLOW_COPY_AND_ASSIGN(Pass);
+};
+
+LunetixWorkspaceClusterer::LunetixWorkspaceClusterer(
+    LunetixWorkspaceManager* manager,
+    ProposalsCallback callback)
+    : manager_(manager),
+      callback_(std::move(callback)),
+      task_runner_(base::ThreadPool::CreateSequencedTaskRunner(
+          {base::TaskPriority::BEST_EFFORT,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {
+  pass_timer_.Start(FROM_HERE, kPassInterval, this,
+                    &LunetixWorkspaceClusterer::MaybeRunPass);
+}
+
+LunetixWorkspaceClusterer::~LunetixWorkspaceClusterer() = default;
+
+void LunetixWorkspaceClusterer::OnTabActivated(
+    content::WebContents* old_contents,
+    content::WebContents* new_contents) {
+  base::TimeTicks now = base::TimeTicks::Now();
+  bool quick_switch = now - last_activation_time_ < kCoActivationWindow;
+  last_activation_time_ = now;
+  if (!old_contents || !new_contents || !quick_switch) {
+    return;
+  }
+  
+  int a = GetTabId(old_contents);
+  int b = GetTabId(new_contents);
+  if (a == b) {
+    return;
+  }
+  ++co_activations_[std::minmax(a, b)];
+  dirty_ = true;
+  
+  // Decay instead of growing without bound; pairs used only once or twice
+  // fall out first.
+  if (co_activations_.size() > kMaxCoActivationPairs) {
+    for (auto it = co_activations_.begin(); it != co_activations_.end();) {
+      it->second /= 2;
+      it = it->second ? std::next(it) : co_activations_.erase(it);
+    }
+  }
+}
+
+void LunetixWorkspaceClusterer::RunPass() {
+  dirty_ = true;
+  MaybeRunPass();
+}
+
+void LunetixWorkspaceClusterer::MaybeRunPass() {
+  if (!dirty_ || pass_in_progress_) {
+    return;
+  }
+  
+  LunetixWorkspace* default_workspace = manager_->GetWorkspace("default");
+  if (!default_workspace) {
+    return;
+  }
+  
+  // Snapshot the uncategorized tabs; the background sequence only ever sees
+  // ids and URLs.
+  std::vector<Pass::Tab> tabs;
+  for (Browser* browser : *BrowserList::GetInstance()) {
+    TabStripModel* tab_strip = browser->tab_strip_model();
+    for (int i = 0; i < tab_strip->count() && tabs.size() < kMaxTabsPerPass;
+         ++i) {
+      content::WebContents* web_contents = tab_strip->GetWebContentsAt(i);
+      if (manager_->GetWorkspaceForTab(web_contents) != default_workspace) {
+        continue;
+      }
+      content::WebContents* opener = tab_strip->GetOpenerOfWebContentsAt(i);
+      tabs.push_back({GetTabId(web_contents),
+                      web_contents->GetLastCommittedURL(),
+                      opener ? GetTabId(opener) : -1});
+    }
+  }
+  
+  std::vector<std::pair<int, int>> co_activated;
+  for (const auto& entry : co_activations_) {
+    if (entry.second >= kMinCoActivations) {
+      co_activated.push_back(entry.first);
+    }
+  }
+  
+  dirty_ = false;
+  if (tabs.size() < kMinClusterSize) {
+    return;
+  }
+  
+  pass_in_progress_ = true;
+  auto pass = std::make_unique<Pass>(
+      std::move(tabs), std::move(co_activated),
+      base::BindPostTask(
+          base::SequencedTaskRunnerHandle::Get(),
+          base::BindOnce(&LunetixWorkspaceClusterer::OnPassComplete,
+                         weak_factory_.GetWeakPtr())));
+  task_runner_->PostTask(FROM_HERE,
+                         base::BindOnce(&Pass::RunSlice, std::move(pass)));
+}
+
+void LunetixWorkspaceClusterer::OnPassComplete(
+    std::vector<Cluster> clusters) {
+  pass_in_progress_ = false;
+  
+  LunetixWorkspace* default_workspace = manager_->GetWorkspace("default");
+  std::vector<WorkspaceProposal> proposals;
+  for (const Cluster& cluster : clusters) {
+    WorkspaceProposal proposal;
+    proposal.name = cluster.name;
+    for (int tab_id : cluster.tab_ids) {
+      // Skip tabs that closed or were organized while the pass ran.
+      content::WebContents* web_contents = manager_->GetTabById(tab_id);
+      if (web_contents &&
+          manager_->GetWorkspaceForTab(web_contents) == default_workspace) {
+        proposal.tab_ids.push_back(tab_id);
+      }
+    }
+    if (proposal.tab_ids.size() >= kMinClusterSize) {
+      proposals.push_back(std::move(proposal));
+    }
+  }
+  
+  if (!proposals.empty()) {
+    callback_.Run(proposals);
+  }
+}
+
+}  // namespace lunetix
\ No newline at end of file
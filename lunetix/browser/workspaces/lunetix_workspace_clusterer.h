@@ -0,0 +1,96 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_CLUSTERER_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_CLUSTERER_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace content {
+class WebContents;
+}
+
+namespace lunetix {
+
+class LunetixWorkspaceManager;
+
+// A set of tabs from the default workspace that seem to belong together.
+struct WorkspaceProposal {
+  WorkspaceProposal();
+  WorkspaceProposal(const WorkspaceProposal& other);
+  WorkspaceProposal& operator=(const WorkspaceProposal& other);
+  ~WorkspaceProposal();
+  
+  // Most common site among the tabs.
+  std::string name;
+  // Session ids of the tabs. A proposal may be accepted long after it was
+  // made, so its tabs are looked up again rather than held by pointer.
+  std::vector<int> tab_ids;
+};
+
+// Periodically clusters the tabs of the default workspace by registrable
+// domain, opener and how often the user switches between them. Clustering
+// runs on a best effort sequence in short slices, so a pass never holds a
+// core for long no matter how many tabs are open.
+class LunetixWorkspaceClusterer {
+ public:
+  using ProposalsCallback =
+      base::RepeatingCallback<void(const std::vector<WorkspaceProposal>&)>;
+  
+  LunetixWorkspaceClusterer(LunetixWorkspaceManager* manager,
+                            ProposalsCallback callback);
+  ~LunetixWorkspaceClusterer();
+  
+  void OnTabActivated(content::WebContents* old_contents,
+                      content::WebContents* new_contents);
+  // Open tabs or their workspaces changed; the next pass has work to do.
+  void OnTabsChanged() { dirty_ = true; }
+  
+  // Starts a pass now rather than at the next interval.
+  void RunPass();
+  
+ private:
+  // Tabs that clustered together, by tab id.
+  struct Cluster {
+    Cluster();
+    Cluster(Cluster&& other);
+    Cluster& operator=(Cluster&& other);
+    ~Cluster();
+    
+    std::string name;
+    std::vector<int> tab_ids;
+  };
+  
+  class Pass;
+  
+  void MaybeRunPass();
+  void OnPassComplete(std::vector<Cluster> clusters);
+  
+  LunetixWorkspaceManager* const manager_;
+  ProposalsCallback callback_;
+  
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  base::RepeatingTimer pass_timer_;
+  bool dirty_ = true;
+  bool pass_in_progress_ = false;
+  
+  // How often the user switched directly between two tabs, keyed by the
+  // ordered pair of tab ids.
+  std::map<std::pair<int, int>, int> co_activations_;
+  base::TimeTicks last_activation_time_;
+  
+  base::WeakPtrFactory<LunetixWorkspaceClusterer> weak_factory_{this};
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixWorkspaceClusterer);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_CLUSTERER_H_
\ No newline at end of file
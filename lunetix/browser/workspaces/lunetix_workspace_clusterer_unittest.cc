@@ -0,0 +1,161 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_clusterer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "base/test/bind.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/test/base/browser_with_test_window_test.h"
+#include "components/sessions/content/session_tab_helper.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+class LunetixWorkspaceClustererTest : public BrowserWithTestWindowTest {
+ protected:
+  LunetixWorkspaceClustererTest()
+      : BrowserWithTestWindowTest(
+            base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+  
+  void SetUp() override {
+    BrowserWithTestWindowTest::SetUp();
+    manager_ = std::make_unique<LunetixWorkspaceManager>(profile());
+    task_environment()->RunUntilIdle();
+    clusterer_ = std::make_unique<LunetixWorkspaceClusterer>(
+        manager_.get(),
+        base::BindLambdaForTesting(
+            [this](const std::vector<WorkspaceProposal>& proposals) {
+              proposals_ = proposals;
+            }));
+  }
+  
+  void TearDown() override {
+    clusterer_.reset();
+    manager_->Shutdown();
+    manager_.reset();
+    BrowserWithTestWindowTest::TearDown();
+  }
+  
+  content::WebContents* OpenTab(const char* url) {
+    AddTab(browser(), GURL(url));
+    return browser()->tab_strip_model()->GetWebContentsAt(0);
+  }
+  
+  // Runs a pass to completion and returns the proposals it made.
+  std::vector<WorkspaceProposal> RunPass() {
+    proposals_.clear();
+    clusterer_->RunPass();
+    task_environment()->RunUntilIdle();
+    return proposals_;
+  }
+  
+  // Switches back and forth between |a| and |b| in quick succession.
+  void SwitchBetween(content::WebContents* a, content::WebContents* b) {
+    for (int i = 0; i < 3; ++i) {
+      clusterer_->OnTabActivated(a, b);
+      clusterer_->OnTabActivated(b, a);
+    }
+  }
+  
+  static std::vector<int> GetTabIds(
+      std::vector<content::WebContents*> tabs) {
+    std::vector<int> tab_ids;
+    for (content::WebContents* web_contents : tabs) {
+      tab_ids.push_back(
+          sessions::SessionTabHelper::IdForTab(web_contents).id());
+    }
+    std::sort(tab_ids.begin(), tab_ids.end());
+    return tab_ids;
+  }
+  
+  static std::vector<int> GetSortedTabIds(const WorkspaceProposal& proposal) {
+    std::vector<int> tab_ids = proposal.tab_ids;
+    std::sort(tab_ids.begin(), tab_ids.end());
+    return tab_ids;
+  }
+  
+  std::unique_ptr<LunetixWorkspaceManager> manager_;
+  std::unique_ptr<LunetixWorkspaceClusterer> clusterer_;
+  std::vector<WorkspaceProposal> proposals_;
+};
+
+TEST_F(LunetixWorkspaceClustererTest, ClustersTabsBySite) {
+  content::WebContents* mail = OpenTab("https://mail.example.com/");
+  content::WebContents* docs = OpenTab("https://docs.example.com/report");
+  content::WebContents* home = OpenTab("https://example.com/");
+  OpenTab("https://news.example.org/");
+  
+  std::vector<WorkspaceProposal> proposals = RunPass();
+  ASSERT_EQ(1u, proposals.size());
+  EXPECT_EQ("example.com", proposals[0].name);
+  EXPECT_EQ(GetTabIds({mail, docs, home}), GetSortedTabIds(proposals[0]));
+}
+
+TEST_F(LunetixWorkspaceClustererTest, ProposesNothingForEveryTab) {
+  OpenTab("https://mail.example.com/");
+  OpenTab("https://docs.example.com/");
+  OpenTab("https://example.com/");
+  
+  EXPECT_TRUE(RunPass().empty());
+}
+
+TEST_F(LunetixWorkspaceClustererTest, ClustersTabsUsedTogether) {
+  content::WebContents* a = OpenTab("https://a.example.com/");
+  content::WebContents* b = OpenTab("https://b.example.org/");
+  content::WebContents* c = OpenTab("https://c.example.net/");
+  OpenTab("https://d.example.io/");
+  
+  clusterer_->OnTabActivated(nullptr, a);
+  SwitchBetween(a, b);
+  SwitchBetween(b, c);
+  
+  std::vector<WorkspaceProposal> proposals = RunPass();
+  ASSERT_EQ(1u, proposals.size());
+  EXPECT_EQ(GetTabIds({a, b, c}), GetSortedTabIds(proposals[0]));
+}
+
+TEST_F(LunetixWorkspaceClustererTest, IgnoresSlowSwitches) {
+  content::WebContents* a = OpenTab("https://a.example.com/");
+  content::WebContents* b = OpenTab("https://b.example.org/");
+  content::WebContents* c = OpenTab("https://c.example.net/");
+  OpenTab("https://d.example.io/");
+  
+  clusterer_->OnTabActivated(nullptr, a);
+  for (int i = 0; i < 3; ++i) {
+    task_environment()->FastForwardBy(base::Minutes(3));
+    clusterer_->OnTabActivated(a, b);
+    task_environment()->FastForwardBy(base::Minutes(3));
+    clusterer_->OnTabActivated(b, c);
+  }
+  
+  EXPECT_TRUE(RunPass().empty());
+}
+
+TEST_F(LunetixWorkspaceClustererTest, LeavesOutTabsOrganizedDuringPass) {
+  content::WebContents* mail = OpenTab("https://mail.example.com/");
+  content::WebContents* docs = OpenTab("https://docs.example.com/");
+  content::WebContents* home = OpenTab("https://example.com/");
+  content::WebContents* shop = OpenTab("https://shop.example.com/");
+  OpenTab("https://news.example.org/");
+  
+  proposals_.clear();
+  clusterer_->RunPass();
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabToWorkspace(shop, work->id());
+  task_environment()->RunUntilIdle();
+  
+  ASSERT_EQ(1u, proposals_.size());
+  EXPECT_EQ(GetTabIds({mail, docs, home}), GetSortedTabIds(proposals_[0]));
+  
+  // Too few tabs are left to be worth proposing.
+  clusterer_->RunPass();
+  manager_->MoveTabToWorkspace(home, work->id());
+  proposals_.clear();
+  task_environment()->RunUntilIdle();
+  EXPECT_TRUE(proposals_.empty());
+}
+
+}  // namespace lunetix
\ No newline at end of file
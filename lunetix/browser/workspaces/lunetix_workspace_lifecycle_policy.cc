@@ -0,0 +1,351 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_lifecycle_policy.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "chrome/browser/resource_coordinator/lifecycle_unit_state.mojom.h"
+#include "chrome/browser/resource_coordinator/tab_lifecycle_unit_external.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+#include "content/public/browser/web_contents.h"
+#include "lunetix/browser/reading_mode/lunetix_reading_mode.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+#include "services/resource_coordinator/public/cpp/memory_instrumentation/memory_instrumentation.h"
+
+namespace lunetix {
+
+namespace {
+
+// Quick switches back and forth should not pay for a freeze and thaw.
+constexpr base::TimeDelta kFreezeGracePeriod = base::Seconds(30);
+
+bool IsTabBusy(content::WebContents* web_contents) {
+  return web_contents->IsCurrentlyAudible() ||
+         web_contents->IsBeingCaptured();
+}
+
+bool CanFreeze(content::WebContents* web_contents) {
+  if (web_contents->GetVisibility() != content::Visibility::HIDDEN ||
+      IsTabBusy(web_contents)) {
+    return false;
+  }
+  
+  // Reading mode freezes the page under its reader and owns that state.
+  LunetixReadingMode* reading_mode =
+      LunetixReadingMode::FromWebContents(web_contents);
+  return !reading_mode || !reading_mode->IsInReadingMode();
+}
+
+base::ProcessId GetTabProcessId(content::WebContents* web_contents) {
+  content::RenderProcessHost* process =
+      web_contents->GetMainFrame()->GetProcess();
+  if (!process->IsInitializedAndNotDead()) {
+    return base::kNullProcessId;
+  }
+  return process->GetProcess().Pid();
+}
+
+}  // namespace
+
+LunetixWorkspaceLifecyclePolicy::LunetixWorkspaceLifecyclePolicy(
+    LunetixWorkspaceManager* manager)
+    : manager_(manager) {}
+
+LunetixWorkspaceLifecyclePolicy::~LunetixWorkspaceLifecyclePolicy() = default;
+
+void LunetixWorkspaceLifecyclePolicy::OnWorkspaceActivated(
+    LunetixWorkspace* workspace) {
+  freeze_timers_.erase(workspace->id());
+  
+  ++thaw_generation_;
+  thaw_queue_.clear();
+  for (content::WebContents* web_contents : workspace->tabs()) {
+    if (!frozen_tabs_.count(web_contents)) {
+      continue;
+    }
+    // Collapsed groups stay frozen.
+    LunetixWorkspaceManager::TabGroup* group =
+        manager_->GetTabGroupForTab(web_contents);
+    if (!group || !group->collapsed) {
+      thaw_queue_.push_back(web_contents);
+    }
+  }
+  if (thaw_queue_.empty()) {
+    return;
+  }
+  
+  // The tab the user is about to see thaws first, the rest in order of
+  // recent use.
+  std::sort(thaw_queue_.begin(), thaw_queue_.end(),
+            [](content::WebContents* a, content::WebContents* b) {
+              return a->GetLastActiveTime() > b->GetLastActiveTime();
+            });
+  ThawTab(thaw_queue_.front());
+  thaw_queue_.pop_front();
+  
+  if (!thaw_queue_.empty()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&LunetixWorkspaceLifecyclePolicy::ThawNextTab,
+                                  weak_factory_.GetWeakPtr(),
+                                  thaw_generation_));
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnWorkspaceDeactivated(
+    LunetixWorkspace* workspace) {
+  ++thaw_generation_;
+  thaw_queue_.clear();
+  ScheduleFreeze(workspace);
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnTabAssigned(
+    content::WebContents* web_contents,
+    LunetixWorkspace* workspace) {
+  if (workspace->IsActive()) {
+    ThawTab(web_contents);
+  } else {
+    ScheduleFreeze(workspace);
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnTabActivated(
+    content::WebContents* web_contents) {
+  ThawTab(web_contents);
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnTabRemoved(
+    content::WebContents* web_contents) {
+  frozen_tabs_.erase(web_contents);
+  thaw_queue_.erase(
+      std::remove(thaw_queue_.begin(), thaw_queue_.end(), web_contents),
+      thaw_queue_.end());
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnTabGroupCollapsed(
+    const std::string& group_id,
+    bool collapsed) {
+  if (!collapsed) {
+    group_freeze_timers_.erase(group_id);
+    for (content::WebContents* web_contents :
+         manager_->GetTabsInGroup(group_id)) {
+      ThawTab(web_contents);
+    }
+    return;
+  }
+  
+  std::unique_ptr<base::OneShotTimer>& timer = group_freeze_timers_[group_id];
+  if (!timer) {
+    timer = std::make_unique<base::OneShotTimer>();
+  }
+  timer->Start(FROM_HERE, kFreezeGracePeriod,
+               base::BindOnce(&LunetixWorkspaceLifecyclePolicy::FreezeTabGroup,
+                              base::Unretained(this), group_id));
+}
+
+void LunetixWorkspaceLifecyclePolicy::SetMemoryBudget(uint64_t bytes) {
+  memory_budget_bytes_ = bytes;
+  if (!memory_budget_bytes_) {
+    memory_pressure_listener_.reset();
+    return;
+  }
+  
+  if (!memory_pressure_listener_) {
+    memory_pressure_listener_ = std::make_unique<base::MemoryPressureListener>(
+        FROM_HERE,
+        base::BindRepeating(&LunetixWorkspaceLifecyclePolicy::OnMemoryPressure,
+                            base::Unretained(this)));
+  }
+  EnforceMemoryBudget();
+}
+
+// static
+std::vector<content::WebContents*>
+LunetixWorkspaceLifecyclePolicy::SelectTabsToDiscard(
+    std::vector<TabMemory> tabs,
+    uint64_t budget_bytes) {
+  std::vector<content::WebContents*> discarded;
+  uint64_t total_bytes = 0;
+  for (const TabMemory& tab : tabs) {
+    total_bytes += tab.bytes;
+  }
+  if (total_bytes <= budget_bytes) {
+    return discarded;
+  }
+  
+  std::sort(tabs.begin(), tabs.end(),
+            [](const TabMemory& a, const TabMemory& b) {
+              return a.last_active_time < b.last_active_time;
+            });
+  for (const TabMemory& tab : tabs) {
+    if (total_bytes <= budget_bytes) {
+      break;
+    }
+    if (tab.can_discard) {
+      discarded.push_back(tab.web_contents);
+      total_bytes -= tab.bytes;
+    }
+  }
+  return discarded;
+}
+
+void LunetixWorkspaceLifecyclePolicy::ScheduleFreeze(
+    LunetixWorkspace* workspace) {
+  std::unique_ptr<base::OneShotTimer>& timer = freeze_timers_[workspace->id()];
+  if (!timer) {
+    timer = std::make_unique<base::OneShotTimer>();
+  }
+  if (timer->IsRunning()) {
+    return;
+  }
+  timer->Start(FROM_HERE, kFreezeGracePeriod,
+               base::BindOnce(&LunetixWorkspaceLifecyclePolicy::FreezeWorkspace,
+                              base::Unretained(this), workspace->id()));
+}
+
+void LunetixWorkspaceLifecyclePolicy::FreezeWorkspace(
+    const std::string& workspace_id) {
+  LunetixWorkspace* workspace = manager_->GetWorkspace(workspace_id);
+  if (!workspace || workspace->IsActive()) {
+    freeze_timers_.erase(workspace_id);
+    return;
+  }
+  
+  for (content::WebContents* web_contents : workspace->tabs()) {
+    FreezeTab(web_contents);
+  }
+  
+  EnforceMemoryBudget();
+}
+
+void LunetixWorkspaceLifecyclePolicy::FreezeTabGroup(
+    const std::string& group_id) {
+  group_freeze_timers_.erase(group_id);
+  LunetixWorkspaceManager::TabGroup* group = manager_->GetTabGroup(group_id);
+  if (!group || !group->collapsed) {
+    return;
+  }
+  
+  for (content::WebContents* web_contents :
+       manager_->GetTabsInGroup(group_id)) {
+    FreezeTab(web_contents);
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::FreezeTab(
+    content::WebContents* web_contents) {
+  if (!frozen_tabs_.count(web_contents) && CanFreeze(web_contents)) {
+    web_contents->SetPageFrozen(true);
+    frozen_tabs_.insert(web_contents);
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::ThawNextTab(int thaw_generation) {
+  if (thaw_generation != thaw_generation_ || thaw_queue_.empty()) {
+    return;
+  }
+  
+  ThawTab(thaw_queue_.front());
+  thaw_queue_.pop_front();
+  
+  if (!thaw_queue_.empty()) {
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE, base::BindOnce(&LunetixWorkspaceLifecyclePolicy::ThawNextTab,
+                                  weak_factory_.GetWeakPtr(), thaw_generation));
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::ThawTab(
+    content::WebContents* web_contents) {
+  if (frozen_tabs_.erase(web_contents)) {
+    web_contents->SetPageFrozen(false);
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::EnforceMemoryBudget() {
+  if (!memory_budget_bytes_ || memory_dump_in_progress_) {
+    return;
+  }
+  
+  auto* instrumentation =
+      memory_instrumentation::MemoryInstrumentation::GetInstance();
+  if (!instrumentation) {
+    return;
+  }
+  
+  memory_dump_in_progress_ = true;
+  instrumentation->RequestPrivateMemoryFootprint(
+      base::kNullProcessId,
+      base::BindOnce(&LunetixWorkspaceLifecyclePolicy::OnMemoryDumpReceived,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnMemoryDumpReceived(
+    bool success,
+    std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump) {
+  memory_dump_in_progress_ = false;
+  if (!success || !dump) {
+    return;
+  }
+  
+  std::unordered_map<base::ProcessId, uint64_t> process_footprints;
+  for (const auto& process_dump : dump->process_dumps()) {
+    process_footprints[process_dump.pid()] =
+        uint64_t{process_dump.os_dump().private_footprint_kb} * 1024;
+  }
+  
+  // A renderer can host several tabs, so its footprint is split evenly
+  // between them.
+  std::unordered_map<base::ProcessId, int> tabs_per_process;
+  for (const auto& workspace : manager_->GetAllWorkspaces()) {
+    for (content::WebContents* web_contents : workspace->tabs()) {
+      base::ProcessId pid = GetTabProcessId(web_contents);
+      if (pid != base::kNullProcessId) {
+        ++tabs_per_process[pid];
+      }
+    }
+  }
+  
+  for (const auto& workspace : manager_->GetAllWorkspaces()) {
+    if (workspace->IsActive()) {
+      continue;
+    }
+    
+    std::vector<TabMemory> tabs;
+    for (content::WebContents* web_contents : workspace->tabs()) {
+      base::ProcessId pid = GetTabProcessId(web_contents);
+      auto footprint = process_footprints.find(pid);
+      if (footprint == process_footprints.end()) {
+        continue;
+      }
+      auto* lifecycle_unit =
+          resource_coordinator::TabLifecycleUnitExternal::FromWebContents(
+              web_contents);
+      tabs.push_back({web_contents, footprint->second / tabs_per_process[pid],
+                      web_contents->GetLastActiveTime(),
+                      lifecycle_unit && !IsTabBusy(web_contents) &&
+                          !lifecycle_unit->IsDiscarded()});
+    }
+    
+    // Discarding replaces the WebContents in its tab strip, which the
+    // manager reports back through OnTabRemoved.
+    for (content::WebContents* web_contents :
+         SelectTabsToDiscard(std::move(tabs), memory_budget_bytes_)) {
+      resource_coordinator::TabLifecycleUnitExternal::FromWebContents(
+          web_contents)
+          ->DiscardTab(::mojom::LifecycleUnitDiscardReason::EXTERNAL);
+    }
+  }
+}
+
+void LunetixWorkspaceLifecyclePolicy::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level != base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    EnforceMemoryBudget();
+  }
+}
+
+}  // namespace lunetix
\ No newline at end of file
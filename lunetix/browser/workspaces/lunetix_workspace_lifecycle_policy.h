@@ -0,0 +1,112 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_LIFECYCLE_POLICY_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_LIFECYCLE_POLICY_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+
+namespace content {
+class WebContents;
+}
+
+namespace memory_instrumentation {
+class GlobalMemoryDump;
+}
+
+namespace lunetix {
+
+class LunetixWorkspace;
+class LunetixWorkspaceManager;
+
+// Applies one lifecycle policy to every tab of a workspace. Tabs of a
+// workspace that was left are frozen after a grace period. When it is
+// activated again its most recently used tab thaws right away and the rest
+// follow one per task. Inactive workspaces that exceed the memory budget
+// discard their least recently used tabs.
+class LunetixWorkspaceLifecyclePolicy {
+ public:
+  // A tab of an inactive workspace and its share of its renderer's memory.
+  struct TabMemory {
+    content::WebContents* web_contents;
+    uint64_t bytes;
+    base::TimeTicks last_active_time;
+    // False for tabs that are audible, captured or already discarded.
+    bool can_discard;
+  };
+  
+  explicit LunetixWorkspaceLifecyclePolicy(LunetixWorkspaceManager* manager);
+  ~LunetixWorkspaceLifecyclePolicy();
+  
+  void OnWorkspaceActivated(LunetixWorkspace* workspace);
+  void OnWorkspaceDeactivated(LunetixWorkspace* workspace);
+  void OnTabAssigned(content::WebContents* web_contents,
+                     LunetixWorkspace* workspace);
+  void OnTabActivated(content::WebContents* web_contents);
+  void OnTabRemoved(content::WebContents* web_contents);
+  // Tabs of a collapsed group are hidden and get frozen like the tabs of
+  // an inactive workspace.
+  void OnTabGroupCollapsed(const std::string& group_id, bool collapsed);
+  
+  // Memory each inactive workspace may keep, or 0 for no limit.
+  void SetMemoryBudget(uint64_t bytes);
+  uint64_t memory_budget() const { return memory_budget_bytes_; }
+  
+  bool IsTabFrozen(content::WebContents* web_contents) const {
+    return frozen_tabs_.count(web_contents) != 0;
+  }
+  
+  // The least recently used of one workspace's |tabs| to discard until the
+  // rest fit in |budget_bytes|.
+  static std::vector<content::WebContents*> SelectTabsToDiscard(
+      std::vector<TabMemory> tabs,
+      uint64_t budget_bytes);
+
+ private:
+  void ScheduleFreeze(LunetixWorkspace* workspace);
+  void FreezeWorkspace(const std::string& workspace_id);
+  void FreezeTabGroup(const std::string& group_id);
+  void FreezeTab(content::WebContents* web_contents);
+  void ThawNextTab(int thaw_generation);
+  void ThawTab(content::WebContents* web_contents);
+  
+  void EnforceMemoryBudget();
+  void OnMemoryDumpReceived(
+      bool success,
+      std::unique_ptr<memory_instrumentation::GlobalMemoryDump> dump);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  
+  LunetixWorkspaceManager* const manager_;
+  
+  // Pending freezes of workspaces that were left, by workspace id.
+  std::map<std::string, std::unique_ptr<base::OneShotTimer>> freeze_timers_;
+  // Pending freezes of collapsed tab groups, by group id.
+  std::map<std::string, std::unique_ptr<base::OneShotTimer>>
+      group_freeze_timers_;
+  std::unordered_set<content::WebContents*> frozen_tabs_;
+  
+  // Tabs of the activated workspace still waiting to thaw. Bumping the
+  // generation cancels a thaw that belongs to a previous activation.
+  std::deque<content::WebContents*> thaw_queue_;
+  int thaw_generation_ = 0;
+  
+  uint64_t memory_budget_bytes_ = 0;
+  bool memory_dump_in_progress_ = false;
+  std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+  
+  base::WeakPtrFactory<LunetixWorkspaceLifecyclePolicy> weak_factory_{this};
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixWorkspaceLifecyclePolicy);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_LIFECYCLE_POLICY_H_
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_lifecycle_policy.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/test/bind.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/test/base/browser_with_test_window_test.h"
+#include "content/public/test/web_contents_tester.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+using TabMemory = LunetixWorkspaceLifecyclePolicy::TabMemory;
+
+class LunetixWorkspaceLifecyclePolicyTest : public BrowserWithTestWindowTest {
+ protected:
+  LunetixWorkspaceLifecyclePolicyTest()
+      : BrowserWithTestWindowTest(
+            base::test::TaskEnvironment::TimeSource::MOCK_TIME) {}
+  
+  void SetUp() override {
+    BrowserWithTestWindowTest::SetUp();
+    manager_ = std::make_unique<LunetixWorkspaceManager>(profile());
+    task_environment()->RunUntilIdle();
+    policy_ = manager_->lifecycle_policy();
+  }
+  
+  void TearDown() override {
+    manager_->Shutdown();
+    manager_.reset();
+    BrowserWithTestWindowTest::TearDown();
+  }
+  
+  // Opens a tab in the active workspace, hidden like a background tab, and
+  // last used |idle_time| ago.
+  content::WebContents* AddHiddenTab(const char* url,
+                                     base::TimeDelta idle_time) {
+    AddTab(browser(), GURL(url));
+    content::WebContents* web_contents =
+        browser()->tab_strip_model()->GetWebContentsAt(0);
+    web_contents->WasHidden();
+    content::WebContentsTester::For(web_contents)
+        ->SetLastActiveTime(base::TimeTicks::Now() - idle_time);
+    return web_contents;
+  }
+  
+  std::unique_ptr<LunetixWorkspaceManager> manager_;
+  LunetixWorkspaceLifecyclePolicy* policy_ = nullptr;
+};
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, FreezesAfterGracePeriod) {
+  content::WebContents* tab =
+      AddHiddenTab("https://mail.example/", base::Minutes(1));
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->ActivateWorkspace(work->id());
+  
+  task_environment()->FastForwardBy(base::Seconds(29));
+  EXPECT_FALSE(policy_->IsTabFrozen(tab));
+  
+  task_environment()->FastForwardBy(base::Seconds(1));
+  EXPECT_TRUE(policy_->IsTabFrozen(tab));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, QuickSwitchBackSkipsFreeze) {
+  content::WebContents* tab =
+      AddHiddenTab("https://mail.example/", base::Minutes(1));
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->ActivateWorkspace(work->id());
+  task_environment()->FastForwardBy(base::Seconds(10));
+  manager_->ActivateWorkspace("default");
+  
+  task_environment()->FastForwardBy(base::Minutes(1));
+  EXPECT_FALSE(policy_->IsTabFrozen(tab));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, ThawsMostRecentTabFirst) {
+  content::WebContents* oldest =
+      AddHiddenTab("https://a.example/", base::Minutes(3));
+  content::WebContents* newest =
+      AddHiddenTab("https://b.example/", base::Minutes(1));
+  content::WebContents* middle =
+      AddHiddenTab("https://c.example/", base::Minutes(2));
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->ActivateWorkspace(work->id());
+  task_environment()->FastForwardBy(base::Seconds(30));
+  ASSERT_TRUE(policy_->IsTabFrozen(oldest));
+  ASSERT_TRUE(policy_->IsTabFrozen(newest));
+  ASSERT_TRUE(policy_->IsTabFrozen(middle));
+  
+  manager_->ActivateWorkspace("default");
+  EXPECT_FALSE(policy_->IsTabFrozen(newest));
+  EXPECT_TRUE(policy_->IsTabFrozen(middle));
+  EXPECT_TRUE(policy_->IsTabFrozen(oldest));
+  
+  // The rest thaw one per task, in order of recent use.
+  bool middle_frozen = true;
+  bool oldest_frozen = false;
+  base::SequencedTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::BindLambdaForTesting([&]() {
+        middle_frozen = policy_->IsTabFrozen(middle);
+        oldest_frozen = policy_->IsTabFrozen(oldest);
+      }));
+  task_environment()->RunUntilIdle();
+  EXPECT_FALSE(middle_frozen);
+  EXPECT_TRUE(oldest_frozen);
+  EXPECT_FALSE(policy_->IsTabFrozen(oldest));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, LeavingAgainCancelsThaw) {
+  content::WebContents* first =
+      AddHiddenTab("https://a.example/", base::Minutes(2));
+  content::WebContents* second =
+      AddHiddenTab("https://b.example/", base::Minutes(1));
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->ActivateWorkspace(work->id());
+  task_environment()->FastForwardBy(base::Seconds(30));
+  
+  manager_->ActivateWorkspace("default");
+  manager_->ActivateWorkspace(work->id());
+  task_environment()->RunUntilIdle();
+  EXPECT_FALSE(policy_->IsTabFrozen(second));
+  EXPECT_TRUE(policy_->IsTabFrozen(first));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, FreezesCollapsedGroup) {
+  content::WebContents* grouped =
+      AddHiddenTab("https://a.example/", base::Minutes(1));
+  content::WebContents* other =
+      AddHiddenTab("https://b.example/", base::Minutes(1));
+  manager_->CreateTabGroup({grouped}, "Later", "#1A73E8");
+  std::string group_id = manager_->GetTabGroupForTab(grouped)->id;
+  
+  manager_->CollapseTabGroup(group_id, true);
+  task_environment()->FastForwardBy(base::Seconds(29));
+  EXPECT_FALSE(policy_->IsTabFrozen(grouped));
+  
+  task_environment()->FastForwardBy(base::Seconds(1));
+  EXPECT_TRUE(policy_->IsTabFrozen(grouped));
+  EXPECT_FALSE(policy_->IsTabFrozen(other));
+  
+  manager_->CollapseTabGroup(group_id, false);
+  EXPECT_FALSE(policy_->IsTabFrozen(grouped));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, ExpandingCancelsGroupFreeze) {
+  content::WebContents* grouped =
+      AddHiddenTab("https://a.example/", base::Minutes(1));
+  manager_->CreateTabGroup({grouped}, "Later", "#1A73E8");
+  std::string group_id = manager_->GetTabGroupForTab(grouped)->id;
+  
+  manager_->CollapseTabGroup(group_id, true);
+  task_environment()->FastForwardBy(base::Seconds(10));
+  manager_->CollapseTabGroup(group_id, false);
+  task_environment()->FastForwardBy(base::Minutes(1));
+  EXPECT_FALSE(policy_->IsTabFrozen(grouped));
+}
+
+TEST_F(LunetixWorkspaceLifecyclePolicyTest, DiscardsOldestTabsOverBudget) {
+  content::WebContents* a = AddHiddenTab("https://a.example/", {});
+  content::WebContents* b = AddHiddenTab("https://b.example/", {});
+  content::WebContents* c = AddHiddenTab("https://c.example/", {});
+  base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<TabMemory> tabs = {
+      {a, 100, now - base::Minutes(1), true},
+      {b, 300, now - base::Minutes(3), true},
+      {c, 200, now - base::Minutes(2), true},
+  };
+  
+  EXPECT_TRUE(
+      LunetixWorkspaceLifecyclePolicy::SelectTabsToDiscard(tabs, 600).empty());
+  EXPECT_EQ(std::vector<content::WebContents*>({b}),
+            LunetixWorkspaceLifecyclePolicy::SelectTabsToDiscard(tabs, 350));
+  EXPECT_EQ(std::vector<content::WebContents*>({b, c}),
+            LunetixWorkspaceLifecyclePolicy::SelectTabsToDiscard(tabs, 150));
+  
+  // Tabs in use still count towards the budget but are never discarded.
+  tabs[1].can_discard = false;
+  EXPECT_EQ(std::vector<content::WebContents*>({c, a}),
+            LunetixWorkspaceLifecyclePolicy::SelectTabsToDiscard(tabs, 350));
+}
+
+}  // namespace lunetix
\ No newline at end of file
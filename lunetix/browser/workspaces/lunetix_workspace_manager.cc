@@ -1,17 +1,124 @@
 #include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
 
-#include "base/guid.h"
-#include "base/json/json_reader.h"
-#include "base/json/json_writer.h"
+#include "base/bind.h"
+#include "base/containers/contains.h"
+#include "base/files/file_path.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/utf_string_conversions.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+#include "chrome/browser/lifetime/browser_shutdown.h"
 #include "chrome/browser/profiles/profile.h"
 #include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_finder.h"
 #include "chrome/browser/ui/browser_list.h"
+#include "chrome/browser/ui/tabs/tab_group.h"
+#include "chrome/browser/ui/tabs/tab_group_model.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
-#include "components/prefs/pref_service.h"
+#include "components/sessions/content/session_tab_helper.h"
+#include "components/tab_groups/tab_group_color.h"
+#include "components/tab_groups/tab_group_visual_data.h"
+#include "ui/gfx/range/range.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_archive.h"
 
 namespace lunetix {
 
+namespace {
+
+const base::FilePath::CharType kWorkspacesDirname[] =
+    FILE_PATH_LITERAL("Lunetix Workspaces");
+
+constexpr int kSnapshotVersion = 1;
+
+// Journal records appended before the journal is folded into a snapshot.
+constexpr size_t kMaxJournalRecords = 500;
+
+// How long restored tabs may take to come back into their workspaces.
+constexpr base::TimeDelta kRestoreGracePeriod = base::Minutes(1);
+
+int GetTabId(content::WebContents* web_contents) {
+  return sessions::SessionTabHelper::IdForTab(web_contents).id();
+}
+
+base::Value MakeRecord(const char* op) {
+  base::Value record(base::Value::Type::DICTIONARY);
+  record.SetStringKey("op", op);
+  return record;
+}
+
+// Workspace colors are free-form, tab strip groups take the nearest color
+// of their palette.
+tab_groups::TabGroupColorId GetStripGroupColor(const std::string& color) {
+  static const struct {
+    tab_groups::TabGroupColorId id;
+    uint32_t rgb;
+  } kPalette[] = {
+      {tab_groups::TabGroupColorId::kGrey, 0x5F6368},
+      {tab_groups::TabGroupColorId::kBlue, 0x1A73E8},
+      {tab_groups::TabGroupColorId::kRed, 0xD93025},
+      {tab_groups::TabGroupColorId::kYellow, 0xF9AB00},
+      {tab_groups::TabGroupColorId::kGreen, 0x1E8E3E},
+      {tab_groups::TabGroupColorId::kPink, 0xD01884},
+      {tab_groups::TabGroupColorId::kPurple, 0x9334E6},
+      {tab_groups::TabGroupColorId::kCyan, 0x007B83},
+  };
+  
+  uint32_t rgb = 0;
+  if (color.size() != 7 || color[0] != '#' ||
+      !base::HexStringToUInt(base::StringPiece(color).substr(1), &rgb)) {
+    return tab_groups::TabGroupColorId::kGrey;
+  }
+  
+  auto distance = [rgb](uint32_t other) {
+    int dr = static_cast<int>((rgb >> 16) & 0xFF) - ((other >> 16) & 0xFF);
+    int dg = static_cast<int>((rgb >> 8) & 0xFF) - ((other >> 8) & 0xFF);
+    int db = static_cast<int>(rgb & 0xFF) - (other & 0xFF);
+    return dr * dr + dg * dg + db * db;
+  };
+  tab_groups::TabGroupColorId nearest = kPalette[0].id;
+  int nearest_distance = distance(kPalette[0].rgb);
+  for (const auto& entry : kPalette) {
+    if (distance(entry.rgb) < nearest_distance) {
+      nearest = entry.id;
+      nearest_distance = distance(entry.rgb);
+    }
+  }
+  return nearest;
+}
+
+const std::string& GetString(const base::Value& dict, const char* key) {
+  static const base::NoDestructor<std::string> empty;
+  const std::string* value = dict.FindStringKey(key);
+  return value ? *value : *empty;
+}
+
+}  // namespace
+
+// Tab membership rebuilt from disk before the tabs themselves come back.
+// Tab ids are only unique within the session that journaled them, so tabs
+// from the snapshot are matched by URL and tabs from the journal by id.
+struct LunetixWorkspaceManager::RestoredState {
+  std::unordered_multimap<std::string, std::string> snapshot_tabs;
+  std::map<int, std::pair<std::string, std::string>> journal_tabs;
+  std::string active_workspace_id;
+};
+
+// WorkspaceChangeSet implementation
+
+WorkspaceChangeSet::WorkspaceChangeSet() = default;
+
+WorkspaceChangeSet::WorkspaceChangeSet(WorkspaceChangeSet&& other) = default;
+
+WorkspaceChangeSet& WorkspaceChangeSet::operator=(WorkspaceChangeSet&& other) =
+    default;
+
+WorkspaceChangeSet::~WorkspaceChangeSet() = default;
+
+bool WorkspaceChangeSet::IsEmpty() const {
+  return created.empty() && removed.empty() && renamed.empty() &&
+         recolored.empty() && activated.empty() && moved_tabs.empty();
+}
+
 // LunetixWorkspace implementation
 
 LunetixWorkspace::LunetixWorkspace(const std::string& id, const std::string& name)
@@ -20,53 +127,95 @@ LunetixWorkspace::LunetixWorkspace(const std::string& id, const std::string& nam
 LunetixWorkspace::~LunetixWorkspace() = default;
 
 void LunetixWorkspace::AddTab(content::WebContents* web_contents) {
-  if (std::find(tabs_.begin(), tabs_.end(), web_contents) == tabs_.end()) {
-    tabs_.push_back(web_contents);
+  if (ContainsTab(web_contents)) {
+    return;
   }
+  tab_positions_[web_contents] = tabs_.insert(tabs_.end(), web_contents);
 }
 
 void LunetixWorkspace::RemoveTab(content::WebContents* web_contents) {
-  auto it = std::find(tabs_.begin(), tabs_.end(), web_contents);
-  if (it != tabs_.end()) {
-    tabs_.erase(it);
+  auto it = tab_positions_.find(web_contents);
+  if (it != tab_positions_.end()) {
+    tabs_.erase(it->second);
+    tab_positions_.erase(it);
   }
 }
 
-void LunetixWorkspace::MoveTab(content::WebContents* web_contents, int new_index) {
-  RemoveTab(web_contents);
-  if (new_index >= 0 && new_index <= static_cast<int>(tabs_.size())) {
-    tabs_.insert(tabs_.begin() + new_index, web_contents);
-  } else {
-    tabs_.push_back(web_contents);
+void LunetixWorkspace::MoveTab(content::WebContents* web_contents,
+                               content::WebContents* before) {
+  auto it = tab_positions_.find(web_contents);
+  if (it == tab_positions_.end() || web_contents == before) {
+    return;
+  }
+  
+  auto anchor = tab_positions_.find(before);
+  TabList::iterator position =
+      anchor != tab_positions_.end() ? anchor->second : tabs_.end();
+  
+  // Splicing keeps the iterators stored in |tab_positions_| valid.
+  tabs_.splice(position, tabs_, it->second);
+}
+
+void LunetixWorkspace::ReplaceTab(content::WebContents* old_contents,
+                                  content::WebContents* new_contents) {
+  auto it = tab_positions_.find(old_contents);
+  if (it == tab_positions_.end() || ContainsTab(new_contents)) {
+    return;
   }
+  TabList::iterator position = it->second;
+  *position = new_contents;
+  tab_positions_.erase(it);
+  tab_positions_[new_contents] = position;
+}
+
+bool LunetixWorkspace::ContainsTab(content::WebContents* web_contents) const {
+  return tab_positions_.find(web_contents) != tab_positions_.end();
 }
 
 // LunetixWorkspaceManager implementation
 
-LunetixWorkspaceManager::LunetixWorkspaceManager() {
+LunetixWorkspaceManager::LunetixWorkspaceManager(Profile* profile)
+    : profile_(profile),
+      lifecycle_policy_(
+          std::make_unique<LunetixWorkspaceLifecyclePolicy>(this)),
+      prefetcher_(std::make_unique<LunetixWorkspacePrefetcher>(profile)),
+      store_(std::make_unique<LunetixWorkspaceStore>(
+          profile->GetPath().Append(kWorkspacesDirname))) {
   // Create default workspace
-  auto default_workspace = std::make_unique<LunetixWorkspace>("default", "Main");
-  active_workspace_ = default_workspace.get();
-  workspaces_.push_back(std::move(default_workspace));
+  LunetixWorkspace* default_workspace = AddWorkspace("default", "Main");
+  active_workspace_ = default_workspace;
+  default_workspace->SetActive(true);
+  
+  // Windows opened before the profile's services were built.
+  for (Browser* browser : *BrowserList::GetInstance()) {
+    if (browser->profile() == profile_) {
+      ObserveTabStrip(browser->tab_strip_model());
+    }
+  }
+  BrowserList::AddObserver(this);
   
   LoadWorkspaces();
 }
 
-LunetixWorkspaceManager::~LunetixWorkspaceManager() {
+LunetixWorkspaceManager::~LunetixWorkspaceManager() = default;
+
+void LunetixWorkspaceManager::Shutdown() {
+  BrowserList::RemoveObserver(this);
+  prefetcher_->Cancel();
   SaveWorkspaces();
 }
 
 LunetixWorkspace* LunetixWorkspaceManager::CreateWorkspace(const std::string& name) {
-  std::string id = GenerateWorkspaceId();
-  auto workspace = std::make_unique<LunetixWorkspace>(id, name);
-  LunetixWorkspace* workspace_ptr = workspace.get();
-  
-  workspaces_.push_back(std::move(workspace));
+  LunetixWorkspace* workspace = AddWorkspace(GenerateWorkspaceId(), name);
   
-  NotifyWorkspaceCreated(workspace_ptr);
-  SaveWorkspaces();
+  base::Value record = MakeRecord("create");
+  record.SetStringKey("id", workspace->id());
+  record.SetStringKey("name", name);
+  record.SetStringKey("color", workspace->color());
+  RecordMutation(std::move(record));
   
-  return workspace_ptr;
+  NotifyWorkspaceCreated(workspace);
+  return workspace;
 }
 
 void LunetixWorkspaceManager::RemoveWorkspace(const std::string& workspace_id) {
@@ -74,31 +223,32 @@ void LunetixWorkspaceManager::RemoveWorkspace(const std::string& workspace_id) {
     return;  // Cannot remove default workspace
   }
   
-  auto it = std::find_if(workspaces_.begin(), workspaces_.end(),
-                        [&workspace_id](const std::unique_ptr<LunetixWorkspace>& ws) {
-                          return ws->id() == workspace_id;
-                        });
+  LunetixWorkspace* workspace = GetWorkspace(workspace_id);
+  if (!workspace) {
+    return;
+  }
   
-  if (it != workspaces_.end()) {
-    LunetixWorkspace* workspace = it->get();
-    
-    // Move all tabs to default workspace
-    if (!workspace->tabs().empty()) {
-      LunetixWorkspace* default_workspace = GetWorkspace("default");
-      for (content::WebContents* tab : workspace->tabs()) {
-        default_workspace->AddTab(tab);
-      }
-    }
-    
-    // If this was the active workspace, switch to default
-    if (active_workspace_ == workspace) {
-      ActivateWorkspace("default");
-    }
-    
-    workspaces_.erase(it);
-    NotifyWorkspaceRemoved(workspace_id);
-    SaveWorkspaces();
+  // Move all tabs to default workspace
+  LunetixWorkspace* default_workspace = GetWorkspace("default");
+  while (!workspace->IsEmpty()) {
+    AssignTab(workspace->tabs().front(), default_workspace);
+  }
+  
+  // If this was the active workspace, switch to default
+  if (active_workspace_ == workspace) {
+    ActivateWorkspace("default");
   }
+  
+  if (workspace->IsParked()) {
+    store_->DeleteArchive(workspace_id);
+  }
+  EraseWorkspace(workspace);
+  
+  base::Value record = MakeRecord("remove");
+  record.SetStringKey("id", workspace_id);
+  RecordMutation(std::move(record));
+  
+  NotifyWorkspaceRemoved(workspace_id);
 }
 
 void LunetixWorkspaceManager::RenameWorkspace(const std::string& workspace_id,
@@ -106,8 +256,16 @@ void LunetixWorkspaceManager::RenameWorkspace(const std::string& workspace_id,
   LunetixWorkspace* workspace = GetWorkspace(workspace_id);
   if (workspace) {
     workspace->set_name(new_name);
-    NotifyWorkspaceActivated(workspace);  // Trigger UI update
-    SaveWorkspaces();
+    for (content::WebContents* web_contents : workspace->tabs()) {
+      IndexTab(web_contents);
+    }
+    
+    base::Value record = MakeRecord("rename");
+    record.SetStringKey("id", workspace_id);
+    record.SetStringKey("name", new_name);
+    RecordMutation(std::move(record));
+    
+    NotifyWorkspaceRenamed(workspace);
   }
 }
 
@@ -116,8 +274,101 @@ void LunetixWorkspaceManager::SetWorkspaceColor(const std::string& workspace_id,
   LunetixWorkspace* workspace = GetWorkspace(workspace_id);
   if (workspace) {
     workspace->set_color(color);
-    SaveWorkspaces();
+    
+    base::Value record = MakeRecord("color");
+    record.SetStringKey("id", workspace_id);
+    record.SetStringKey("color", color);
+    RecordMutation(std::move(record));
+    
+    NotifyWorkspaceRecolored(workspace);
+  }
+}
+
+bool LunetixWorkspaceManager::ParkWorkspace(const std::string& workspace_id) {
+  LunetixWorkspace* workspace = GetWorkspace(workspace_id);
+  if (!workspace || workspace_id == "default" || workspace->IsParked() ||
+      base::Contains(parking_workspace_ids_, workspace_id)) {
+    return false;
+  }
+  
+  std::vector<int> tab_ids;
+  std::vector<LunetixArchivedTab> archived_tabs;
+  tab_ids.reserve(workspace->GetTabCount());
+  archived_tabs.reserve(workspace->GetTabCount());
+  for (content::WebContents* web_contents : workspace->tabs()) {
+    int index;
+    TabStripModel* tab_strip = FindTabStrip(web_contents, &index);
+    bool pinned = tab_strip && tab_strip->IsTabPinned(index);
+    archived_tabs.push_back(ArchiveTab(web_contents, pinned));
+    tab_ids.push_back(GetTabId(web_contents));
+  }
+  
+  // Nothing is closed until the archive is known to be on disk.
+  parking_workspace_ids_.insert(workspace_id);
+  store_->WriteArchive(
+      workspace_id, SerializeArchivedTabs(archived_tabs),
+      base::BindOnce(&LunetixWorkspaceManager::OnWorkspaceArchiveWritten,
+                     weak_factory_.GetWeakPtr(), workspace_id,
+                     std::move(tab_ids)));
+  return true;
+}
+
+void LunetixWorkspaceManager::OpenWorkspace(const std::string& workspace_id,
+                                            Browser* browser) {
+  LunetixWorkspace* workspace = GetWorkspace(workspace_id);
+  if (!workspace) {
+    return;
+  }
+  if (!workspace->IsParked()) {
+    ActivateWorkspace(workspace_id);
+    return;
+  }
+  
+  store_->ReadArchive(
+      workspace_id,
+      base::BindOnce(&LunetixWorkspaceManager::OnWorkspaceArchiveRead,
+                     weak_factory_.GetWeakPtr(), workspace_id,
+                     browser->session_id()));
+}
+
+void LunetixWorkspaceManager::SetAutoClusteringEnabled(bool enabled) {
+  if (!enabled) {
+    clusterer_.reset();
+  } else if (!clusterer_) {
+    clusterer_ = std::make_unique<LunetixWorkspaceClusterer>(
+        this, base::BindRepeating(
+                  &LunetixWorkspaceManager::NotifyWorkspaceProposalsReady,
+                  base::Unretained(this)));
+  }
+}
+
+LunetixWorkspace* LunetixWorkspaceManager::AcceptProposalAsWorkspace(
+    const WorkspaceProposal& proposal) {
+  std::vector<content::WebContents*> tabs = GetOpenProposalTabs(proposal);
+  if (tabs.empty()) {
+    return nullptr;
+  }
+  
+  LunetixWorkspace* workspace = CreateWorkspace(proposal.name);
+  MoveTabsToWorkspace(tabs, workspace->id());
+  return workspace;
+}
+
+void LunetixWorkspaceManager::AcceptProposalAsTabGroup(
+    const WorkspaceProposal& proposal) {
+  CreateTabGroup(GetOpenProposalTabs(proposal), proposal.name, "#4285F4");
+}
+
+std::vector<content::WebContents*>
+LunetixWorkspaceManager::GetOpenProposalTabs(
+    const WorkspaceProposal& proposal) const {
+  std::vector<content::WebContents*> tabs;
+  for (int tab_id : proposal.tab_ids) {
+    if (content::WebContents* web_contents = GetTabById(tab_id)) {
+      tabs.push_back(web_contents);
+    }
   }
+  return tabs;
 }
 
 void LunetixWorkspaceManager::ActivateWorkspace(const std::string& workspace_id) {
@@ -125,10 +376,17 @@ void LunetixWorkspaceManager::ActivateWorkspace(const std::string& workspace_id)
   if (workspace && workspace != active_workspace_) {
     if (active_workspace_) {
       active_workspace_->SetActive(false);
+      lifecycle_policy_->OnWorkspaceDeactivated(active_workspace_);
     }
     
     active_workspace_ = workspace;
     workspace->SetActive(true);
+    lifecycle_policy_->OnWorkspaceActivated(workspace);
+    prefetcher_->OnWorkspaceActivated(workspace);
+    
+    base::Value record = MakeRecord("activate");
+    record.SetStringKey("id", workspace_id);
+    RecordMutation(std::move(record));
     
     NotifyWorkspaceActivated(workspace);
   }
@@ -139,11 +397,19 @@ LunetixWorkspace* LunetixWorkspaceManager::GetActiveWorkspace() const {
 }
 
 LunetixWorkspace* LunetixWorkspaceManager::GetWorkspace(const std::string& workspace_id) const {
-  auto it = std::find_if(workspaces_.begin(), workspaces_.end(),
-                        [&workspace_id](const std::unique_ptr<LunetixWorkspace>& ws) {
-                          return ws->id() == workspace_id;
-                        });
-  return it != workspaces_.end() ? it->get() : nullptr;
+  auto it = workspaces_by_id_.find(workspace_id);
+  return it != workspaces_by_id_.end() ? it->second : nullptr;
+}
+
+LunetixWorkspace* LunetixWorkspaceManager::GetWorkspaceForTab(
+    content::WebContents* web_contents) const {
+  auto it = workspace_by_tab_.find(web_contents);
+  return it != workspace_by_tab_.end() ? it->second : nullptr;
+}
+
+content::WebContents* LunetixWorkspaceManager::GetTabById(int tab_id) const {
+  auto it = tabs_by_search_id_.find(tab_id);
+  return it != tabs_by_search_id_.end() ? it->second : nullptr;
 }
 
 const std::vector<std::unique_ptr<LunetixWorkspace>>& 
@@ -153,24 +419,20 @@ LunetixWorkspaceManager::GetAllWorkspaces() const {
 
 void LunetixWorkspaceManager::MoveTabToWorkspace(content::WebContents* web_contents,
                                                 const std::string& workspace_id) {
+  MoveTabsToWorkspace({web_contents}, workspace_id);
+}
+
+void LunetixWorkspaceManager::MoveTabsToWorkspace(
+    const std::vector<content::WebContents*>& tabs,
+    const std::string& workspace_id) {
   LunetixWorkspace* target_workspace = GetWorkspace(workspace_id);
-  if (!target_workspace) {
+  if (!target_workspace || target_workspace->IsParked()) {
     return;
   }
   
-  // Remove from current workspace
-  for (auto& workspace : workspaces_) {
-    workspace->RemoveTab(web_contents);
-  }
-  
-  // Add to target workspace
-  target_workspace->AddTab(web_contents);
-  
-  for (Observer& observer : observers_) {
-    observer.OnTabMovedToWorkspace(web_contents, target_workspace);
+  for (content::WebContents* web_contents : tabs) {
+    AssignTab(web_contents, target_workspace);
   }
-  
-  SaveWorkspaces();
 }
 
 void LunetixWorkspaceManager::CreateTabGroup(const std::vector<content::WebContents*>& tabs,
@@ -180,15 +442,66 @@ void LunetixWorkspaceManager::CreateTabGroup(const std::vector<content::WebConte
     return;
   }
   
-  std::string group_id = GenerateGroupId();
-  auto group = std::make_unique<TabGroup>();
-  group->id = group_id;
-  group->name = group_name;
-  group->color = color;
-  group->tabs = tabs;
+  LunetixWorkspace* workspace = GetWorkspaceForTab(tabs.front());
+  TabGroup* group = CreateTabGroupInWorkspace(
+      workspace ? workspace->id() : std::string(), group_name, color);
+  AddTabsToGroup(group->id, tabs);
+}
+
+void LunetixWorkspaceManager::AddTabsToGroup(
+    const std::string& group_id,
+    const std::vector<content::WebContents*>& tabs) {
+  TabGroup* group = GetTabGroup(group_id);
+  if (!group) {
+    return;
+  }
   
-  tab_groups_[group_id] = std::move(group);
-  SaveWorkspaces();
+  TabStripModel* tab_strip = group->tab_strip;
+  std::vector<int> indices;
+  for (content::WebContents* web_contents : tabs) {
+    int index = TabStripModel::kNoTab;
+    TabStripModel* tab_strip_for_tab = FindTabStrip(web_contents, &index);
+    if (!tab_strip_for_tab) {
+      continue;
+    }
+    if (!tab_strip) {
+      tab_strip = tab_strip_for_tab;
+    }
+    if (tab_strip_for_tab == tab_strip) {
+      indices.push_back(index);
+    }
+  }
+  if (indices.empty()) {
+    return;
+  }
+  std::sort(indices.begin(), indices.end());
+  
+  // The tab strip moves the tabs next to each other.
+  if (group->strip_group) {
+    tab_strip->AddToExistingGroup(indices, *group->strip_group);
+  } else {
+    LinkTabGroup(group, tab_strip, tab_strip->AddToNewGroup(indices));
+    UpdateStripGroupVisuals(group);
+  }
+}
+
+void LunetixWorkspaceManager::UngroupTabs(
+    const std::vector<content::WebContents*>& tabs) {
+  std::map<TabStripModel*, std::vector<int>> indices_by_tab_strip;
+  for (content::WebContents* web_contents : tabs) {
+    int index = TabStripModel::kNoTab;
+    TabStripModel* tab_strip = FindTabStrip(web_contents, &index);
+    if (tab_strip && tab_strip->GetTabGroupForTab(index)) {
+      indices_by_tab_strip[tab_strip].push_back(index);
+    }
+  }
+  
+  // Groups that end up empty are closed by the tab strip, which unlinks
+  // them in OnTabGroupChanged().
+  for (auto& entry : indices_by_tab_strip) {
+    std::sort(entry.second.begin(), entry.second.end());
+    entry.first->RemoveFromGroup(entry.second);
+  }
 }
 
 LunetixWorkspaceManager::TabGroup* LunetixWorkspaceManager::CreateTabGroupInWorkspace(
@@ -201,24 +514,106 @@ LunetixWorkspaceManager::TabGroup* LunetixWorkspaceManager::CreateTabGroupInWork
   group->id = group_id;
   group->name = group_name;
   group->color = color;
+  group->workspace_id = workspace_id;
   
   TabGroup* group_ptr = group.get();
   tab_groups_[group_id] = std::move(group);
   
-  SaveWorkspaces();
+  base::Value record = MakeRecord("group");
+  record.SetStringKey("id", group_id);
+  record.SetStringKey("name", group_name);
+  record.SetStringKey("color", color);
+  record.SetStringKey("workspace", workspace_id);
+  RecordMutation(std::move(record));
+  
   return group_ptr;
 }
 
 void LunetixWorkspaceManager::RemoveTabGroup(const std::string& group_id) {
-  tab_groups_.erase(group_id);
-  SaveWorkspaces();
+  auto it = tab_groups_.find(group_id);
+  if (it == tab_groups_.end()) {
+    return;
+  }
+  
+  TabGroup* group = it->second.get();
+  if (group->collapsed) {
+    SetTabGroupCollapsed(group, false);
+  }
+  if (group->strip_group) {
+    TabStripModel* tab_strip = group->tab_strip;
+    gfx::Range range =
+        tab_strip->group_model()->GetTabGroup(*group->strip_group)->ListTabs();
+    UnlinkTabGroup(group);
+    std::vector<int> indices;
+    for (uint32_t index = range.start(); index < range.end(); ++index) {
+      indices.push_back(static_cast<int>(index));
+    }
+    tab_strip->RemoveFromGroup(indices);
+  }
+  tab_groups_.erase(it);
+  
+  base::Value record = MakeRecord("ungroup");
+  record.SetStringKey("id", group_id);
+  RecordMutation(std::move(record));
 }
 
 void LunetixWorkspaceManager::CollapseTabGroup(const std::string& group_id, bool collapsed) {
+  TabGroup* group = GetTabGroup(group_id);
+  if (group && group->collapsed != collapsed) {
+    SetTabGroupCollapsed(group, collapsed);
+    UpdateStripGroupVisuals(group);
+  }
+}
+
+LunetixWorkspaceManager::TabGroup* LunetixWorkspaceManager::GetTabGroup(
+    const std::string& group_id) const {
   auto it = tab_groups_.find(group_id);
-  if (it != tab_groups_.end()) {
-    it->second->collapsed = collapsed;
+  return it != tab_groups_.end() ? it->second.get() : nullptr;
+}
+
+LunetixWorkspaceManager::TabGroup* LunetixWorkspaceManager::GetTabGroupForTab(
+    content::WebContents* web_contents) const {
+  int index = TabStripModel::kNoTab;
+  TabStripModel* tab_strip = FindTabStrip(web_contents, &index);
+  if (!tab_strip) {
+    return nullptr;
+  }
+  absl::optional<tab_groups::TabGroupId> strip_group =
+      tab_strip->GetTabGroupForTab(index);
+  if (!strip_group) {
+    return nullptr;
   }
+  auto it = tab_groups_by_strip_group_.find(*strip_group);
+  return it != tab_groups_by_strip_group_.end() ? it->second : nullptr;
+}
+
+std::vector<content::WebContents*> LunetixWorkspaceManager::GetTabsInGroup(
+    const std::string& group_id) const {
+  std::vector<content::WebContents*> tabs;
+  TabGroup* group = GetTabGroup(group_id);
+  if (!group || !group->strip_group) {
+    return tabs;
+  }
+  
+  gfx::Range range =
+      group->tab_strip->group_model()->GetTabGroup(*group->strip_group)
+          ->ListTabs();
+  for (uint32_t index = range.start(); index < range.end(); ++index) {
+    tabs.push_back(group->tab_strip->GetWebContentsAt(index));
+  }
+  return tabs;
+}
+
+std::vector<LunetixWorkspaceManager::TabSearchResult>
+LunetixWorkspaceManager::SearchTabs(const std::u16string& query,
+                                    size_t max_results) const {
+  std::vector<TabSearchResult> results;
+  for (const auto& match : search_index_.Search(query, max_results)) {
+    content::WebContents* web_contents = tabs_by_search_id_.at(match.tab_id);
+    results.push_back(
+        {web_contents, GetWorkspaceForTab(web_contents), match.score});
+  }
+  return results;
 }
 
 void LunetixWorkspaceManager::AddObserver(Observer* observer) {
@@ -237,55 +632,740 @@ void LunetixWorkspaceManager::OnTabStripModelChanged(
   // Handle tab changes and update workspace accordingly
   if (change.type() == TabStripModelChange::kInserted) {
     for (const auto& contents : change.GetInsert()->contents) {
-      if (active_workspace_) {
-        active_workspace_->AddTab(contents.contents);
-      }
+      OnTabInserted(tab_strip_model, contents.contents);
     }
+  } else if (change.type() == TabStripModelChange::kReplaced) {
+    const TabStripModelChange::Replace* replace = change.GetReplace();
+    tab_strip_by_tab_.erase(replace->old_contents);
+    tab_strip_by_tab_[replace->new_contents] = tab_strip_model;
+    ReplaceTab(replace->old_contents, replace->new_contents);
   } else if (change.type() == TabStripModelChange::kRemoved) {
+    // Tabs of windows closed on exit keep their workspace, so that session
+    // restore brings them back where they were. A window closed on its own
+    // is not restored, and its tabs must not claim later tabs by URL.
+    bool keep_membership = tab_strip_model->closing_all() &&
+                           browser_shutdown::HasShutdownStarted();
     for (const auto& contents : change.GetRemove()->contents) {
-      for (auto& workspace : workspaces_) {
-        workspace->RemoveTab(contents.contents);
+      // Tabs dragged to another window stay in their workspace; the other
+      // window's strip reports them as inserted.
+      if (contents.remove_reason ==
+          TabStripModelChange::RemoveReason::kInsertedIntoOtherTabStrip) {
+        continue;
       }
+      tab_strip_by_tab_.erase(contents.contents);
+      LunetixWorkspace* workspace = GetWorkspaceForTab(contents.contents);
+      if (keep_membership && workspace) {
+        pending_tab_workspaces_.emplace(
+            contents.contents->GetVisibleURL().spec(), workspace->id());
+      }
+      UnassignTab(contents.contents);
     }
   }
   
-  SaveWorkspaces();
+  if (selection.active_tab_changed() && selection.new_contents) {
+    lifecycle_policy_->OnTabActivated(selection.new_contents);
+    if (clusterer_) {
+      clusterer_->OnTabActivated(selection.old_contents,
+                                 selection.new_contents);
+    }
+  }
+}
+
+void LunetixWorkspaceManager::OnTabGroupChanged(const TabGroupChange& change) {
+  auto it = tab_groups_by_strip_group_.find(change.group);
+  if (it == tab_groups_by_strip_group_.end()) {
+    return;
+  }
+  TabGroup* group = it->second;
+  
+  if (change.type == TabGroupChange::kClosed) {
+    // The group outlives its last tab, like a group that never had any.
+    UnlinkTabGroup(group);
+  } else if (change.type == TabGroupChange::kVisualsChanged) {
+    // Collapsing from the tab strip itself.
+    const tab_groups::TabGroupVisualData* visual_data =
+        change.model->group_model()->GetTabGroup(change.group)->visual_data();
+    if (visual_data->is_collapsed() != group->collapsed) {
+      SetTabGroupCollapsed(group, visual_data->is_collapsed());
+    }
+  }
+}
+
+void LunetixWorkspaceManager::TabChangedAt(content::WebContents* contents,
+                                           int index,
+                                           TabChangeType change_type) {
+  // Title and URL changes come as full updates; loading progress does not
+  // change anything that is searched.
+  if (change_type == TabChangeType::kAll &&
+      base::Contains(workspace_by_tab_, contents)) {
+    IndexTab(contents);
+  }
+}
+
+void LunetixWorkspaceManager::OnBrowserAdded(Browser* browser) {
+  if (browser->profile() == profile_) {
+    ObserveTabStrip(browser->tab_strip_model());
+  }
+}
+
+void LunetixWorkspaceManager::OnBrowserRemoved(Browser* browser) {
+  if (browser->profile() == profile_) {
+    browser->tab_strip_model()->RemoveObserver(this);
+  }
 }
 
 void LunetixWorkspaceManager::SaveWorkspaces() {
-  // Implementation would save workspace state to preferences
-  // This is a simplified version
+  // Until the stored state has been read back, a snapshot would lose it.
+  if (!workspaces_loaded_) {
+    return;
+  }
+  store_->WriteSnapshot(BuildSnapshot());
 }
 
 void LunetixWorkspaceManager::LoadWorkspaces() {
-  // Implementation would load workspace state from preferences
-  // This is a simplified version
+  store_->Load(base::BindOnce(&LunetixWorkspaceManager::OnWorkspacesLoaded,
+                              weak_factory_.GetWeakPtr()));
 }
 
 void LunetixWorkspaceManager::NotifyWorkspaceCreated(LunetixWorkspace* workspace) {
+  GetPendingChanges()->created.push_back(workspace->id());
+}
+
+void LunetixWorkspaceManager::NotifyWorkspaceRemoved(const std::string& workspace_id) {
+  WorkspaceChangeSet* changes = GetPendingChanges();
+  auto erase_id = [&workspace_id](std::vector<std::string>* ids) {
+    ids->erase(std::remove(ids->begin(), ids->end(), workspace_id),
+               ids->end());
+  };
+  erase_id(&changes->renamed);
+  erase_id(&changes->recolored);
+  
+  // Observers never saw a workspace that lived for less than a task.
+  auto created = std::find(changes->created.begin(), changes->created.end(),
+                           workspace_id);
+  if (created != changes->created.end()) {
+    changes->created.erase(created);
+  } else {
+    changes->removed.push_back(workspace_id);
+  }
+}
+
+void LunetixWorkspaceManager::NotifyWorkspaceActivated(LunetixWorkspace* workspace) {
+  GetPendingChanges()->activated = workspace->id();
+}
+
+void LunetixWorkspaceManager::NotifyWorkspaceRenamed(LunetixWorkspace* workspace) {
+  WorkspaceChangeSet* changes = GetPendingChanges();
+  if (!base::Contains(changes->renamed, workspace->id())) {
+    changes->renamed.push_back(workspace->id());
+  }
+}
+
+void LunetixWorkspaceManager::NotifyWorkspaceRecolored(
+    LunetixWorkspace* workspace) {
+  WorkspaceChangeSet* changes = GetPendingChanges();
+  if (!base::Contains(changes->recolored, workspace->id())) {
+    changes->recolored.push_back(workspace->id());
+  }
+}
+
+void LunetixWorkspaceManager::NotifyTabMoved(content::WebContents* web_contents,
+                                             LunetixWorkspace* workspace) {
+  GetPendingChanges()->moved_tabs[web_contents] = workspace->id();
+}
+
+WorkspaceChangeSet* LunetixWorkspaceManager::GetPendingChanges() {
+  if (!changes_delivery_scheduled_) {
+    changes_delivery_scheduled_ = true;
+    base::SequencedTaskRunnerHandle::Get()->PostTask(
+        FROM_HERE,
+        base::BindOnce(&LunetixWorkspaceManager::DeliverPendingChanges,
+                       weak_factory_.GetWeakPtr()));
+  }
+  return &pending_changes_;
+}
+
+void LunetixWorkspaceManager::NotifyWorkspaceProposalsReady(
+    const std::vector<WorkspaceProposal>& proposals) {
   for (Observer& observer : observers_) {
-    observer.OnWorkspaceCreated(workspace);
+    observer.OnWorkspaceProposalsReady(proposals);
   }
 }
 
-void LunetixWorkspaceManager::NotifyWorkspaceRemoved(const std::string& workspace_id) {
+void LunetixWorkspaceManager::NotifyWorkspaceArchiveFailed(
+    const std::string& workspace_id) {
   for (Observer& observer : observers_) {
-    observer.OnWorkspaceRemoved(workspace_id);
+    observer.OnWorkspaceArchiveFailed(workspace_id);
   }
 }
 
-void LunetixWorkspaceManager::NotifyWorkspaceActivated(LunetixWorkspace* workspace) {
+void LunetixWorkspaceManager::DeliverPendingChanges() {
+  changes_delivery_scheduled_ = false;
+  WorkspaceChangeSet changes = std::move(pending_changes_);
+  pending_changes_ = WorkspaceChangeSet();
+  if (changes.IsEmpty()) {
+    return;
+  }
+  
   for (Observer& observer : observers_) {
-    observer.OnWorkspaceActivated(workspace);
+    observer.OnWorkspacesChanged(changes);
+  }
+}
+
+LunetixWorkspace* LunetixWorkspaceManager::AddWorkspace(const std::string& id,
+                                                        const std::string& name) {
+  auto workspace = std::make_unique<LunetixWorkspace>(id, name);
+  LunetixWorkspace* workspace_ptr = workspace.get();
+  workspaces_by_id_[id] = workspace_ptr;
+  workspaces_.push_back(std::move(workspace));
+  return workspace_ptr;
+}
+
+void LunetixWorkspaceManager::EraseWorkspace(LunetixWorkspace* workspace) {
+  workspaces_by_id_.erase(workspace->id());
+  workspaces_.erase(std::find_if(
+      workspaces_.begin(), workspaces_.end(),
+      [workspace](const std::unique_ptr<LunetixWorkspace>& ws) {
+        return ws.get() == workspace;
+      }));
+}
+
+void LunetixWorkspaceManager::ObserveTabStrip(TabStripModel* tab_strip) {
+  tab_strip->AddObserver(this);
+  for (int i = 0; i < tab_strip->count(); ++i) {
+    OnTabInserted(tab_strip, tab_strip->GetWebContentsAt(i));
+  }
+}
+
+void LunetixWorkspaceManager::OnTabInserted(
+    TabStripModel* tab_strip,
+    content::WebContents* web_contents) {
+  tab_strip_by_tab_[web_contents] = tab_strip;
+  // A tab moved in from another window keeps its workspace.
+  if (base::Contains(workspace_by_tab_, web_contents)) {
+    return;
+  }
+  LunetixWorkspace* workspace = TakeRestoredWorkspace(web_contents);
+  if (!workspace) {
+    workspace = active_workspace_;
+  }
+  if (workspace) {
+    AssignTab(web_contents, workspace);
+  }
+}
+
+TabStripModel* LunetixWorkspaceManager::FindTabStrip(
+    content::WebContents* web_contents,
+    int* index) const {
+  auto it = tab_strip_by_tab_.find(web_contents);
+  if (it == tab_strip_by_tab_.end()) {
+    return nullptr;
+  }
+  *index = it->second->GetIndexOfWebContents(web_contents);
+  return *index != TabStripModel::kNoTab ? it->second : nullptr;
+}
+
+void LunetixWorkspaceManager::AssignTab(content::WebContents* web_contents,
+                                        LunetixWorkspace* workspace) {
+  LunetixWorkspace*& current = workspace_by_tab_[web_contents];
+  if (current == workspace) {
+    return;
+  }
+  if (current) {
+    current->RemoveTab(web_contents);
+  }
+  current = workspace;
+  workspace->AddTab(web_contents);
+  IndexTab(web_contents);
+  lifecycle_policy_->OnTabAssigned(web_contents, workspace);
+  NotifyTabMoved(web_contents, workspace);
+  if (clusterer_) {
+    clusterer_->OnTabsChanged();
+  }
+  
+  // The URL is only used to match the tab after a crash; snapshots pick up
+  // the current URL of every tab.
+  base::Value record = MakeRecord("assign");
+  record.SetIntKey("tab", GetTabId(web_contents));
+  record.SetStringKey("url", web_contents->GetVisibleURL().spec());
+  record.SetStringKey("workspace", workspace->id());
+  RecordMutation(std::move(record));
+}
+
+void LunetixWorkspaceManager::UnassignTab(content::WebContents* web_contents) {
+  auto it = workspace_by_tab_.find(web_contents);
+  if (it == workspace_by_tab_.end()) {
+    return;
+  }
+  it->second->RemoveTab(web_contents);
+  workspace_by_tab_.erase(it);
+  UnindexTab(web_contents);
+  lifecycle_policy_->OnTabRemoved(web_contents);
+  pending_changes_.moved_tabs.erase(web_contents);
+  if (clusterer_) {
+    clusterer_->OnTabsChanged();
+  }
+  
+  base::Value record = MakeRecord("unassign");
+  record.SetIntKey("tab", GetTabId(web_contents));
+  RecordMutation(std::move(record));
+}
+
+void LunetixWorkspaceManager::ReplaceTab(content::WebContents* old_contents,
+                                         content::WebContents* new_contents) {
+  auto it = workspace_by_tab_.find(old_contents);
+  if (it == workspace_by_tab_.end()) {
+    return;
+  }
+  LunetixWorkspace* workspace = it->second;
+  workspace->ReplaceTab(old_contents, new_contents);
+  workspace_by_tab_.erase(it);
+  workspace_by_tab_[new_contents] = workspace;
+  UnindexTab(old_contents);
+  IndexTab(new_contents);
+  lifecycle_policy_->OnTabRemoved(old_contents);
+  pending_changes_.moved_tabs.erase(old_contents);
+  
+  base::Value unassign = MakeRecord("unassign");
+  unassign.SetIntKey("tab", GetTabId(old_contents));
+  RecordMutation(std::move(unassign));
+  
+  base::Value assign = MakeRecord("assign");
+  assign.SetIntKey("tab", GetTabId(new_contents));
+  assign.SetStringKey("url", new_contents->GetVisibleURL().spec());
+  assign.SetStringKey("workspace", workspace->id());
+  RecordMutation(std::move(assign));
+}
+
+void LunetixWorkspaceManager::IndexTab(content::WebContents* web_contents) {
+  int tab_id = GetTabId(web_contents);
+  if (tab_id == SessionID::InvalidValue().id()) {
+    return;
+  }
+  LunetixWorkspace* workspace = GetWorkspaceForTab(web_contents);
+  search_index_.Update(
+      tab_id, web_contents->GetTitle(), web_contents->GetVisibleURL().spec(),
+      workspace ? base::UTF8ToUTF16(workspace->name()) : std::u16string());
+  tabs_by_search_id_[tab_id] = web_contents;
+}
+
+void LunetixWorkspaceManager::UnindexTab(content::WebContents* web_contents) {
+  int tab_id = GetTabId(web_contents);
+  search_index_.Remove(tab_id);
+  tabs_by_search_id_.erase(tab_id);
+}
+
+void LunetixWorkspaceManager::LinkTabGroup(
+    TabGroup* group,
+    TabStripModel* tab_strip,
+    const tab_groups::TabGroupId& strip_group) {
+  group->tab_strip = tab_strip;
+  group->strip_group = strip_group;
+  tab_groups_by_strip_group_[strip_group] = group;
+}
+
+void LunetixWorkspaceManager::UnlinkTabGroup(TabGroup* group) {
+  if (group->strip_group) {
+    tab_groups_by_strip_group_.erase(*group->strip_group);
+  }
+  group->tab_strip = nullptr;
+  group->strip_group.reset();
+}
+
+void LunetixWorkspaceManager::UpdateStripGroupVisuals(TabGroup* group) {
+  if (!group->strip_group) {
+    return;
+  }
+  group->tab_strip->group_model()
+      ->GetTabGroup(*group->strip_group)
+      ->SetVisualData(tab_groups::TabGroupVisualData(
+          base::UTF8ToUTF16(group->name), GetStripGroupColor(group->color),
+          group->collapsed));
+}
+
+void LunetixWorkspaceManager::SetTabGroupCollapsed(TabGroup* group,
+                                                   bool collapsed) {
+  group->collapsed = collapsed;
+  lifecycle_policy_->OnTabGroupCollapsed(group->id, collapsed);
+  
+  base::Value record = MakeRecord("collapse");
+  record.SetStringKey("id", group->id);
+  record.SetBoolKey("collapsed", collapsed);
+  RecordMutation(std::move(record));
+}
+
+LunetixWorkspace* LunetixWorkspaceManager::TakeRestoredWorkspace(
+    content::WebContents* web_contents) {
+  if (pending_tab_workspaces_.empty()) {
+    return nullptr;
+  }
+  auto it = pending_tab_workspaces_.find(web_contents->GetVisibleURL().spec());
+  if (it == pending_tab_workspaces_.end()) {
+    return nullptr;
+  }
+  LunetixWorkspace* workspace = GetWorkspace(it->second);
+  pending_tab_workspaces_.erase(it);
+  return workspace;
+}
+
+void LunetixWorkspaceManager::DropPendingTabs() {
+  pending_tab_workspaces_.clear();
+}
+
+void LunetixWorkspaceManager::RecordMutation(base::Value record) {
+  store_->AppendRecord(std::move(record));
+  if (store_->journal_size() >= kMaxJournalRecords) {
+    SaveWorkspaces();
+  }
+}
+
+base::Value LunetixWorkspaceManager::BuildSnapshot() const {
+  std::unordered_map<std::string, base::Value> pending_tabs;
+  for (const auto& pending : pending_tab_workspaces_) {
+    base::Value& urls = pending_tabs[pending.second];
+    if (urls.is_none()) {
+      urls = base::Value(base::Value::Type::LIST);
+    }
+    urls.Append(pending.first);
+  }
+  
+  base::Value workspaces(base::Value::Type::LIST);
+  for (const auto& workspace : workspaces_) {
+    base::Value tabs(base::Value::Type::LIST);
+    for (content::WebContents* web_contents : workspace->tabs()) {
+      const GURL& url = web_contents->GetVisibleURL();
+      if (url.is_valid()) {
+        tabs.Append(url.spec());
+      }
+    }
+    auto pending = pending_tabs.find(workspace->id());
+    if (pending != pending_tabs.end()) {
+      for (base::Value& url : pending->second.GetList()) {
+        tabs.Append(std::move(url));
+      }
+    }
+    
+    base::Value entry(base::Value::Type::DICTIONARY);
+    entry.SetStringKey("id", workspace->id());
+    entry.SetStringKey("name", workspace->name());
+    entry.SetStringKey("color", workspace->color());
+    entry.SetBoolKey("parked", workspace->IsParked());
+    entry.SetKey("tabs", std::move(tabs));
+    workspaces.Append(std::move(entry));
+  }
+  
+  base::Value groups(base::Value::Type::LIST);
+  for (const auto& group : tab_groups_) {
+    base::Value entry(base::Value::Type::DICTIONARY);
+    entry.SetStringKey("id", group.second->id);
+    entry.SetStringKey("name", group.second->name);
+    entry.SetStringKey("color", group.second->color);
+    entry.SetStringKey("workspace", group.second->workspace_id);
+    entry.SetBoolKey("collapsed", group.second->collapsed);
+    groups.Append(std::move(entry));
+  }
+  
+  base::Value snapshot(base::Value::Type::DICTIONARY);
+  snapshot.SetIntKey("version", kSnapshotVersion);
+  snapshot.SetStringKey("active", active_workspace_->id());
+  snapshot.SetKey("workspaces", std::move(workspaces));
+  snapshot.SetKey("groups", std::move(groups));
+  return snapshot;
+}
+
+void LunetixWorkspaceManager::OnWorkspaceArchiveWritten(
+    const std::string& workspace_id,
+    std::vector<int> tab_ids,
+    bool success) {
+  parking_workspace_ids_.erase(workspace_id);
+  LunetixWorkspace* workspace = GetWorkspace(workspace_id);
+  if (!workspace) {
+    // Removed while its archive was being written.
+    store_->DeleteArchive(workspace_id);
+    return;
+  }
+  if (!success) {
+    NotifyWorkspaceArchiveFailed(workspace_id);
+    return;
+  }
+  
+  if (workspace == active_workspace_) {
+    ActivateWorkspace("default");
+  }
+  
+  workspace->SetParked(true);
+  base::Value record = MakeRecord("park");
+  record.SetStringKey("id", workspace_id);
+  RecordMutation(std::move(record));
+  
+  // The tabs may have changed while the archive was written. Only those in
+  // it are closed; tabs that joined since move to the default workspace.
+  std::vector<content::WebContents*> tabs;
+  for (int tab_id : tab_ids) {
+    auto it = tabs_by_search_id_.find(tab_id);
+    if (it != tabs_by_search_id_.end() &&
+        workspace->ContainsTab(it->second)) {
+      tabs.push_back(it->second);
+    }
+  }
+  
+  // Release the tabs. They are unassigned first, since closing a tab with
+  // an unload handler can outlive this call.
+  for (content::WebContents* web_contents : tabs) {
+    UnassignTab(web_contents);
+  }
+  LunetixWorkspace* default_workspace = GetWorkspace("default");
+  while (!workspace->IsEmpty()) {
+    AssignTab(workspace->tabs().front(), default_workspace);
+  }
+  for (content::WebContents* web_contents : tabs) {
+    int index;
+    if (TabStripModel* tab_strip = FindTabStrip(web_contents, &index)) {
+      tab_strip->CloseWebContentsAt(index, TabStripModel::CLOSE_NONE);
+    }
+  }
+}
+
+void LunetixWorkspaceManager::OnWorkspaceArchiveRead(
+    const std::string& workspace_id,
+    SessionID browser_id,
+    std::string data) {
+  LunetixWorkspace* workspace = GetWorkspace(workspace_id);
+  Browser* browser = chrome::FindBrowserWithID(browser_id);
+  if (!workspace || !workspace->IsParked() || !browser) {
+    return;
+  }
+  
+  // Unparking without the archive would lose the tabs for good. The
+  // workspace stays parked, so opening it can be retried.
+  std::vector<LunetixArchivedTab> archived_tabs;
+  if (!DeserializeArchivedTabs(data, &archived_tabs)) {
+    NotifyWorkspaceArchiveFailed(workspace_id);
+    return;
+  }
+  
+  workspace->SetParked(false);
+  base::Value record = MakeRecord("unpark");
+  record.SetStringKey("id", workspace_id);
+  RecordMutation(std::move(record));
+  
+  ActivateWorkspace(workspace_id);
+  
+  // Only the first tab is selected and loads; the others stay placeholders
+  // without a renderer until they are activated.
+  bool select = true;
+  for (const LunetixArchivedTab& archived_tab : archived_tabs) {
+    content::WebContents* web_contents =
+        RestoreArchivedTab(browser, archived_tab, select);
+    if (web_contents) {
+      AssignTab(web_contents, workspace);
+      select = false;
+    }
+  }
+  
+  store_->DeleteArchive(workspace_id);
+}
+
+void LunetixWorkspaceManager::OnWorkspacesLoaded(
+    std::unique_ptr<LunetixWorkspaceStore::LoadResult> result) {
+  RestoredState state;
+  if (result->snapshot.is_dict()) {
+    ApplySnapshot(result->snapshot, &state);
+  }
+  for (const base::Value& record : result->journal) {
+    ApplyRecord(record, &state);
+  }
+  
+  for (auto& tab : state.snapshot_tabs) {
+    pending_tab_workspaces_.emplace(std::move(tab));
+  }
+  for (auto& tab : state.journal_tabs) {
+    pending_tab_workspaces_.emplace(std::move(tab.second));
+  }
+  pending_tab_timer_.Start(FROM_HERE, kRestoreGracePeriod, this,
+                           &LunetixWorkspaceManager::DropPendingTabs);
+  
+  workspaces_loaded_ = true;
+  
+  for (const auto& workspace : workspaces_) {
+    if (workspace->id() != "default") {
+      NotifyWorkspaceCreated(workspace.get());
+    }
+  }
+  ActivateWorkspace(state.active_workspace_id);
+  
+  // Tabs that were inserted while the state was loading.
+  std::vector<content::WebContents*> tabs;
+  for (const auto& tab : workspace_by_tab_) {
+    tabs.push_back(tab.first);
+  }
+  for (content::WebContents* web_contents : tabs) {
+    LunetixWorkspace* workspace = TakeRestoredWorkspace(web_contents);
+    if (workspace) {
+      AssignTab(web_contents, workspace);
+    }
+  }
+  
+  // Start every session from a fresh snapshot, since the journal's tab ids
+  // mean nothing once this session allocates its own.
+  SaveWorkspaces();
+}
+
+void LunetixWorkspaceManager::ApplySnapshot(const base::Value& snapshot,
+                                            RestoredState* state) {
+  if (snapshot.FindIntKey("version").value_or(0) != kSnapshotVersion) {
+    return;
+  }
+  
+  if (const base::Value* workspaces = snapshot.FindListKey("workspaces")) {
+    for (const base::Value& entry : workspaces->GetList()) {
+      if (!entry.is_dict()) {
+        continue;
+      }
+      const std::string& id = GetString(entry, "id");
+      if (id.empty()) {
+        continue;
+      }
+      LunetixWorkspace* workspace = GetWorkspace(id);
+      if (!workspace) {
+        workspace = AddWorkspace(id, GetString(entry, "name"));
+      } else {
+        workspace->set_name(GetString(entry, "name"));
+      }
+      workspace->set_color(GetString(entry, "color"));
+      workspace->SetParked(entry.FindBoolKey("parked").value_or(false));
+      
+      if (const base::Value* tabs = entry.FindListKey("tabs")) {
+        for (const base::Value& url : tabs->GetList()) {
+          if (url.is_string()) {
+            state->snapshot_tabs.emplace(url.GetString(), id);
+          }
+        }
+      }
+    }
+  }
+  
+  if (const base::Value* groups = snapshot.FindListKey("groups")) {
+    for (const base::Value& entry : groups->GetList()) {
+      if (!entry.is_dict()) {
+        continue;
+      }
+      const std::string& id = GetString(entry, "id");
+      if (id.empty() || tab_groups_.count(id)) {
+        continue;
+      }
+      auto group = std::make_unique<TabGroup>();
+      group->id = id;
+      group->name = GetString(entry, "name");
+      group->color = GetString(entry, "color");
+      group->workspace_id = GetString(entry, "workspace");
+      group->collapsed = entry.FindBoolKey("collapsed").value_or(false);
+      tab_groups_[id] = std::move(group);
+    }
+  }
+  
+  state->active_workspace_id = GetString(snapshot, "active");
+}
+
+void LunetixWorkspaceManager::ApplyRecord(const base::Value& record,
+                                          RestoredState* state) {
+  const std::string& op = GetString(record, "op");
+  const std::string& id = GetString(record, "id");
+  
+  if (op == "create") {
+    if (!id.empty() && !GetWorkspace(id)) {
+      AddWorkspace(id, GetString(record, "name"))
+          ->set_color(GetString(record, "color"));
+    }
+  } else if (op == "remove") {
+    LunetixWorkspace* workspace = GetWorkspace(id);
+    if (!workspace || id == "default") {
+      return;
+    }
+    EraseWorkspace(workspace);
+    // Tabs of a removed workspace fall back to the default one, as they do
+    // when it is removed live.
+    for (auto& tab : state->snapshot_tabs) {
+      if (tab.second == id) {
+        tab.second = "default";
+      }
+    }
+    for (auto& tab : state->journal_tabs) {
+      if (tab.second.second == id) {
+        tab.second.second = "default";
+      }
+    }
+    if (state->active_workspace_id == id) {
+      state->active_workspace_id = "default";
+    }
+  } else if (op == "rename") {
+    if (LunetixWorkspace* workspace = GetWorkspace(id)) {
+      workspace->set_name(GetString(record, "name"));
+    }
+  } else if (op == "color") {
+    if (LunetixWorkspace* workspace = GetWorkspace(id)) {
+      workspace->set_color(GetString(record, "color"));
+    }
+  } else if (op == "park" || op == "unpark") {
+    if (LunetixWorkspace* workspace = GetWorkspace(id)) {
+      workspace->SetParked(op == "park");
+    }
+  } else if (op == "activate") {
+    state->active_workspace_id = id;
+  } else if (op == "assign") {
+    absl::optional<int> tab = record.FindIntKey("tab");
+    if (!tab) {
+      return;
+    }
+    const std::string& url = GetString(record, "url");
+    auto it = state->journal_tabs.find(*tab);
+    if (it == state->journal_tabs.end()) {
+      // The first assignment of a tab that came from the snapshot.
+      auto restored = state->snapshot_tabs.find(url);
+      if (restored != state->snapshot_tabs.end()) {
+        state->snapshot_tabs.erase(restored);
+      }
+      it = state->journal_tabs.emplace(*tab, std::make_pair(url, "")).first;
+    }
+    it->second.second = GetString(record, "workspace");
+  } else if (op == "unassign") {
+    absl::optional<int> tab = record.FindIntKey("tab");
+    if (tab) {
+      state->journal_tabs.erase(*tab);
+    }
+  } else if (op == "group") {
+    if (!id.empty() && !tab_groups_.count(id)) {
+      auto group = std::make_unique<TabGroup>();
+      group->id = id;
+      group->name = GetString(record, "name");
+      group->color = GetString(record, "color");
+      group->workspace_id = GetString(record, "workspace");
+      tab_groups_[id] = std::move(group);
+    }
+  } else if (op == "ungroup") {
+    tab_groups_.erase(id);
+  } else if (op == "collapse") {
+    auto it = tab_groups_.find(id);
+    if (it != tab_groups_.end()) {
+      it->second->collapsed = record.FindBoolKey("collapsed").value_or(false);
+    }
   }
 }
 
 std::string LunetixWorkspaceManager::GenerateWorkspaceId() {
-  return "workspace_" + base::NumberToString(next_workspace_id_++);
+  std::string id;
+  do {
+    id = "workspace_" + base::NumberToString(next_workspace_id_++);
+  } while (GetWorkspace(id));
+  return id;
 }
 
 std::string LunetixWorkspaceManager::GenerateGroupId() {
-  return "group_" + base::NumberToString(next_group_id_++);
+  std::string id;
+  do {
+    id = "group_" + base::NumberToString(next_group_id_++);
+  } while (tab_groups_.count(id));
+  return id;
 }
 
 }  // namespace lunetix
\ No newline at end of file
@@ -1,18 +1,45 @@
 #ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_MANAGER_H_
 #define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_MANAGER_H_
 
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "base/memory/weak_ptr.h"
 #include "base/observer_list.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+#include "chrome/browser/ui/browser_list_observer.h"
 #include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "components/sessions/core/session_id.h"
+#include "components/tab_groups/tab_group_id.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
 #include "content/public/browser/web_contents.h"
+#include "lunetix/browser/tab_search/lunetix_tab_search_index.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_clusterer.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_lifecycle_policy.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_prefetcher.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_store.h"
+
+class Browser;
+class Profile;
 
 namespace lunetix {
 
+// Tabs are kept in order in a list, with a hash index from WebContents to
+// its list position, so membership checks and removal are O(1).
 class LunetixWorkspace {
  public:
+  using TabList = std::list<content::WebContents*>;
+  
   LunetixWorkspace(const std::string& id, const std::string& name);
   ~LunetixWorkspace();
-
+  
   const std::string& id() const { return id_; }
   const std::string& name() const { return name_; }
   void set_name(const std::string& name) { name_ = name; }
@@ -20,11 +47,19 @@ class LunetixWorkspace {
   const std::string& color() const { return color_; }
   void set_color(const std::string& color) { color_ = color; }
   
-  const std::vector<content::WebContents*>& tabs() const { return tabs_; }
+  const TabList& tabs() const { return tabs_; }
   
   void AddTab(content::WebContents* web_contents);
   void RemoveTab(content::WebContents* web_contents);
-  void MoveTab(content::WebContents* web_contents, int new_index);
+  // Puts |new_contents| where |old_contents| was.
+  void ReplaceTab(content::WebContents* old_contents,
+                  content::WebContents* new_contents);
+  // Puts |web_contents| in front of |before|, or last if |before| is null
+  // or not in the workspace. Both are found through the position index, so
+  // nothing walks the list.
+  void MoveTab(content::WebContents* web_contents,
+               content::WebContents* before);
+  bool ContainsTab(content::WebContents* web_contents) const;
   
   bool IsEmpty() const { return tabs_.empty(); }
   size_t GetTabCount() const { return tabs_.size(); }
@@ -32,67 +67,163 @@ class LunetixWorkspace {
   void SetActive(bool active) { is_active_ = active; }
   bool IsActive() const { return is_active_; }
   
+  // A parked workspace has no tabs in memory; they wait on disk until the
+  // workspace is opened again.
+  void SetParked(bool parked) { is_parked_ = parked; }
+  bool IsParked() const { return is_parked_; }
+  
  private:
   std::string id_;
   std::string name_;
   std::string color_;
-  std::vector<content::WebContents*> tabs_;
+  TabList tabs_;
+  std::unordered_map<content::WebContents*, TabList::iterator> tab_positions_;
   bool is_active_ = false;
+  bool is_parked_ = false;
   
   DISALLOW_COPY_AND_ASSIGN(LunetixWorkspace);
 };
 
-class LunetixWorkspaceManager : public TabStripModelObserver {
+// Everything that changed about workspaces during one task. Workspaces are
+// listed by id and a workspace created and removed within the same task
+// does not appear at all.
+struct WorkspaceChangeSet {
+  WorkspaceChangeSet();
+  WorkspaceChangeSet(WorkspaceChangeSet&& other);
+  WorkspaceChangeSet& operator=(WorkspaceChangeSet&& other);
+  ~WorkspaceChangeSet();
+  
+  bool IsEmpty() const;
+  
+  std::vector<std::string> created;
+  std::vector<std::string> removed;
+  std::vector<std::string> renamed;
+  std::vector<std::string> recolored;
+  // The workspace that is active now, if activation changed.
+  std::string activated;
+  // Tabs that joined a workspace, with the workspace they ended up in.
+  // Tabs closed before the change set was delivered are left out.
+  std::unordered_map<content::WebContents*, std::string> moved_tabs;
+};
+
+// One manager per profile owns the workspaces of all its windows. Every
+// window's tab strip reports to it, and a workspace may hold tabs from any
+// number of windows, so switching workspaces or moving tabs between them
+// never moves tabs between windows.
+class LunetixWorkspaceManager : public KeyedService,
+                                public TabStripModelObserver,
+                                public BrowserListObserver {
  public:
   class Observer {
    public:
     virtual ~Observer() = default;
-    virtual void OnWorkspaceCreated(LunetixWorkspace* workspace) {}
-    virtual void OnWorkspaceRemoved(const std::string& workspace_id) {}
-    virtual void OnWorkspaceActivated(LunetixWorkspace* workspace) {}
-    virtual void OnWorkspaceRenamed(LunetixWorkspace* workspace) {}
-    virtual void OnTabMovedToWorkspace(content::WebContents* web_contents,
-                                      LunetixWorkspace* workspace) {}
+    // Changes are coalesced and delivered once per task, so bulk operations
+    // cost observers a single update.
+    virtual void OnWorkspacesChanged(const WorkspaceChangeSet& changes) {}
+    // Auto clustering found tabs in the default workspace that belong
+    // together. Replaces earlier proposals.
+    virtual void OnWorkspaceProposalsReady(
+        const std::vector<WorkspaceProposal>& proposals) {}
+    // Parking or opening |workspace_id| failed because its archive could
+    // not be written or read. The workspace is left as it was.
+    virtual void OnWorkspaceArchiveFailed(const std::string& workspace_id) {}
   };
   
-  LunetixWorkspaceManager();
+  // Use LunetixWorkspaceManagerFactory::GetForProfile() instead.
+  explicit LunetixWorkspaceManager(Profile* profile);
   ~LunetixWorkspaceManager() override;
   
+  // KeyedService overrides:
+  void Shutdown() override;
+  
   // Workspace management
   LunetixWorkspace* CreateWorkspace(const std::string& name);
   void RemoveWorkspace(const std::string& workspace_id);
   void RenameWorkspace(const std::string& workspace_id, const std::string& new_name);
   void SetWorkspaceColor(const std::string& workspace_id, const std::string& color);
   
+  // Closes every tab of a workspace once its tabs are written to disk.
+  // Opening it brings them back into |browser| as placeholders that only
+  // load when activated. The default workspace cannot be parked. Returns
+  // whether parking started.
+  bool ParkWorkspace(const std::string& workspace_id);
+  void OpenWorkspace(const std::string& workspace_id, Browser* browser);
+  
   // Workspace navigation
   void ActivateWorkspace(const std::string& workspace_id);
   LunetixWorkspace* GetActiveWorkspace() const;
   LunetixWorkspace* GetWorkspace(const std::string& workspace_id) const;
+  LunetixWorkspace* GetWorkspaceForTab(content::WebContents* web_contents) const;
+  // The tab of a workspace with session tab id |tab_id|, or null once it
+  // has closed.
+  content::WebContents* GetTabById(int tab_id) const;
   const std::vector<std::unique_ptr<LunetixWorkspace>>& GetAllWorkspaces() const;
   
+  // Auto clustering periodically proposes workspaces for the tabs of the
+  // default workspace. Off by default.
+  void SetAutoClusteringEnabled(bool enabled);
+  bool IsAutoClusteringEnabled() const { return !!clusterer_; }
+  // Moves the proposal's tabs that are still open into a new workspace, or
+  // into a new tab group of their current workspace.
+  LunetixWorkspace* AcceptProposalAsWorkspace(const WorkspaceProposal& proposal);
+  void AcceptProposalAsTabGroup(const WorkspaceProposal& proposal);
+  
+  // Freezes and evicts the tabs of inactive workspaces.
+  LunetixWorkspaceLifecyclePolicy* lifecycle_policy() {
+    return lifecycle_policy_.get();
+  }
+  
   // Tab management
   void MoveTabToWorkspace(content::WebContents* web_contents, 
                          const std::string& workspace_id);
+  void MoveTabsToWorkspace(const std::vector<content::WebContents*>& tabs,
+                           const std::string& workspace_id);
   void CreateTabGroup(const std::vector<content::WebContents*>& tabs,
                      const std::string& group_name,
                      const std::string& color);
+  // Tabs outside the tab strip the group already lives in are skipped.
+  void AddTabsToGroup(const std::string& group_id,
+                      const std::vector<content::WebContents*>& tabs);
   void UngroupTabs(const std::vector<content::WebContents*>& tabs);
   
-  // Tab grouping
+  // Tab grouping. Membership and order live in the tab strip, which keeps
+  // the tabs of a group in one contiguous range. A group is linked to its
+  // tab strip group once it has tabs.
   struct TabGroup {
     std::string id;
     std::string name;
     std::string color;
-    std::vector<content::WebContents*> tabs;
+    std::string workspace_id;
     bool collapsed = false;
+    TabStripModel* tab_strip = nullptr;
+    absl::optional<tab_groups::TabGroupId> strip_group;
   };
   
   TabGroup* CreateTabGroupInWorkspace(const std::string& workspace_id,
                                      const std::string& group_name,
                                      const std::string& color);
   void RemoveTabGroup(const std::string& group_id);
+  // Collapsed groups are hidden in the tab strip and their tabs may be
+  // frozen.
   void CollapseTabGroup(const std::string& group_id, bool collapsed);
   
+  TabGroup* GetTabGroup(const std::string& group_id) const;
+  TabGroup* GetTabGroupForTab(content::WebContents* web_contents) const;
+  // Tabs of |group_id| in tab strip order.
+  std::vector<content::WebContents*> GetTabsInGroup(
+      const std::string& group_id) const;
+  
+  // Fuzzy search over the title, URL and workspace name of every tab, for
+  // the tab switcher. Best matches first.
+  struct TabSearchResult {
+    content::WebContents* web_contents;
+    LunetixWorkspace* workspace;
+    float score;
+  };
+  
+  std::vector<TabSearchResult> SearchTabs(const std::u16string& query,
+                                          size_t max_results) const;
+  
   // Observer management
   void AddObserver(Observer* observer);
   void RemoveObserver(Observer* observer);
@@ -101,28 +232,134 @@ class LunetixWorkspaceManager : public TabStripModelObserver {
   void OnTabStripModelChanged(TabStripModel* tab_strip_model,
                              const TabStripModelChange& change,
                              const TabStripSelectionChange& selection) override;
+  void OnTabGroupChanged(const TabGroupChange& change) override;
+  void TabChangedAt(content::WebContents* contents,
+                    int index,
+                    TabChangeType change_type) override;
   
-  // Persistence
+  // BrowserListObserver overrides:
+  void OnBrowserAdded(Browser* browser) override;
+  void OnBrowserRemoved(Browser* browser) override;
+  
+  // Persistence. Mutations are journaled as they happen; saving writes a
+  // full snapshot and compacts the journal. Loading is asynchronous and
+  // moves tabs back into their workspaces as they are restored.
   void SaveWorkspaces();
   void LoadWorkspaces();
   
  private:
+  struct RestoredState;
+  
+  // Add to |pending_changes_|, which observers get at the end of the task.
   void NotifyWorkspaceCreated(LunetixWorkspace* workspace);
   void NotifyWorkspaceRemoved(const std::string& workspace_id);
   void NotifyWorkspaceActivated(LunetixWorkspace* workspace);
+  void NotifyWorkspaceRenamed(LunetixWorkspace* workspace);
+  void NotifyWorkspaceRecolored(LunetixWorkspace* workspace);
+  void NotifyTabMoved(content::WebContents* web_contents,
+                      LunetixWorkspace* workspace);
+  WorkspaceChangeSet* GetPendingChanges();
+  void DeliverPendingChanges();
+  void NotifyWorkspaceProposalsReady(
+      const std::vector<WorkspaceProposal>& proposals);
+  void NotifyWorkspaceArchiveFailed(const std::string& workspace_id);
   
   std::string GenerateWorkspaceId();
   std::string GenerateGroupId();
   
+  LunetixWorkspace* AddWorkspace(const std::string& id, const std::string& name);
+  // Tabs of |proposal| that are still open.
+  std::vector<content::WebContents*> GetOpenProposalTabs(
+      const WorkspaceProposal& proposal) const;
+  void EraseWorkspace(LunetixWorkspace* workspace);
+  
+  // Starts following a window of |profile_|, including the tabs it already
+  // has.
+  void ObserveTabStrip(TabStripModel* tab_strip);
+  // A tab entered |tab_strip|, either new or moved from another window.
+  void OnTabInserted(TabStripModel* tab_strip,
+                     content::WebContents* web_contents);
+  // Returns the tab strip holding |web_contents| and its index there.
+  TabStripModel* FindTabStrip(content::WebContents* web_contents,
+                              int* index) const;
+  
+  // Adds |web_contents| to |workspace|, taking it out of the workspace it
+  // was in before.
+  void AssignTab(content::WebContents* web_contents,
+                 LunetixWorkspace* workspace);
+  void UnassignTab(content::WebContents* web_contents);
+  void ReplaceTab(content::WebContents* old_contents,
+                  content::WebContents* new_contents);
+  
+  // Keeps |search_index_| in step with the tab's title, URL and workspace.
+  void IndexTab(content::WebContents* web_contents);
+  void UnindexTab(content::WebContents* web_contents);
+  
+  void LinkTabGroup(TabGroup* group,
+                    TabStripModel* tab_strip,
+                    const tab_groups::TabGroupId& strip_group);
+  void UnlinkTabGroup(TabGroup* group);
+  void UpdateStripGroupVisuals(TabGroup* group);
+  void SetTabGroupCollapsed(TabGroup* group, bool collapsed);
+  
+  // Returns the workspace a restored tab belonged to, if any, consuming the
+  // pending entry for it.
+  LunetixWorkspace* TakeRestoredWorkspace(content::WebContents* web_contents);
+  void DropPendingTabs();
+  
+  void RecordMutation(base::Value record);
+  base::Value BuildSnapshot() const;
+  void OnWorkspacesLoaded(
+      std::unique_ptr<LunetixWorkspaceStore::LoadResult> result);
+  void ApplySnapshot(const base::Value& snapshot, RestoredState* state);
+  void ApplyRecord(const base::Value& record, RestoredState* state);
+  
+  // |tab_ids| are the tabs written to the archive.
+  void OnWorkspaceArchiveWritten(const std::string& workspace_id,
+                                 std::vector<int> tab_ids,
+                                 bool success);
+  void OnWorkspaceArchiveRead(const std::string& workspace_id,
+                              SessionID browser_id,
+                              std::string data);
+  
+  Profile* const profile_;
+  
+  // Owns the workspaces in creation order.
   std::vector<std::unique_ptr<LunetixWorkspace>> workspaces_;
+  // Indexes into |workspaces_| so lookups never scan every workspace.
+  std::unordered_map<std::string, LunetixWorkspace*> workspaces_by_id_;
+  std::unordered_map<content::WebContents*, LunetixWorkspace*>
+      workspace_by_tab_;
+  // Window of every tab of the profile, so lookups never scan all windows.
+  std::unordered_map<content::WebContents*, TabStripModel*> tab_strip_by_tab_;
   std::map<std::string, std::unique_ptr<TabGroup>> tab_groups_;
+  std::map<tab_groups::TabGroupId, TabGroup*> tab_groups_by_strip_group_;
+  // Tabs are indexed under their session tab id.
+  LunetixTabSearchIndex search_index_;
+  std::unordered_map<int, content::WebContents*> tabs_by_search_id_;
   LunetixWorkspace* active_workspace_ = nullptr;
   
   base::ObserverList<Observer> observers_;
+  WorkspaceChangeSet pending_changes_;
+  bool changes_delivery_scheduled_ = false;
   
   int next_workspace_id_ = 1;
   int next_group_id_ = 1;
   
+  std::unique_ptr<LunetixWorkspaceLifecyclePolicy> lifecycle_policy_;
+  std::unique_ptr<LunetixWorkspacePrefetcher> prefetcher_;
+  std::unique_ptr<LunetixWorkspaceClusterer> clusterer_;
+  
+  std::unique_ptr<LunetixWorkspaceStore> store_;
+  bool workspaces_loaded_ = false;
+  // Workspaces whose archive is being written.
+  std::set<std::string> parking_workspace_ids_;
+  // Workspace ids of tabs that have not been restored yet, keyed by URL.
+  // Dropped after a grace period so unrelated tabs opened later with the
+  // same URL are not pulled into old workspaces.
+  std::unordered_multimap<std::string, std::string> pending_tab_workspaces_;
+  base::OneShotTimer pending_tab_timer_;
+  
   base::WeakPtrFactory<LunetixWorkspaceManager> weak_factory_{this};
   
   DISALLOW_COPY_AND_ASSIGN(LunetixWorkspaceManager);
@@ -0,0 +1,50 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_manager_factory.h"
+
+#include "base/memory/singleton.h"
+#include "chrome/browser/favicon/favicon_service_factory.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor_factory.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+
+namespace lunetix {
+
+// static
+LunetixWorkspaceManager* LunetixWorkspaceManagerFactory::GetForProfile(
+    Profile* profile) {
+  return static_cast<LunetixWorkspaceManager*>(
+      GetInstance()->GetServiceForBrowserContext(profile, true));
+}
+
+// static
+LunetixWorkspaceManagerFactory* LunetixWorkspaceManagerFactory::GetInstance() {
+  return base::Singleton<LunetixWorkspaceManagerFactory>::get();
+}
+
+LunetixWorkspaceManagerFactory::LunetixWorkspaceManagerFactory()
+    : BrowserContextKeyedServiceFactory(
+          "LunetixWorkspaceManager",
+          BrowserContextDependencyManager::GetInstance()) {
+  // Parked workspaces bring their favicons back through it.
+  DependsOn(FaviconServiceFactory::GetInstance());
+  // Workspace prefetches warm connections through it.
+  DependsOn(LunetixPreconnectPredictorFactory::GetInstance());
+}
+
+LunetixWorkspaceManagerFactory::~LunetixWorkspaceManagerFactory() = default;
+
+KeyedService* LunetixWorkspaceManagerFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new LunetixWorkspaceManager(Profile::FromBrowserContext(context));
+}
+
+bool LunetixWorkspaceManagerFactory::ServiceIsCreatedWithBrowserContext()
+    const {
+  return true;
+}
+
+bool LunetixWorkspaceManagerFactory::ServiceIsNULLWhileTesting() const {
+  return true;
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_MANAGER_FACTORY_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_MANAGER_FACTORY_H_
+
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+class Profile;
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+}
+
+namespace content {
+class BrowserContext;
+}
+
+namespace lunetix {
+
+class LunetixWorkspaceManager;
+
+// The manager is built with the profile so it sees the first window open.
+// Off-the-record profiles get none, so their tabs are never written to disk.
+class LunetixWorkspaceManagerFactory
+    : public BrowserContextKeyedServiceFactory {
+ public:
+  static LunetixWorkspaceManager* GetForProfile(Profile* profile);
+  static LunetixWorkspaceManagerFactory* GetInstance();
+  
+ private:
+  friend struct base::DefaultSingletonTraits<LunetixWorkspaceManagerFactory>;
+  
+  LunetixWorkspaceManagerFactory();
+  ~LunetixWorkspaceManagerFactory() override;
+  
+  // BrowserContextKeyedServiceFactory overrides:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  bool ServiceIsCreatedWithBrowserContext() const override;
+  bool ServiceIsNULLWhileTesting() const override;
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixWorkspaceManagerFactory);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_MANAGER_FACTORY_H_
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_window.h"
+#include "chrome/browser/ui/tabs/tab_group.h"
+#include "chrome/browser/ui/tabs/tab_group_model.h"
+#include "chrome/browser/ui/tabs/tab_strip_model.h"
+#include "chrome/test/base/browser_with_test_window_test.h"
+#include "components/sessions/content/session_tab_helper.h"
+#include "components/tab_groups/tab_group_visual_data.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+using TabGroup = LunetixWorkspaceManager::TabGroup;
+
+namespace {
+
+class TestObserver : public LunetixWorkspaceManager::Observer {
+ public:
+  // LunetixWorkspaceManager::Observer overrides:
+  void OnWorkspacesChanged(const WorkspaceChangeSet& changes) override {
+    WorkspaceChangeSet copy;
+    copy.created = changes.created;
+    copy.removed = changes.removed;
+    copy.renamed = changes.renamed;
+    copy.recolored = changes.recolored;
+    copy.activated = changes.activated;
+    copy.moved_tabs = changes.moved_tabs;
+    change_sets.push_back(std::move(copy));
+  }
+  void OnWorkspaceArchiveFailed(const std::string& workspace_id) override {
+    failed_archives.push_back(workspace_id);
+  }
+  
+  std::vector<WorkspaceChangeSet> change_sets;
+  std::vector<std::string> failed_archives;
+};
+
+}  // namespace
+
+class LunetixWorkspaceManagerTest : public BrowserWithTestWindowTest {
+ protected:
+  void SetUp() override {
+    BrowserWithTestWindowTest::SetUp();
+    manager_ = std::make_unique<LunetixWorkspaceManager>(profile());
+    manager_->AddObserver(&observer_);
+    task_environment()->RunUntilIdle();
+    observer_.change_sets.clear();
+  }
+  
+  void TearDown() override {
+    manager_->RemoveObserver(&observer_);
+    manager_->Shutdown();
+    manager_.reset();
+    BrowserWithTestWindowTest::TearDown();
+  }
+  
+  // Opens a tab in the active workspace of |browser|.
+  content::WebContents* OpenTab(Browser* browser, const char* url) {
+    AddTab(browser, GURL(url));
+    return browser->tab_strip_model()->GetWebContentsAt(0);
+  }
+  
+  TabStripModel* tab_strip() { return browser()->tab_strip_model(); }
+  
+  const tab_groups::TabGroupVisualData* GetStripVisuals(TabGroup* group) {
+    return tab_strip()
+        ->group_model()
+        ->GetTabGroup(*group->strip_group)
+        ->visual_data();
+  }
+  
+  TestObserver observer_;
+  std::unique_ptr<LunetixWorkspaceManager> manager_;
+};
+
+TEST_F(LunetixWorkspaceManagerTest, ParksOnceArchiveIsWritten) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(browser(), "https://docs.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabsToWorkspace({mail, docs}, work->id());
+  
+  ASSERT_TRUE(manager_->ParkWorkspace(work->id()));
+  EXPECT_FALSE(manager_->ParkWorkspace(work->id()));
+  // Nothing closes before the archive is on disk.
+  EXPECT_EQ(2, tab_strip()->count());
+  EXPECT_FALSE(work->IsParked());
+  
+  task_environment()->RunUntilIdle();
+  EXPECT_TRUE(work->IsParked());
+  EXPECT_TRUE(work->IsEmpty());
+  EXPECT_EQ(0, tab_strip()->count());
+  EXPECT_TRUE(observer_.failed_archives.empty());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, KeepsTabsWhenArchiveWriteFails) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabToWorkspace(mail, work->id());
+  
+  // A directory in the archive's place makes writing it fail.
+  ASSERT_TRUE(base::CreateDirectory(
+      profile()
+          ->GetPath()
+          .Append(FILE_PATH_LITERAL("Lunetix Workspaces"))
+          .AppendASCII(work->id() + ".lws")));
+  
+  ASSERT_TRUE(manager_->ParkWorkspace(work->id()));
+  task_environment()->RunUntilIdle();
+  EXPECT_FALSE(work->IsParked());
+  EXPECT_TRUE(work->ContainsTab(mail));
+  EXPECT_EQ(1, tab_strip()->count());
+  EXPECT_EQ(std::vector<std::string>({work->id()}), observer_.failed_archives);
+}
+
+TEST_F(LunetixWorkspaceManagerTest, MovesTabsThatJoinWhileParking) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabToWorkspace(mail, work->id());
+  ASSERT_TRUE(manager_->ParkWorkspace(work->id()));
+  
+  content::WebContents* late = OpenTab(browser(), "https://late.example/");
+  manager_->MoveTabToWorkspace(late, work->id());
+  task_environment()->RunUntilIdle();
+  
+  EXPECT_TRUE(work->IsParked());
+  EXPECT_EQ(1, tab_strip()->count());
+  EXPECT_EQ(manager_->GetWorkspace("default"),
+            manager_->GetWorkspaceForTab(late));
+}
+
+TEST_F(LunetixWorkspaceManagerTest, OpensParkedWorkspace) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(browser(), "https://docs.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabsToWorkspace({mail, docs}, work->id());
+  ASSERT_TRUE(manager_->ParkWorkspace(work->id()));
+  task_environment()->RunUntilIdle();
+  ASSERT_TRUE(work->IsParked());
+  
+  manager_->OpenWorkspace(work->id(), browser());
+  task_environment()->RunUntilIdle();
+  EXPECT_FALSE(work->IsParked());
+  EXPECT_EQ(work, manager_->GetActiveWorkspace());
+  EXPECT_EQ(2u, work->GetTabCount());
+  ASSERT_EQ(2, tab_strip()->count());
+  for (content::WebContents* web_contents : work->tabs()) {
+    EXPECT_NE(TabStripModel::kNoTab,
+              tab_strip()->GetIndexOfWebContents(web_contents));
+  }
+}
+
+TEST_F(LunetixWorkspaceManagerTest, CreatesGroupFromTabs) {
+  content::WebContents* a = OpenTab(browser(), "https://a.example/");
+  content::WebContents* b = OpenTab(browser(), "https://b.example/");
+  content::WebContents* c = OpenTab(browser(), "https://c.example/");
+  // The tab strip is now c, b, a.
+  manager_->CreateTabGroup({a, c}, "Reading", "#1E8E3E");
+  
+  TabGroup* group = manager_->GetTabGroupForTab(a);
+  ASSERT_TRUE(group);
+  EXPECT_EQ(group, manager_->GetTabGroupForTab(c));
+  EXPECT_FALSE(manager_->GetTabGroupForTab(b));
+  EXPECT_EQ("Reading", group->name);
+  EXPECT_EQ("default", group->workspace_id);
+  EXPECT_EQ(tab_strip(), group->tab_strip);
+  
+  // The tab strip moves the grouped tabs next to each other.
+  EXPECT_EQ(std::vector<content::WebContents*>({c, a}),
+            manager_->GetTabsInGroup(group->id));
+  EXPECT_EQ(u"Reading", GetStripVisuals(group)->title());
+  EXPECT_EQ(tab_groups::TabGroupColorId::kGreen,
+            GetStripVisuals(group)->color());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, CollapsesGroupBothWays) {
+  content::WebContents* a = OpenTab(browser(), "https://a.example/");
+  content::WebContents* b = OpenTab(browser(), "https://b.example/");
+  manager_->CreateTabGroup({a, b}, "Reading", "#1A73E8");
+  TabGroup* group = manager_->GetTabGroupForTab(a);
+  ASSERT_TRUE(group);
+  
+  manager_->CollapseTabGroup(group->id, true);
+  EXPECT_TRUE(group->collapsed);
+  EXPECT_TRUE(GetStripVisuals(group)->is_collapsed());
+  
+  // Expanding from the tab strip itself is picked up too.
+  tab_strip()
+      ->group_model()
+      ->GetTabGroup(*group->strip_group)
+      ->SetVisualData(tab_groups::TabGroupVisualData(
+          u"Reading", tab_groups::TabGroupColorId::kBlue, false));
+  EXPECT_FALSE(group->collapsed);
+}
+
+TEST_F(LunetixWorkspaceManagerTest, GroupOutlivesItsLastTab) {
+  content::WebContents* a = OpenTab(browser(), "https://a.example/");
+  content::WebContents* b = OpenTab(browser(), "https://b.example/");
+  manager_->CreateTabGroup({a, b}, "Reading", "#1A73E8");
+  TabGroup* group = manager_->GetTabGroupForTab(a);
+  ASSERT_TRUE(group);
+  std::string group_id = group->id;
+  
+  manager_->UngroupTabs({a, b});
+  EXPECT_EQ(group, manager_->GetTabGroup(group_id));
+  EXPECT_FALSE(group->strip_group);
+  EXPECT_TRUE(manager_->GetTabsInGroup(group_id).empty());
+  
+  manager_->AddTabsToGroup(group_id, {b});
+  EXPECT_EQ(group, manager_->GetTabGroupForTab(b));
+  EXPECT_EQ(std::vector<content::WebContents*>({b}),
+            manager_->GetTabsInGroup(group_id));
+}
+
+TEST_F(LunetixWorkspaceManagerTest, RemoveTabGroupKeepsTabs) {
+  content::WebContents* a = OpenTab(browser(), "https://a.example/");
+  content::WebContents* b = OpenTab(browser(), "https://b.example/");
+  manager_->CreateTabGroup({a, b}, "Reading", "#1A73E8");
+  TabGroup* group = manager_->GetTabGroupForTab(a);
+  ASSERT_TRUE(group);
+  std::string group_id = group->id;
+  
+  manager_->RemoveTabGroup(group_id);
+  EXPECT_FALSE(manager_->GetTabGroup(group_id));
+  EXPECT_FALSE(manager_->GetTabGroupForTab(a));
+  EXPECT_FALSE(tab_strip()->GetTabGroupForTab(0));
+  EXPECT_EQ(2, tab_strip()->count());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, DeliversOneChangeSetPerTask) {
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->RenameWorkspace(work->id(), "Office");
+  manager_->RenameWorkspace(work->id(), "Job");
+  manager_->SetWorkspaceColor(work->id(), "#D93025");
+  manager_->ActivateWorkspace(work->id());
+  EXPECT_TRUE(observer_.change_sets.empty());
+  
+  task_environment()->RunUntilIdle();
+  ASSERT_EQ(1u, observer_.change_sets.size());
+  const WorkspaceChangeSet& changes = observer_.change_sets[0];
+  EXPECT_EQ(std::vector<std::string>({work->id()}), changes.created);
+  EXPECT_EQ(std::vector<std::string>({work->id()}), changes.renamed);
+  EXPECT_EQ(std::vector<std::string>({work->id()}), changes.recolored);
+  EXPECT_EQ(work->id(), changes.activated);
+  EXPECT_TRUE(changes.removed.empty());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, HidesWorkspaceThatLivedForOneTask) {
+  std::string kept_id = manager_->CreateWorkspace("Kept")->id();
+  task_environment()->RunUntilIdle();
+  observer_.change_sets.clear();
+  
+  std::string brief_id = manager_->CreateWorkspace("Brief")->id();
+  manager_->RenameWorkspace(brief_id, "Gone");
+  manager_->RemoveWorkspace(brief_id);
+  task_environment()->RunUntilIdle();
+  EXPECT_TRUE(observer_.change_sets.empty());
+  
+  manager_->RenameWorkspace(kept_id, "Gone");
+  manager_->RemoveWorkspace(kept_id);
+  task_environment()->RunUntilIdle();
+  ASSERT_EQ(1u, observer_.change_sets.size());
+  EXPECT_EQ(std::vector<std::string>({kept_id}),
+            observer_.change_sets[0].removed);
+  EXPECT_TRUE(observer_.change_sets[0].renamed.empty());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, LeavesClosedTabsOutOfMoves) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(browser(), "https://docs.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  task_environment()->RunUntilIdle();
+  observer_.change_sets.clear();
+  
+  manager_->MoveTabsToWorkspace({mail, docs}, work->id());
+  tab_strip()->CloseWebContentsAt(tab_strip()->GetIndexOfWebContents(docs),
+                                  TabStripModel::CLOSE_NONE);
+  task_environment()->RunUntilIdle();
+  ASSERT_EQ(1u, observer_.change_sets.size());
+  const WorkspaceChangeSet& changes = observer_.change_sets[0];
+  ASSERT_EQ(1u, changes.moved_tabs.size());
+  EXPECT_EQ(work->id(), changes.moved_tabs.at(mail));
+}
+
+TEST_F(LunetixWorkspaceManagerTest, SharesWorkspacesAcrossWindows) {
+  std::unique_ptr<BrowserWindow> second_window = CreateBrowserWindow();
+  std::unique_ptr<Browser> second = CreateBrowser(
+      profile(), Browser::TYPE_NORMAL, false, second_window.get());
+  
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(second.get(), "https://docs.example/");
+  LunetixWorkspace* default_workspace = manager_->GetWorkspace("default");
+  EXPECT_EQ(default_workspace, manager_->GetWorkspaceForTab(mail));
+  EXPECT_EQ(default_workspace, manager_->GetWorkspaceForTab(docs));
+  
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabsToWorkspace({mail, docs}, work->id());
+  manager_->ActivateWorkspace(work->id());
+  EXPECT_EQ(2u, work->GetTabCount());
+  // Switching workspaces never moves tabs between windows.
+  EXPECT_EQ(mail, tab_strip()->GetWebContentsAt(0));
+  EXPECT_EQ(docs, second->tab_strip_model()->GetWebContentsAt(0));
+  
+  // Tabs opened in either window join the active workspace.
+  content::WebContents* news = OpenTab(second.get(), "https://news.example/");
+  EXPECT_EQ(work, manager_->GetWorkspaceForTab(news));
+  
+  second->tab_strip_model()->CloseAllTabs();
+  second.reset();
+}
+
+TEST_F(LunetixWorkspaceManagerTest, DraggedTabKeepsItsWorkspace) {
+  std::unique_ptr<BrowserWindow> second_window = CreateBrowserWindow();
+  std::unique_ptr<Browser> second = CreateBrowser(
+      profile(), Browser::TYPE_NORMAL, false, second_window.get());
+  
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabToWorkspace(mail, work->id());
+  int tab_id = sessions::SessionTabHelper::IdForTab(mail).id();
+  
+  second->tab_strip_model()->AppendWebContents(
+      tab_strip()->DetachWebContentsAt(0), true);
+  EXPECT_EQ(0, tab_strip()->count());
+  EXPECT_EQ(work, manager_->GetWorkspaceForTab(mail));
+  EXPECT_TRUE(work->ContainsTab(mail));
+  EXPECT_EQ(mail, manager_->GetTabById(tab_id));
+  
+  second->tab_strip_model()->CloseAllTabs();
+  EXPECT_FALSE(work->ContainsTab(mail));
+  EXPECT_FALSE(manager_->GetTabById(tab_id));
+  second.reset();
+}
+
+TEST_F(LunetixWorkspaceManagerTest, ClosedWindowReleasesItsTabs) {
+  std::unique_ptr<BrowserWindow> second_window = CreateBrowserWindow();
+  std::unique_ptr<Browser> second = CreateBrowser(
+      profile(), Browser::TYPE_NORMAL, false, second_window.get());
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->ActivateWorkspace(work->id());
+  OpenTab(second.get(), "chrome://newtab/");
+  
+  // Closing a window without quitting keeps nothing for session restore.
+  second->tab_strip_model()->CloseAllTabs();
+  second.reset();
+  manager_->ActivateWorkspace("default");
+  
+  content::WebContents* tab = OpenTab(browser(), "chrome://newtab/");
+  EXPECT_EQ(manager_->GetWorkspace("default"),
+            manager_->GetWorkspaceForTab(tab));
+  EXPECT_TRUE(work->IsEmpty());
+}
+
+TEST_F(LunetixWorkspaceManagerTest, RemovingWorkspaceKeepsItsTabs) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(browser(), "https://docs.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  std::string work_id = work->id();
+  manager_->MoveTabsToWorkspace({mail, docs}, work_id);
+  manager_->ActivateWorkspace(work_id);
+  
+  manager_->RemoveWorkspace(work_id);
+  LunetixWorkspace* default_workspace = manager_->GetWorkspace("default");
+  EXPECT_FALSE(manager_->GetWorkspace(work_id));
+  EXPECT_EQ(default_workspace, manager_->GetActiveWorkspace());
+  EXPECT_EQ(default_workspace, manager_->GetWorkspaceForTab(mail));
+  EXPECT_EQ(default_workspace, manager_->GetWorkspaceForTab(docs));
+  EXPECT_EQ(2, tab_strip()->count());
+  
+  // The default workspace always stays.
+  manager_->RemoveWorkspace("default");
+  EXPECT_EQ(default_workspace, manager_->GetWorkspace("default"));
+}
+
+TEST_F(LunetixWorkspaceManagerTest, SearchesTabsAcrossWorkspaces) {
+  content::WebContents* mail = OpenTab(browser(), "https://mail.example/");
+  content::WebContents* docs = OpenTab(browser(), "https://docs.example/");
+  LunetixWorkspace* work = manager_->CreateWorkspace("Work");
+  manager_->MoveTabToWorkspace(docs, work->id());
+  
+  std::vector<LunetixWorkspaceManager::TabSearchResult> results =
+      manager_->SearchTabs(u"docs.example", 10);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(docs, results[0].web_contents);
+  EXPECT_EQ(work, results[0].workspace);
+  
+  // Renaming a workspace reindexes its tabs.
+  manager_->RenameWorkspace(work->id(), "Finance");
+  results = manager_->SearchTabs(u"finance", 10);
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(docs, results[0].web_contents);
+  
+  EXPECT_EQ(mail, manager_->GetTabById(
+                      sessions::SessionTabHelper::IdForTab(mail).id()));
+}
+
+}  // namespace lunetix
\ No newline at end of file
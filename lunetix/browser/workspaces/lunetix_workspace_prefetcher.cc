@@ -0,0 +1,199 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_prefetcher.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/memory/memory_pressure_monitor.h"
+#include "chrome/browser/profiles/profile.h"
+#include "content/public/browser/navigation_controller.h"
+#include "content/public/browser/storage_partition.h"
+#include "content/public/browser/web_contents.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor.h"
+#include "lunetix/browser/predictors/lunetix_preconnect_predictor_factory.h"
+#include "lunetix/browser/workspaces/lunetix_workspace_manager.h"
+#include "net/base/isolation_info.h"
+#include "net/base/request_priority.h"
+#include "net/cookies/site_for_cookies.h"
+#include "net/http/http_request_headers.h"
+#include "net/traffic_annotation/network_traffic_annotation.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/cpp/simple_url_loader.h"
+#include "url/origin.h"
+
+namespace lunetix {
+
+namespace {
+
+constexpr size_t kMaxPrefetchedTabs = 5;
+constexpr size_t kMaxConcurrentPrefetches = 2;
+// Larger documents are cut off; the cache keeps nothing of them.
+constexpr size_t kMaxDocumentSize = 2 * 1024 * 1024;
+
+const char kDocumentAccept[] =
+    "text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8";
+
+constexpr net::NetworkTrafficAnnotationTag kTrafficAnnotation =
+    net::DefineNetworkTrafficAnnotation("lunetix_workspace_prefetch", R"(
+        semantics {
+          sender: "Lunetix Workspaces"
+          description:
+            "When the user switches to a workspace, the pages of its most "
+            "recently used tabs that are not loaded are fetched into the "
+            "HTTP cache, so that activating those tabs is faster."
+          trigger: "The user switches to a workspace with unloaded tabs."
+          data:
+            "The same request the tab would make when activated, including "
+            "cookies."
+          destination: WEBSITE
+        }
+        policy {
+          cookies_allowed: YES
+          cookies_store: "user"
+          setting:
+            "Not prefetched on metered connections or under memory "
+            "pressure."
+          policy_exception_justification: "Not implemented."
+        })");
+
+// Restored placeholders and discarded tabs load on activation.
+bool IsUnloaded(content::WebContents* web_contents) {
+  return web_contents->WasDiscarded() ||
+         web_contents->GetController().NeedsReload();
+}
+
+}  // namespace
+
+LunetixWorkspacePrefetcher::LunetixWorkspacePrefetcher(Profile* profile)
+    : profile_(profile),
+      memory_pressure_listener_(
+          FROM_HERE,
+          base::BindRepeating(&LunetixWorkspacePrefetcher::OnMemoryPressure,
+                              base::Unretained(this))) {
+  net::NetworkChangeNotifier::AddConnectionCostObserver(this);
+}
+
+LunetixWorkspacePrefetcher::~LunetixWorkspacePrefetcher() {
+  net::NetworkChangeNotifier::RemoveConnectionCostObserver(this);
+}
+
+void LunetixWorkspacePrefetcher::OnWorkspaceActivated(
+    LunetixWorkspace* workspace) {
+  Cancel();
+  if (!CanPrefetch()) {
+    return;
+  }
+  
+  std::vector<content::WebContents*> tabs;
+  for (content::WebContents* web_contents : workspace->tabs()) {
+    if (IsUnloaded(web_contents) &&
+        web_contents->GetVisibleURL().SchemeIsHTTPOrHTTPS()) {
+      tabs.push_back(web_contents);
+    }
+  }
+  size_t count = std::min(tabs.size(), kMaxPrefetchedTabs);
+  std::partial_sort(tabs.begin(), tabs.begin() + count, tabs.end(),
+                    [](content::WebContents* a, content::WebContents* b) {
+                      return a->GetLastActiveTime() > b->GetLastActiveTime();
+                    });
+  
+  for (size_t i = 0; i < count; ++i) {
+    const GURL& url = tabs[i]->GetVisibleURL();
+    if (std::find(queue_.begin(), queue_.end(), url) == queue_.end()) {
+      queue_.push_back(url);
+    }
+  }
+  StartPrefetches();
+}
+
+void LunetixWorkspacePrefetcher::Cancel() {
+  queue_.clear();
+  loaders_.clear();
+}
+
+void LunetixWorkspacePrefetcher::OnConnectionCostChanged(
+    net::NetworkChangeNotifier::ConnectionCost cost) {
+  if (cost == net::NetworkChangeNotifier::CONNECTION_COST_METERED) {
+    Cancel();
+  }
+}
+
+bool LunetixWorkspacePrefetcher::CanPrefetch() const {
+  net::NetworkChangeNotifier::ConnectionType connection_type =
+      net::NetworkChangeNotifier::GetConnectionType();
+  if (connection_type == net::NetworkChangeNotifier::CONNECTION_NONE ||
+      net::NetworkChangeNotifier::IsConnectionCellular(connection_type) ||
+      net::NetworkChangeNotifier::GetConnectionCost() ==
+          net::NetworkChangeNotifier::CONNECTION_COST_METERED) {
+    return false;
+  }
+  
+  base::MemoryPressureMonitor* monitor = base::MemoryPressureMonitor::Get();
+  return !monitor || monitor->GetCurrentPressureLevel() ==
+                         base::MemoryPressureListener::
+                             MEMORY_PRESSURE_LEVEL_NONE;
+}
+
+void LunetixWorkspacePrefetcher::StartPrefetches() {
+  LunetixPreconnectPredictor* predictor =
+      LunetixPreconnectPredictorFactory::GetForBrowserContext(profile_);
+  
+  while (loaders_.size() < kMaxConcurrentPrefetches && !queue_.empty()) {
+    GURL url = std::move(queue_.front());
+    queue_.pop_front();
+    
+    // Fetched as the tab's navigation would be, so the cache entry is keyed
+    // and credentialed the same way and the tab can use it.
+    url::Origin origin = url::Origin::Create(url);
+    auto request = std::make_unique<network::ResourceRequest>();
+    request->url = url;
+    request->priority = net::IDLE;
+    request->destination = network::mojom::RequestDestination::kDocument;
+    request->site_for_cookies = net::SiteForCookies::FromOrigin(origin);
+    request->trusted_params = network::ResourceRequest::TrustedParams();
+    request->trusted_params->isolation_info = net::IsolationInfo::Create(
+        net::IsolationInfo::RequestType::kMainFrame, origin, origin,
+        request->site_for_cookies);
+    request->headers.SetHeader(net::HttpRequestHeaders::kAccept,
+                               kDocumentAccept);
+    request->headers.SetHeader("Purpose", "prefetch");
+    
+    // Subresources are not fetched, but their connections are warmed.
+    if (predictor) {
+      predictor->OnNavigationHint(url);
+    }
+    
+    std::unique_ptr<network::SimpleURLLoader> loader =
+        network::SimpleURLLoader::Create(std::move(request),
+                                         kTrafficAnnotation);
+    network::SimpleURLLoader* loader_ptr = loader.get();
+    loaders_.push_back(std::move(loader));
+    loader_ptr->DownloadToString(
+        profile_->GetDefaultStoragePartition()
+            ->GetURLLoaderFactoryForBrowserProcess()
+            .get(),
+        base::BindOnce(&LunetixWorkspacePrefetcher::OnPrefetchComplete,
+                       weak_factory_.GetWeakPtr(), loader_ptr),
+        kMaxDocumentSize);
+  }
+}
+
+void LunetixWorkspacePrefetcher::OnPrefetchComplete(
+    network::SimpleURLLoader* loader,
+    std::unique_ptr<std::string> body) {
+  // Only the cache entry was wanted.
+  loaders_.remove_if(
+      [loader](const std::unique_ptr<network::SimpleURLLoader>& entry) {
+        return entry.get() == loader;
+      });
+  StartPrefetches();
+}
+
+void LunetixWorkspacePrefetcher::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  if (level != base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE) {
+    Cancel();
+  }
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_PREFETCHER_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_PREFETCHER_H_
+
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "net/base/network_change_notifier.h"
+#include "url/gurl.h"
+
+class Profile;
+
+namespace network {
+class SimpleURLLoader;
+}
+
+namespace lunetix {
+
+class LunetixWorkspace;
+
+// Warms the HTTP cache for a workspace that was switched to. Its most
+// recently used tabs that are not loaded, restored placeholders and
+// discarded tabs, would otherwise each start cold when activated. Their
+// main documents are fetched at idle priority, a few at a time, and the
+// connections their pages need are warmed through the preconnect
+// predictor. Everything stops under memory pressure or on a metered
+// connection.
+class LunetixWorkspacePrefetcher
+    : public net::NetworkChangeNotifier::ConnectionCostObserver {
+ public:
+  explicit LunetixWorkspacePrefetcher(Profile* profile);
+  ~LunetixWorkspacePrefetcher() override;
+  
+  // Replaces the prefetches of a previous activation.
+  void OnWorkspaceActivated(LunetixWorkspace* workspace);
+  
+  // Drops queued prefetches and cancels those in flight.
+  void Cancel();
+  
+  // net::NetworkChangeNotifier::ConnectionCostObserver overrides:
+  void OnConnectionCostChanged(
+      net::NetworkChangeNotifier::ConnectionCost cost) override;
+
+ private:
+  bool CanPrefetch() const;
+  void StartPrefetches();
+  void OnPrefetchComplete(network::SimpleURLLoader* loader,
+                          std::unique_ptr<std::string> body);
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  
+  Profile* const profile_;
+  
+  std::deque<GURL> queue_;
+  std::list<std::unique_ptr<network::SimpleURLLoader>> loaders_;
+  
+  base::MemoryPressureListener memory_pressure_listener_;
+  
+  base::WeakPtrFactory<LunetixWorkspacePrefetcher> weak_factory_{this};
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixWorkspacePrefetcher);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_PREFETCHER_H_
\ No newline at end of file
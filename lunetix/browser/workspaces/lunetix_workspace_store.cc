@@ -0,0 +1,208 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_store.h"
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/strings/string_split.h"
+#include "base/task/thread_pool.h"
+
+namespace lunetix {
+
+namespace {
+
+// Batches journal writes so bursts of tab activity share one flush.
+constexpr base::TimeDelta kCommitDelay = base::Seconds(2);
+
+const base::FilePath::CharType kSnapshotFilename[] =
+    FILE_PATH_LITERAL("Workspaces");
+const base::FilePath::CharType kJournalFilename[] =
+    FILE_PATH_LITERAL("Workspaces Journal");
+const char kArchiveExtension[] = ".lws";
+
+}  // namespace
+
+// Owns the snapshot and journal files on the background sequence.
+class LunetixWorkspaceStore::Backend {
+ public:
+  explicit Backend(const base::FilePath& directory)
+      : directory_(directory),
+        snapshot_path_(directory.Append(kSnapshotFilename)),
+        journal_path_(directory.Append(kJournalFilename)) {}
+  ~Backend() = default;
+  
+  std::unique_ptr<LoadResult> Load() {
+    auto result = std::make_unique<LoadResult>();
+    
+    std::string data;
+    if (base::ReadFileToString(snapshot_path_, &data)) {
+      absl::optional<base::Value> snapshot = base::JSONReader::Read(data);
+      if (snapshot && snapshot->is_dict()) {
+        result->snapshot = std::move(*snapshot);
+      }
+    }
+    
+    data.clear();
+    if (base::ReadFileToString(journal_path_, &data)) {
+      // A crash can leave a torn last line; it simply fails to parse.
+      for (base::StringPiece line : base::SplitStringPiece(
+               data, "\n", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+        absl::optional<base::Value> record = base::JSONReader::Read(line);
+        if (record && record->is_dict()) {
+          result->journal.push_back(std::move(*record));
+        }
+      }
+    }
+    return result;
+  }
+  
+  void Append(const std::string& records) {
+    if (!journal_.IsValid()) {
+      base::CreateDirectory(journal_path_.DirName());
+      journal_.Initialize(journal_path_, base::File::FLAG_OPEN_ALWAYS |
+                                             base::File::FLAG_APPEND);
+      if (!journal_.IsValid()) {
+        return;
+      }
+    }
+    journal_.WriteAtCurrentPos(records.data(), records.size());
+    journal_.Flush();
+  }
+  
+  bool WriteSnapshot(base::Value snapshot) {
+    std::string data;
+    if (!base::JSONWriter::Write(snapshot, &data)) {
+      return false;
+    }
+    base::CreateDirectory(snapshot_path_.DirName());
+    if (!base::ImportantFileWriter::WriteFileAtomically(snapshot_path_,
+                                                        data)) {
+      return false;
+    }
+    
+    // Only drop the journal once the snapshot covering it is on disk.
+    journal_.Close();
+    base::DeleteFile(journal_path_);
+    return true;
+  }
+  
+  bool WriteArchive(const std::string& workspace_id, const std::string& data) {
+    base::CreateDirectory(directory_);
+    return base::ImportantFileWriter::WriteFileAtomically(
+        GetArchivePath(workspace_id), data);
+  }
+  
+  std::string ReadArchive(const std::string& workspace_id) {
+    std::string data;
+    if (!base::ReadFileToString(GetArchivePath(workspace_id), &data)) {
+      data.clear();
+    }
+    return data;
+  }
+  
+  void DeleteArchive(const std::string& workspace_id) {
+    base::DeleteFile(GetArchivePath(workspace_id));
+  }
+  
+ private:
+  base::FilePath GetArchivePath(const std::string& workspace_id) const {
+    return directory_.AppendASCII(workspace_id + kArchiveExtension);
+  }
+  
+  const base::FilePath directory_;
+  const base::FilePath snapshot_path_;
+  const base::FilePath journal_path_;
+  base::File journal_;
+  
+  DISALLOW_COPY_AND_ASSIGN(Backend);
+};
+
+LunetixWorkspaceStore::LoadResult::LoadResult() = default;
+
+LunetixWorkspaceStore::LoadResult::LoadResult(LoadResult&& other) = default;
+
+LunetixWorkspaceStore::LoadResult& LunetixWorkspaceStore::LoadResult::operator=(
+    LoadResult&& other) = default;
+
+LunetixWorkspaceStore::LoadResult::~LoadResult() = default;
+
+LunetixWorkspaceStore::LunetixWorkspaceStore(const base::FilePath& directory)
+    : backend_(base::ThreadPool::CreateSequencedTaskRunner(
+                   {base::MayBlock(), base::TaskPriority::BEST_EFFORT,
+                    base::TaskShutdownBehavior::BLOCK_SHUTDOWN}),
+               directory) {}
+
+LunetixWorkspaceStore::~LunetixWorkspaceStore() {
+  Flush();
+}
+
+void LunetixWorkspaceStore::Load(LoadCallback callback) {
+  backend_.AsyncCall(&Backend::Load).Then(std::move(callback));
+}
+
+void LunetixWorkspaceStore::AppendRecord(base::Value record) {
+  std::string line;
+  if (!base::JSONWriter::Write(record, &line)) {
+    return;
+  }
+  pending_records_.append(line);
+  pending_records_.push_back('\n');
+  ++journal_size_;
+  
+  if (!commit_timer_.IsRunning()) {
+    commit_timer_.Start(FROM_HERE, kCommitDelay, this,
+                        &LunetixWorkspaceStore::Flush);
+  }
+}
+
+void LunetixWorkspaceStore::WriteSnapshot(base::Value snapshot) {
+  // The backend runs the append before the snapshot, so the journal it
+  // keeps if the snapshot fails is complete.
+  Flush();
+  size_t covered_records = journal_size_;
+  journal_size_ = 0;
+  backend_.AsyncCall(&Backend::WriteSnapshot)
+      .WithArgs(std::move(snapshot))
+      .Then(base::BindOnce(&LunetixWorkspaceStore::OnSnapshotWritten,
+                           weak_factory_.GetWeakPtr(), covered_records));
+}
+
+void LunetixWorkspaceStore::Flush() {
+  commit_timer_.Stop();
+  if (pending_records_.empty()) {
+    return;
+  }
+  backend_.AsyncCall(&Backend::Append).WithArgs(std::move(pending_records_));
+  pending_records_.clear();
+}
+
+void LunetixWorkspaceStore::OnSnapshotWritten(size_t covered_records,
+                                              bool success) {
+  // The journal was kept, so its records still count towards compaction.
+  if (!success) {
+    journal_size_ += covered_records;
+  }
+}
+
+void LunetixWorkspaceStore::WriteArchive(const std::string& workspace_id,
+                                         std::string data,
+                                         WriteCallback callback) {
+  backend_.AsyncCall(&Backend::WriteArchive)
+      .WithArgs(workspace_id, std::move(data))
+      .Then(std::move(callback));
+}
+
+void LunetixWorkspaceStore::ReadArchive(const std::string& workspace_id,
+                                        ArchiveCallback callback) {
+  backend_.AsyncCall(&Backend::ReadArchive)
+      .WithArgs(workspace_id)
+      .Then(std::move(callback));
+}
+
+void LunetixWorkspaceStore::DeleteArchive(const std::string& workspace_id) {
+  backend_.AsyncCall(&Backend::DeleteArchive).WithArgs(workspace_id);
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_STORE_H_
+#define LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_STORE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
+#include "base/threading/sequence_bound.h"
+#include "base/timer/timer.h"
+#include "base/values.h"
+
+namespace lunetix {
+
+// Persists workspace state as a snapshot plus an append-only journal of
+// mutations recorded since. Records are buffered and appended in one
+// batch, so a burst of mutations costs a single write and flush. All file
+// work happens on a background sequence; snapshots are written atomically
+// and replace the journal.
+class LunetixWorkspaceStore {
+ public:
+  struct LoadResult {
+    LoadResult();
+    LoadResult(LoadResult&& other);
+    LoadResult& operator=(LoadResult&& other);
+    ~LoadResult();
+    
+    // Null when there is no usable snapshot.
+    base::Value snapshot;
+    // Journal records in the order they were appended.
+    std::vector<base::Value> journal;
+  };
+  
+  using LoadCallback = base::OnceCallback<void(std::unique_ptr<LoadResult>)>;
+  using ArchiveCallback = base::OnceCallback<void(std::string data)>;
+  using WriteCallback = base::OnceCallback<void(bool success)>;
+  
+  explicit LunetixWorkspaceStore(const base::FilePath& directory);
+  ~LunetixWorkspaceStore();
+  
+  void Load(LoadCallback callback);
+  
+  // Buffers |record| for the next journal commit.
+  void AppendRecord(base::Value record);
+  
+  // Replaces the snapshot and drops the journal once the snapshot is on
+  // disk. Buffered records are committed to the journal first, so a failed
+  // write loses nothing.
+  void WriteSnapshot(base::Value snapshot);
+  
+  // Commits buffered records right away.
+  void Flush();
+  
+  // Tabs of parked workspaces, one file per workspace. |callback| of
+  // WriteArchive() tells whether the archive is on disk; the one of
+  // ReadArchive() gets an empty string if there is no archive.
+  void WriteArchive(const std::string& workspace_id,
+                    std::string data,
+                    WriteCallback callback);
+  void ReadArchive(const std::string& workspace_id, ArchiveCallback callback);
+  void DeleteArchive(const std::string& workspace_id);
+  
+  // Records appended since the last snapshot, used to decide when to
+  // compact.
+  size_t journal_size() const { return journal_size_; }
+  
+ private:
+  class Backend;
+  
+  // |covered_records| were in the journal when the snapshot was requested.
+  void OnSnapshotWritten(size_t covered_records, bool success);
+  
+  base::SequenceBound<Backend> backend_;
+  
+  std::string pending_records_;
+  size_t journal_size_ = 0;
+  base::OneShotTimer commit_timer_;
+  
+  base::WeakPtrFactory<LunetixWorkspaceStore> weak_factory_{this};
+  
+  DISALLOW_COPY_AND_ASSIGN(LunetixWorkspaceStore);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_BROWSER_WORKSPACES_LUNETIX_WORKSPACE_STORE_H_
\ No newline at end of file
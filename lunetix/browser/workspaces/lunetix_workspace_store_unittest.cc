@@ -0,0 +1,206 @@
+#include "lunetix/browser/workspaces/lunetix_workspace_store.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/run_loop.h"
+#include "base/test/task_environment.h"
+#include "base/values.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace lunetix {
+
+namespace {
+
+base::Value MakeRecord(const char* op, const char* id) {
+  base::Value record(base::Value::Type::DICTIONARY);
+  record.SetStringKey("op", op);
+  record.SetStringKey("id", id);
+  return record;
+}
+
+base::Value MakeSnapshot(const char* active) {
+  base::Value snapshot(base::Value::Type::DICTIONARY);
+  snapshot.SetIntKey("version", 1);
+  snapshot.SetStringKey("active", active);
+  return snapshot;
+}
+
+}  // namespace
+
+class LunetixWorkspaceStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    store_ = std::make_unique<LunetixWorkspaceStore>(temp_dir_.GetPath());
+  }
+  
+  // Reads the files back the way the next session would.
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> Reload() {
+    store_.reset();
+    task_environment_.RunUntilIdle();
+    store_ = std::make_unique<LunetixWorkspaceStore>(temp_dir_.GetPath());
+    
+    std::unique_ptr<LunetixWorkspaceStore::LoadResult> result;
+    base::RunLoop run_loop;
+    store_->Load(base::BindOnce(
+        [](base::OnceClosure quit,
+           std::unique_ptr<LunetixWorkspaceStore::LoadResult>* result,
+           std::unique_ptr<LunetixWorkspaceStore::LoadResult> loaded) {
+          *result = std::move(loaded);
+          std::move(quit).Run();
+        },
+        run_loop.QuitClosure(), &result));
+    run_loop.Run();
+    return result;
+  }
+  
+  bool WriteArchive(const std::string& workspace_id, std::string data) {
+    bool success = false;
+    base::RunLoop run_loop;
+    store_->WriteArchive(
+        workspace_id, std::move(data),
+        base::BindOnce(
+            [](base::OnceClosure quit, bool* success, bool written) {
+              *success = written;
+              std::move(quit).Run();
+            },
+            run_loop.QuitClosure(), &success));
+    run_loop.Run();
+    return success;
+  }
+  
+  std::string ReadArchive(const std::string& workspace_id) {
+    std::string data;
+    base::RunLoop run_loop;
+    store_->ReadArchive(
+        workspace_id,
+        base::BindOnce(
+            [](base::OnceClosure quit, std::string* data, std::string read) {
+              *data = std::move(read);
+              std::move(quit).Run();
+            },
+            run_loop.QuitClosure(), &data));
+    run_loop.Run();
+    return data;
+  }
+  
+  base::FilePath GetSnapshotPath() const {
+    return temp_dir_.GetPath().Append(FILE_PATH_LITERAL("Workspaces"));
+  }
+  
+  base::FilePath GetJournalPath() const {
+    return temp_dir_.GetPath().Append(FILE_PATH_LITERAL("Workspaces Journal"));
+  }
+  
+  base::test::TaskEnvironment task_environment_{
+      base::test::TaskEnvironment::TimeSource::MOCK_TIME};
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<LunetixWorkspaceStore> store_;
+};
+
+TEST_F(LunetixWorkspaceStoreTest, ReplaysJournalInOrder) {
+  store_->AppendRecord(MakeRecord("create", "workspace_1"));
+  store_->AppendRecord(MakeRecord("rename", "workspace_1"));
+  store_->AppendRecord(MakeRecord("remove", "workspace_1"));
+  EXPECT_EQ(3u, store_->journal_size());
+  
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> result = Reload();
+  EXPECT_TRUE(result->snapshot.is_none());
+  ASSERT_EQ(3u, result->journal.size());
+  EXPECT_EQ("create", *result->journal[0].FindStringKey("op"));
+  EXPECT_EQ("rename", *result->journal[1].FindStringKey("op"));
+  EXPECT_EQ("remove", *result->journal[2].FindStringKey("op"));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, BatchesRecordsUntilCommitDelay) {
+  store_->AppendRecord(MakeRecord("create", "workspace_1"));
+  store_->AppendRecord(MakeRecord("create", "workspace_2"));
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(GetJournalPath()));
+  
+  task_environment_.FastForwardBy(base::Seconds(2));
+  std::string journal;
+  ASSERT_TRUE(base::ReadFileToString(GetJournalPath(), &journal));
+  EXPECT_EQ(2, std::count(journal.begin(), journal.end(), '\n'));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, SkipsTornLastRecord) {
+  ASSERT_TRUE(base::WriteFile(
+      GetJournalPath(),
+      "{\"op\":\"create\",\"id\":\"workspace_1\"}\n{\"op\":\"rena"));
+  
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> result = Reload();
+  ASSERT_EQ(1u, result->journal.size());
+  EXPECT_EQ("workspace_1", *result->journal[0].FindStringKey("id"));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, SnapshotCompactsJournal) {
+  store_->AppendRecord(MakeRecord("create", "workspace_1"));
+  store_->AppendRecord(MakeRecord("activate", "workspace_1"));
+  store_->WriteSnapshot(MakeSnapshot("workspace_1"));
+  EXPECT_EQ(0u, store_->journal_size());
+  task_environment_.RunUntilIdle();
+  EXPECT_FALSE(base::PathExists(GetJournalPath()));
+  
+  // Records after the snapshot land in a fresh journal.
+  store_->AppendRecord(MakeRecord("rename", "workspace_1"));
+  
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> result = Reload();
+  ASSERT_TRUE(result->snapshot.is_dict());
+  EXPECT_EQ("workspace_1", *result->snapshot.FindStringKey("active"));
+  ASSERT_EQ(1u, result->journal.size());
+  EXPECT_EQ("rename", *result->journal[0].FindStringKey("op"));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, KeepsJournalWhenSnapshotFails) {
+  // A directory where the snapshot goes makes every write of it fail.
+  ASSERT_TRUE(base::CreateDirectory(GetSnapshotPath()));
+  
+  store_->AppendRecord(MakeRecord("create", "workspace_1"));
+  store_->AppendRecord(MakeRecord("create", "workspace_2"));
+  store_->WriteSnapshot(MakeSnapshot("workspace_2"));
+  task_environment_.RunUntilIdle();
+  
+  // The records still count towards the next compaction.
+  EXPECT_EQ(2u, store_->journal_size());
+  
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> result = Reload();
+  EXPECT_TRUE(result->snapshot.is_none());
+  ASSERT_EQ(2u, result->journal.size());
+  EXPECT_EQ("workspace_2", *result->journal[1].FindStringKey("id"));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, IgnoresUnreadableSnapshot) {
+  ASSERT_TRUE(base::WriteFile(GetSnapshotPath(), "[1, 2"));
+  store_->AppendRecord(MakeRecord("create", "workspace_1"));
+  
+  std::unique_ptr<LunetixWorkspaceStore::LoadResult> result = Reload();
+  EXPECT_TRUE(result->snapshot.is_none());
+  EXPECT_EQ(1u, result->journal.size());
+}
+
+TEST_F(LunetixWorkspaceStoreTest, WritesReadsAndDeletesArchives) {
+  EXPECT_TRUE(WriteArchive("workspace_1", "first"));
+  EXPECT_TRUE(WriteArchive("workspace_2", "second"));
+  EXPECT_EQ("first", ReadArchive("workspace_1"));
+  EXPECT_EQ("second", ReadArchive("workspace_2"));
+  
+  store_->DeleteArchive("workspace_1");
+  EXPECT_EQ("", ReadArchive("workspace_1"));
+  EXPECT_EQ("second", ReadArchive("workspace_2"));
+}
+
+TEST_F(LunetixWorkspaceStoreTest, ReportsFailedArchiveWrite) {
+  ASSERT_TRUE(base::CreateDirectory(
+      temp_dir_.GetPath().AppendASCII("workspace_1.lws")));
+  EXPECT_FALSE(WriteArchive("workspace_1", "tabs"));
+  EXPECT_EQ("", ReadArchive("workspace_1"));
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,51 @@
+// Compiles EasyList-format filter lists into a ruleset file:
+//
+//   lunetix_filter_compiler --output=<ruleset> <filter list>...
+
+#include <stdio.h>
+
+#include <string>
+
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "lunetix/common/adblock/ruleset_builder.h"
+
+namespace {
+
+const char kOutputSwitch[] = "output";
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  base::CommandLine::Init(argc, argv);
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  base::FilePath output = command_line.GetSwitchValuePath(kOutputSwitch);
+  if (output.empty() || command_line.GetArgs().empty()) {
+    fprintf(stderr, "usage: %s --output=<ruleset> <filter list>...\n",
+            argv[0]);
+    return 1;
+  }
+
+  lunetix::adblock::RulesetBuilder builder;
+  for (const auto& arg : command_line.GetArgs()) {
+    base::FilePath path(arg);
+    std::string filter_list;
+    if (!base::ReadFileToString(path, &filter_list)) {
+      fprintf(stderr, "cannot read %s\n", path.AsUTF8Unsafe().c_str());
+      return 1;
+    }
+    size_t rules = builder.AddFilterList(filter_list);
+    printf("%s: %zu rules\n", path.AsUTF8Unsafe().c_str(), rules);
+  }
+
+  std::string ruleset = builder.Build();
+  if (!base::WriteFile(output, ruleset)) {
+    fprintf(stderr, "cannot write %s\n", output.AsUTF8Unsafe().c_str());
+    return 1;
+  }
+  printf("%zu network rules, %zu element hiding rules, %zu bytes\n",
+         builder.rule_count(), builder.cosmetic_rule_count(), ruleset.size());
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "lunetix/common/adblock/filter_parser.h"
+
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "lunetix/common/adblock/ruleset_format.h"
+
+namespace lunetix {
+namespace adblock {
+
+namespace {
+
+const struct {
+  const char* name;
+  uint32_t type;
+} kElementTypeOptions[] = {
+    {"script", kElementTypeScript},
+    {"image", kElementTypeImage},
+    {"stylesheet", kElementTypeStylesheet},
+    {"object", kElementTypeObject},
+    {"xmlhttprequest", kElementTypeXmlHttpRequest},
+    {"subdocument", kElementTypeSubdocument},
+    {"font", kElementTypeFont},
+    {"media", kElementTypeMedia},
+    {"websocket", kElementTypeWebSocket},
+    {"ping", kElementTypePing},
+    {"other", kElementTypeOther},
+};
+
+bool IsCosmeticFilter(base::StringPiece line) {
+  for (base::StringPiece marker : {"##", "#@#", "#?#", "#$#"}) {
+    if (line.find(marker) != base::StringPiece::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Extended selector syntax of other blockers, which a style sheet cannot
+// express.
+const char* const kProceduralOperators[] = {
+    ":-abp-",
+    ":has-text(",
+    ":matches-css",
+    ":matches-path(",
+    ":min-text-length(",
+    ":others(",
+    ":remove(",
+    ":style(",
+    ":upward(",
+    ":watch-attr(",
+    ":xpath(",
+};
+
+bool IsIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '-' || c == '_';
+}
+
+bool ParseOptions(base::StringPiece options, NetworkFilter* filter) {
+  uint32_t included_types = 0;
+  uint32_t excluded_types = 0;
+  for (base::StringPiece option : base::SplitStringPiece(
+           options, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    bool negated = base::StartsWith(option, "~");
+    if (negated) {
+      option.remove_prefix(1);
+    }
+
+    if (option == "third-party" || option == "3p") {
+      filter->flags |= negated ? kRuleFirstPartyOnly : kRuleThirdPartyOnly;
+      continue;
+    }
+    if (option == "first-party" || option == "1p") {
+      filter->flags |= negated ? kRuleThirdPartyOnly : kRuleFirstPartyOnly;
+      continue;
+    }
+    if (option == "match-case" && !negated) {
+      filter->flags |= kRuleMatchCase;
+      continue;
+    }
+    if (base::StartsWith(option, "domain=") && !negated) {
+      option.remove_prefix(7);
+      for (base::StringPiece domain : base::SplitStringPiece(
+               option, "|", base::TRIM_WHITESPACE,
+               base::SPLIT_WANT_NONEMPTY)) {
+        if (base::StartsWith(domain, "~")) {
+          filter->excluded_domains.push_back(
+              base::ToLowerASCII(domain.substr(1)));
+        } else {
+          filter->included_domains.push_back(base::ToLowerASCII(domain));
+        }
+      }
+      continue;
+    }
+
+    bool known_type = false;
+    for (const auto& type_option : kElementTypeOptions) {
+      if (option == type_option.name) {
+        (negated ? excluded_types : included_types) |= type_option.type;
+        known_type = true;
+        break;
+      }
+    }
+    if (!known_type) {
+      return false;
+    }
+  }
+
+  filter->element_types =
+      (included_types ? included_types : kElementTypeAll) & ~excluded_types;
+  return filter->element_types != 0 &&
+         (filter->flags & (kRuleFirstPartyOnly | kRuleThirdPartyOnly)) !=
+             (kRuleFirstPartyOnly | kRuleThirdPartyOnly);
+}
+
+}  // namespace
+
+NetworkFilter::NetworkFilter() = default;
+
+NetworkFilter::NetworkFilter(const NetworkFilter& other) = default;
+
+NetworkFilter::NetworkFilter(NetworkFilter&& other) = default;
+
+NetworkFilter& NetworkFilter::operator=(const NetworkFilter& other) = default;
+
+NetworkFilter& NetworkFilter::operator=(NetworkFilter&& other) = default;
+
+NetworkFilter::~NetworkFilter() = default;
+
+CosmeticFilter::CosmeticFilter() = default;
+
+CosmeticFilter::CosmeticFilter(const CosmeticFilter& other) = default;
+
+CosmeticFilter::CosmeticFilter(CosmeticFilter&& other) = default;
+
+CosmeticFilter& CosmeticFilter::operator=(const CosmeticFilter& other) =
+    default;
+
+CosmeticFilter& CosmeticFilter::operator=(CosmeticFilter&& other) = default;
+
+CosmeticFilter::~CosmeticFilter() = default;
+
+bool ParseNetworkFilter(base::StringPiece line, NetworkFilter* filter) {
+  *filter = NetworkFilter();
+  line = base::TrimWhitespaceASCII(line, base::TRIM_ALL);
+  if (line.empty() || line[0] == '!' || line[0] == '[' ||
+      IsCosmeticFilter(line)) {
+    return false;
+  }
+
+  if (base::StartsWith(line, "@@")) {
+    filter->flags |= kRuleException;
+    line.remove_prefix(2);
+  }
+
+  size_t options_start = line.rfind('$');
+  base::StringPiece options;
+  if (options_start != base::StringPiece::npos) {
+    options = line.substr(options_start + 1);
+    line = line.substr(0, options_start);
+  }
+  if (!ParseOptions(options, filter)) {
+    return false;
+  }
+
+  // Regular expression rules are rare and too slow to match per request.
+  if (line.size() > 1 && line.front() == '/' && line.back() == '/') {
+    return false;
+  }
+
+  if (base::StartsWith(line, "||")) {
+    filter->flags |= kRuleAnchorHost;
+    line.remove_prefix(2);
+  } else if (base::StartsWith(line, "|")) {
+    filter->flags |= kRuleAnchorStart;
+    line.remove_prefix(1);
+  }
+  if (base::EndsWith(line, "|")) {
+    filter->flags |= kRuleAnchorEnd;
+    line.remove_suffix(1);
+  }
+
+  // Leading and trailing wildcards only undo anchors, and runs of them
+  // match the same as one.
+  while (base::StartsWith(line, "*")) {
+    filter->flags &= ~(kRuleAnchorStart | kRuleAnchorHost);
+    line.remove_prefix(1);
+  }
+  while (base::EndsWith(line, "*")) {
+    filter->flags &= ~kRuleAnchorEnd;
+    line.remove_suffix(1);
+  }
+  for (char c : line) {
+    if (c != '*' || filter->pattern.empty() || filter->pattern.back() != '*') {
+      filter->pattern.push_back(c);
+    }
+  }
+  if (!(filter->flags & kRuleMatchCase)) {
+    filter->pattern = base::ToLowerASCII(filter->pattern);
+  }
+
+  // A rule that matches every request is almost always a mistake.
+  return !filter->pattern.empty() || !filter->included_domains.empty() ||
+         filter->element_types != kElementTypeAll;
+}
+
+bool ParseCosmeticFilter(base::StringPiece line, CosmeticFilter* filter) {
+  *filter = CosmeticFilter();
+  line = base::TrimWhitespaceASCII(line, base::TRIM_ALL);
+  if (line.empty() || line[0] == '!') {
+    return false;
+  }
+
+  size_t separator = line.find('#');
+  while (separator != base::StringPiece::npos &&
+         !base::StartsWith(line.substr(separator), "##") &&
+         !base::StartsWith(line.substr(separator), "#@#")) {
+    separator = line.find('#', separator + 1);
+  }
+  if (separator == base::StringPiece::npos) {
+    return false;
+  }
+  filter->is_exception = line[separator + 1] == '@';
+  base::StringPiece domains = line.substr(0, separator);
+  base::StringPiece selector =
+      line.substr(separator + (filter->is_exception ? 3 : 2));
+
+  // "##+js(...)" scriptlets and "##^" HTML filters are not selectors.
+  selector = base::TrimWhitespaceASCII(selector, base::TRIM_ALL);
+  if (selector.empty() || selector[0] == '+' || selector[0] == '^') {
+    return false;
+  }
+  for (const char* op : kProceduralOperators) {
+    if (selector.find(op) != base::StringPiece::npos) {
+      return false;
+    }
+  }
+  // The selector is pasted into a style sheet, where a brace would end the
+  // rule and let the rest restyle the page.
+  if (selector.find_first_of("{}") != base::StringPiece::npos ||
+      selector.find("/*") != base::StringPiece::npos) {
+    return false;
+  }
+  filter->selector = std::string(selector);
+
+  for (base::StringPiece domain : base::SplitStringPiece(
+           domains, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    if (base::StartsWith(domain, "~")) {
+      filter->excluded_domains.push_back(base::ToLowerASCII(domain.substr(1)));
+    } else {
+      filter->included_domains.push_back(base::ToLowerASCII(domain));
+    }
+  }
+  return true;
+}
+
+base::StringPiece GetSelectorKey(base::StringPiece selector) {
+  // Any selector of a list could match, so a list has no single key.
+  if (selector.size() < 2 || (selector[0] != '.' && selector[0] != '#') ||
+      selector.find(',') != base::StringPiece::npos) {
+    return base::StringPiece();
+  }
+  size_t end = 1;
+  while (end < selector.size() && IsIdentifierChar(selector[end])) {
+    ++end;
+  }
+  // Escapes and non-ASCII names would need unescaping to compare.
+  if (end == 1 || (end < selector.size() &&
+                   (selector[end] == '\\' ||
+                    static_cast<unsigned char>(selector[end]) >= 0x80))) {
+    return base::StringPiece();
+  }
+  return selector.substr(0, end);
+}
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
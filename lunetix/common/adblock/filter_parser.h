@@ -0,0 +1,70 @@
+#ifndef LUNETIX_COMMON_ADBLOCK_FILTER_PARSER_H_
+#define LUNETIX_COMMON_ADBLOCK_FILTER_PARSER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+
+namespace lunetix {
+namespace adblock {
+
+// A request blocking rule of an EasyList-format filter list.
+struct NetworkFilter {
+  NetworkFilter();
+  NetworkFilter(const NetworkFilter& other);
+  NetworkFilter(NetworkFilter&& other);
+  NetworkFilter& operator=(const NetworkFilter& other);
+  NetworkFilter& operator=(NetworkFilter&& other);
+  ~NetworkFilter();
+
+  // The pattern without its anchors. "*" matches anything and "^" a
+  // separator character or the end of the URL.
+  std::string pattern;
+  // RuleFlags.
+  uint32_t flags = 0;
+  // ElementType bits.
+  uint32_t element_types = 0;
+  // Lower case hosts of the "domain=" option.
+  std::vector<std::string> included_domains;
+  std::vector<std::string> excluded_domains;
+};
+
+// An element hiding rule, "domains##selector" or "domains#@#selector".
+struct CosmeticFilter {
+  CosmeticFilter();
+  CosmeticFilter(const CosmeticFilter& other);
+  CosmeticFilter(CosmeticFilter&& other);
+  CosmeticFilter& operator=(const CosmeticFilter& other);
+  CosmeticFilter& operator=(CosmeticFilter&& other);
+  ~CosmeticFilter();
+
+  std::string selector;
+  // "#@#" rules keep |selector| visible on their domains.
+  bool is_exception = false;
+  // Lower case hosts before the separator. A rule without included
+  // domains is generic and applies to every page.
+  std::vector<std::string> included_domains;
+  std::vector<std::string> excluded_domains;
+};
+
+// Returns false for comments, element hiding rules and rules using syntax
+// or options the engine does not support. Those are skipped as a whole, as
+// applying only part of a rule could block more than its author meant.
+bool ParseNetworkFilter(base::StringPiece line, NetworkFilter* filter);
+
+// Returns false for everything but element hiding rules with a plain CSS
+// selector. Procedural selectors, scriptlets and HTML filters are skipped.
+bool ParseCosmeticFilter(base::StringPiece line, CosmeticFilter* filter);
+
+// Returns the class or id, with its "." or "#", that some element of a
+// document must have for |selector| to match anything there, or an empty
+// piece if the selector does not start with one.
+base::StringPiece GetSelectorKey(base::StringPiece selector);
+
+}  // namespace adblock
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_ADBLOCK_FILTER_PARSER_H_
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "lunetix/common/adblock/mapped_ruleset.h"
+
+#include <utility>
+
+namespace lunetix {
+namespace adblock {
+
+// static
+scoped_refptr<MappedRuleset> MappedRuleset::Open(base::File file) {
+  if (!file.IsValid()) {
+    return nullptr;
+  }
+  base::File file_for_mapping = file.Duplicate();
+  auto mapping = std::make_unique<base::MemoryMappedFile>();
+  if (!mapping->Initialize(std::move(file_for_mapping))) {
+    return nullptr;
+  }
+  std::unique_ptr<RulesetMatcher> matcher = RulesetMatcher::Create(
+      base::make_span(mapping->data(), mapping->length()));
+  if (!matcher) {
+    return nullptr;
+  }
+  return base::WrapRefCounted(new MappedRuleset(
+      std::move(file), std::move(mapping), std::move(matcher)));
+}
+
+MappedRuleset::MappedRuleset(base::File file,
+                             std::unique_ptr<base::MemoryMappedFile> mapping,
+                             std::unique_ptr<RulesetMatcher> matcher)
+    : file_(std::move(file)),
+      mapping_(std::move(mapping)),
+      matcher_(std::move(matcher)) {}
+
+MappedRuleset::~MappedRuleset() = default;
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
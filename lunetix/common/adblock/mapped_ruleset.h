@@ -0,0 +1,49 @@
+#ifndef LUNETIX_COMMON_ADBLOCK_MAPPED_RULESET_H_
+#define LUNETIX_COMMON_ADBLOCK_MAPPED_RULESET_H_
+
+#include <memory>
+
+#include "base/files/file.h"
+#include "base/files/memory_mapped_file.h"
+#include "base/memory/ref_counted.h"
+#include "lunetix/common/adblock/ruleset_matcher.h"
+
+namespace lunetix {
+namespace adblock {
+
+// A compiled ruleset mapped read-only, together with its matcher. The
+// browser hands a duplicate of the file to every renderer, which maps the
+// same pages, so a ruleset costs its size once however many processes
+// match against it. Shared across threads; a new ruleset replaces an old
+// one as a whole, and the old mapping goes away with its last user.
+class MappedRuleset : public base::RefCountedThreadSafe<MappedRuleset> {
+ public:
+  // Returns null if |file| cannot be mapped or is not a well-formed
+  // ruleset. Maps the file, so may block.
+  static scoped_refptr<MappedRuleset> Open(base::File file);
+
+  const RulesetMatcher& matcher() const { return *matcher_; }
+
+  // A read-only handle to the file for another process.
+  base::File DuplicateFile() const { return file_.Duplicate(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<MappedRuleset>;
+
+  MappedRuleset(base::File file,
+                std::unique_ptr<base::MemoryMappedFile> mapping,
+                std::unique_ptr<RulesetMatcher> matcher);
+  ~MappedRuleset();
+
+  base::File file_;
+  // |matcher_| reads from the mapping, so it goes first.
+  std::unique_ptr<base::MemoryMappedFile> mapping_;
+  std::unique_ptr<RulesetMatcher> matcher_;
+
+  DISALLOW_COPY_AND_ASSIGN(MappedRuleset);
+};
+
+}  // namespace adblock
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_ADBLOCK_MAPPED_RULESET_H_
\ No newline at end of file
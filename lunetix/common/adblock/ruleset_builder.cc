@@ -0,0 +1,317 @@
+#include "lunetix/common/adblock/ruleset_builder.h"
+
+#include <string.h>
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+#include "base/strings/string_split.h"
+#include "lunetix/common/adblock/ruleset_format.h"
+
+namespace lunetix {
+namespace adblock {
+
+namespace {
+
+using RuleGroups = std::map<uint32_t, std::vector<uint32_t>>;
+
+// Returns the host of a rule like "||ads.example^", which is matched
+// through the host table instead of by token. Without the trailing '^' the
+// pattern may end inside a label, as "||ads.example" does for
+// ads.example.com, which a lookup by whole host suffix would miss.
+bool GetAnchoredHost(const NetworkFilter& filter, base::StringPiece* host) {
+  if (!(filter.flags & kRuleAnchorHost) || (filter.flags & kRuleAnchorEnd)) {
+    return false;
+  }
+  base::StringPiece pattern = filter.pattern;
+  if (pattern.empty() || pattern.back() != '^') {
+    return false;
+  }
+  pattern.remove_suffix(1);
+  if (pattern.empty()) {
+    return false;
+  }
+  for (char c : pattern) {
+    if (!IsTokenChar(c) && c != '.' && c != '-') {
+      return false;
+    }
+  }
+  *host = pattern;
+  return true;
+}
+
+// Tokens of the pattern that are guaranteed to appear as a whole token in
+// every URL the rule matches.
+std::vector<uint32_t> GetUsableTokens(const NetworkFilter& filter) {
+  std::vector<uint32_t> tokens;
+  base::StringPiece pattern = filter.pattern;
+  size_t i = 0;
+  while (i < pattern.size()) {
+    if (!IsTokenChar(pattern[i])) {
+      ++i;
+      continue;
+    }
+    size_t begin = i;
+    while (i < pattern.size() && IsTokenChar(pattern[i])) {
+      ++i;
+    }
+    bool starts_token =
+        begin > 0 ? pattern[begin - 1] != '*'
+                  : (filter.flags & (kRuleAnchorStart | kRuleAnchorHost)) != 0;
+    bool ends_token = i < pattern.size() ? pattern[i] != '*'
+                                         : (filter.flags & kRuleAnchorEnd) != 0;
+    if (starts_token && ends_token) {
+      tokens.push_back(HashLowerCase(pattern.substr(begin, i - begin)));
+    }
+  }
+  return tokens;
+}
+
+Rule AppendRule(base::StringPiece pattern,
+                uint32_t flags,
+                uint32_t element_types,
+                const std::vector<std::string>& included_domains,
+                const std::vector<std::string>& excluded_domains,
+                std::string* strings,
+                std::vector<uint32_t>* domain_hashes) {
+  Rule rule;
+  rule.pattern_offset = strings->size();
+  rule.pattern_length = pattern.size();
+  rule.flags = flags;
+  rule.element_types = element_types;
+  rule.domains_offset = domain_hashes->size();
+  rule.included_domain_count = included_domains.size();
+  rule.excluded_domain_count = excluded_domains.size();
+  strings->append(pattern.data(), pattern.size());
+  for (const std::string& domain : included_domains) {
+    domain_hashes->push_back(HashLowerCase(domain));
+  }
+  for (const std::string& domain : excluded_domains) {
+    domain_hashes->push_back(HashLowerCase(domain));
+  }
+  return rule;
+}
+
+void Align(std::string* data) {
+  data->resize((data->size() + 3) & ~size_t{3});
+}
+
+template <typename T>
+Section Append(std::string* data, const std::vector<T>& items) {
+  Align(data);
+  Section section = {static_cast<uint32_t>(data->size()),
+                     static_cast<uint32_t>(items.size())};
+  if (!items.empty()) {
+    data->append(reinterpret_cast<const char*>(items.data()),
+                 items.size() * sizeof(T));
+  }
+  return section;
+}
+
+// Bloom filter of every key of |token_groups| and |host_groups|.
+std::vector<uint32_t> BuildKeyFilter(const RuleGroups& token_groups,
+                                     const RuleGroups& host_groups) {
+  const size_t key_count = token_groups.size() + host_groups.size();
+  if (!key_count) {
+    return {};
+  }
+  const size_t block_bits = kKeyFilterBlockWords * 32;
+  const uint32_t block_count = static_cast<uint32_t>(
+      (key_count * kKeyFilterBitsPerKey + block_bits - 1) / block_bits);
+  std::vector<uint32_t> words(block_count * kKeyFilterBlockWords, 0);
+  for (const RuleGroups* groups : {&token_groups, &host_groups}) {
+    for (const auto& group : *groups) {
+      uint32_t* block =
+          &words[GetKeyFilterBlock(group.first, block_count) *
+                 kKeyFilterBlockWords];
+      for (uint32_t probe = 0; probe < kKeyFilterProbes; ++probe) {
+        uint32_t bit = GetKeyFilterBit(group.first, probe);
+        block[bit / 32] |= 1u << (bit % 32);
+      }
+    }
+  }
+  return words;
+}
+
+// Lays out |groups| as an open addressed table with linear probing.
+std::vector<Bucket> BuildBuckets(const RuleGroups& groups,
+                                 std::vector<uint32_t>* rule_indices) {
+  if (groups.empty()) {
+    return {};
+  }
+  size_t size = 1;
+  while (size < groups.size() * 2) {
+    size <<= 1;
+  }
+  std::vector<Bucket> buckets(size, Bucket{0, 0, 0});
+  for (const auto& group : groups) {
+    size_t slot = group.first & (size - 1);
+    while (buckets[slot].hash) {
+      slot = (slot + 1) & (size - 1);
+    }
+    buckets[slot] = {group.first, static_cast<uint32_t>(rule_indices->size()),
+                     static_cast<uint32_t>(group.second.size())};
+    rule_indices->insert(rule_indices->end(), group.second.begin(),
+                         group.second.end());
+  }
+  return buckets;
+}
+
+}  // namespace
+
+RulesetBuilder::RulesetBuilder() = default;
+
+RulesetBuilder::~RulesetBuilder() = default;
+
+size_t RulesetBuilder::AddFilterList(base::StringPiece filter_list) {
+  size_t added = 0;
+  NetworkFilter filter;
+  CosmeticFilter cosmetic_filter;
+  for (base::StringPiece line : base::SplitStringPiece(
+           filter_list, "\r\n", base::TRIM_WHITESPACE,
+           base::SPLIT_WANT_NONEMPTY)) {
+    if (ParseNetworkFilter(line, &filter)) {
+      filters_.push_back(std::move(filter));
+      ++added;
+    } else if (ParseCosmeticFilter(line, &cosmetic_filter)) {
+      cosmetic_filters_.push_back(std::move(cosmetic_filter));
+      ++added;
+    }
+  }
+  return added;
+}
+
+void RulesetBuilder::AddFilter(const NetworkFilter& filter) {
+  filters_.push_back(filter);
+}
+
+void RulesetBuilder::AddCosmeticFilter(const CosmeticFilter& filter) {
+  cosmetic_filters_.push_back(filter);
+}
+
+std::string RulesetBuilder::Build() const {
+  std::vector<Rule> rules;
+  std::vector<uint32_t> domain_hashes;
+  std::string strings;
+  rules.reserve(filters_.size());
+  for (const NetworkFilter& filter : filters_) {
+    rules.push_back(AppendRule(filter.pattern, filter.flags,
+                               filter.element_types, filter.included_domains,
+                               filter.excluded_domains, &strings,
+                               &domain_hashes));
+  }
+
+  // Each rule goes under the token fewest other rules could use, which
+  // keeps the lists a request walks short.
+  std::vector<std::vector<uint32_t>> tokens(filters_.size());
+  std::unordered_map<uint32_t, uint32_t> token_counts;
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    base::StringPiece host;
+    if (GetAnchoredHost(filters_[i], &host)) {
+      continue;
+    }
+    tokens[i] = GetUsableTokens(filters_[i]);
+    for (uint32_t token : tokens[i]) {
+      ++token_counts[token];
+    }
+  }
+
+  RuleGroups token_groups;
+  RuleGroups host_groups;
+  std::vector<uint32_t> untokenized_rules;
+  for (size_t i = 0; i < filters_.size(); ++i) {
+    base::StringPiece host;
+    if (GetAnchoredHost(filters_[i], &host)) {
+      host_groups[HashLowerCase(host)].push_back(i);
+      continue;
+    }
+    if (tokens[i].empty()) {
+      untokenized_rules.push_back(i);
+      continue;
+    }
+    uint32_t best = tokens[i][0];
+    for (uint32_t token : tokens[i]) {
+      if (token_counts[token] < token_counts[best]) {
+        best = token;
+      }
+    }
+    token_groups[best].push_back(i);
+  }
+
+  std::vector<uint32_t> rule_indices;
+  std::vector<Bucket> token_buckets = BuildBuckets(token_groups, &rule_indices);
+  std::vector<Bucket> host_buckets = BuildBuckets(host_groups, &rule_indices);
+  std::vector<uint32_t> key_filter = BuildKeyFilter(token_groups, host_groups);
+
+  // A "#@#" rule without domains turns a selector off everywhere, so it is
+  // applied here rather than on every page.
+  std::set<base::StringPiece> disabled_selectors;
+  for (const CosmeticFilter& filter : cosmetic_filters_) {
+    if (filter.is_exception && filter.included_domains.empty()) {
+      disabled_selectors.insert(filter.selector);
+    }
+  }
+
+  std::vector<Rule> cosmetic_rules;
+  RuleGroups cosmetic_host_groups;
+  RuleGroups cosmetic_key_groups;
+  std::vector<uint32_t> unkeyed_cosmetic_rules;
+  for (const CosmeticFilter& filter : cosmetic_filters_) {
+    if (filter.is_exception ? filter.included_domains.empty()
+                            : disabled_selectors.count(filter.selector) > 0) {
+      continue;
+    }
+    uint32_t index = cosmetic_rules.size();
+    cosmetic_rules.push_back(AppendRule(
+        filter.selector, filter.is_exception ? kRuleException : 0, 0,
+        filter.included_domains, filter.excluded_domains, &strings,
+        &domain_hashes));
+    if (!filter.included_domains.empty()) {
+      for (const std::string& domain : filter.included_domains) {
+        cosmetic_host_groups[HashLowerCase(domain)].push_back(index);
+      }
+      continue;
+    }
+    base::StringPiece key = GetSelectorKey(filter.selector);
+    if (key.empty()) {
+      unkeyed_cosmetic_rules.push_back(index);
+    } else {
+      cosmetic_key_groups[HashLowerCase(key)].push_back(index);
+    }
+  }
+
+  std::vector<uint32_t> cosmetic_rule_indices;
+  std::vector<Bucket> cosmetic_host_buckets =
+      BuildBuckets(cosmetic_host_groups, &cosmetic_rule_indices);
+  std::vector<Bucket> cosmetic_key_buckets =
+      BuildBuckets(cosmetic_key_groups, &cosmetic_rule_indices);
+
+  RulesetHeader header = {};
+  std::string data(sizeof(header), '\0');
+  header.magic = kRulesetMagic;
+  header.version = kRulesetVersion;
+  header.rules = Append(&data, rules);
+  header.rule_indices = Append(&data, rule_indices);
+  header.token_buckets = Append(&data, token_buckets);
+  header.host_buckets = Append(&data, host_buckets);
+  header.untokenized_rules = Append(&data, untokenized_rules);
+  header.domain_hashes = Append(&data, domain_hashes);
+  header.strings = Append(&data, std::vector<char>(strings.begin(),
+                                                   strings.end()));
+  header.cosmetic_rules = Append(&data, cosmetic_rules);
+  header.cosmetic_rule_indices = Append(&data, cosmetic_rule_indices);
+  header.cosmetic_host_buckets = Append(&data, cosmetic_host_buckets);
+  header.cosmetic_key_buckets = Append(&data, cosmetic_key_buckets);
+  header.unkeyed_cosmetic_rules = Append(&data, unkeyed_cosmetic_rules);
+  // Each block on a cache line of its own, given a page aligned mapping.
+  data.resize((data.size() + 63) & ~size_t{63});
+  header.key_filter = Append(&data, key_filter);
+  Align(&data);
+  header.file_size = data.size();
+  memcpy(&data[0], &header, sizeof(header));
+  return data;
+}
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef LUNETIX_COMMON_ADBLOCK_RULESET_BUILDER_H_
+#define LUNETIX_COMMON_ADBLOCK_RULESET_BUILDER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "lunetix/common/adblock/filter_parser.h"
+
+namespace lunetix {
+namespace adblock {
+
+// Compiles filter lists into the flat ruleset read by RulesetMatcher. Each
+// rule is indexed under the rarest token of its pattern, so a request only
+// visits rules that share a token with its URL. Rules naming just a host
+// go into a separate host table instead, and a Bloom filter of the keys of
+// both tables lets a request skip the tables for the tokens and hosts no
+// rule is keyed by. Element hiding rules are indexed
+// by the domains they name, or by the class or id their selector starts
+// with.
+class RulesetBuilder {
+ public:
+  RulesetBuilder();
+  ~RulesetBuilder();
+
+  // Returns the number of network and element hiding rules taken from
+  // |filter_list|.
+  size_t AddFilterList(base::StringPiece filter_list);
+  void AddFilter(const NetworkFilter& filter);
+  void AddCosmeticFilter(const CosmeticFilter& filter);
+
+  size_t rule_count() const { return filters_.size(); }
+  size_t cosmetic_rule_count() const { return cosmetic_filters_.size(); }
+
+  // Serializes everything added so far.
+  std::string Build() const;
+
+ private:
+  std::vector<NetworkFilter> filters_;
+  std::vector<CosmeticFilter> cosmetic_filters_;
+
+  DISALLOW_COPY_AND_ASSIGN(RulesetBuilder);
+};
+
+}  // namespace adblock
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_ADBLOCK_RULESET_BUILDER_H_
\ No newline at end of file
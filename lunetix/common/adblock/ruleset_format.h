@@ -0,0 +1,152 @@
+#ifndef LUNETIX_COMMON_ADBLOCK_RULESET_FORMAT_H_
+#define LUNETIX_COMMON_ADBLOCK_RULESET_FORMAT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/strings/string_piece.h"
+
+// Layout of a compiled ruleset. The file is used in place through a
+// read-only mapping, so every structure is plain data of 32-bit fields and
+// sections are referenced by offset from the start of the file.
+namespace lunetix {
+namespace adblock {
+
+constexpr uint32_t kRulesetMagic = 0x4c584142;  // "BAXL"
+constexpr uint32_t kRulesetVersion = 3;
+
+// Resource types a rule applies to, from EasyList's type options.
+enum ElementType : uint32_t {
+  kElementTypeOther = 1 << 0,
+  kElementTypeScript = 1 << 1,
+  kElementTypeImage = 1 << 2,
+  kElementTypeStylesheet = 1 << 3,
+  kElementTypeObject = 1 << 4,
+  kElementTypeXmlHttpRequest = 1 << 5,
+  kElementTypeSubdocument = 1 << 6,
+  kElementTypeFont = 1 << 7,
+  kElementTypeMedia = 1 << 8,
+  kElementTypeWebSocket = 1 << 9,
+  kElementTypePing = 1 << 10,
+  kElementTypeAll = (1 << 11) - 1,
+};
+
+enum RuleFlags : uint32_t {
+  // "@@" rules allow what other rules block.
+  kRuleException = 1 << 0,
+  // "|" anchors the pattern to the start of the URL.
+  kRuleAnchorStart = 1 << 1,
+  // "||" anchors the pattern to the start of the host or of a subdomain.
+  kRuleAnchorHost = 1 << 2,
+  // A trailing "|" anchors the pattern to the end of the URL.
+  kRuleAnchorEnd = 1 << 3,
+  kRuleMatchCase = 1 << 4,
+  kRuleFirstPartyOnly = 1 << 5,
+  kRuleThirdPartyOnly = 1 << 6,
+};
+
+struct Section {
+  uint32_t offset;
+  uint32_t count;
+};
+
+struct Rule {
+  // Into the string section. Lower case unless kRuleMatchCase is set.
+  uint32_t pattern_offset;
+  uint32_t pattern_length;
+  uint32_t flags;
+  uint32_t element_types;
+  // Hashes of the "domain=" option in the domain list section, included
+  // domains first.
+  uint32_t domains_offset;
+  uint16_t included_domain_count;
+  uint16_t excluded_domain_count;
+};
+
+// Open addressed hash table entry. A zero hash marks an empty slot.
+struct Bucket {
+  uint32_t hash;
+  // Range in the rule index section.
+  uint32_t first_rule;
+  uint32_t rule_count;
+};
+
+struct RulesetHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t file_size;
+  Section rules;
+  // uint32_t indices into |rules|, grouped by bucket.
+  Section rule_indices;
+  // Rules keyed by a token of their pattern. Power of two sized.
+  Section token_buckets;
+  // Host anchored rules keyed by the host they name, matched against every
+  // suffix of the request host. Power of two sized.
+  Section host_buckets;
+  // Rules without a usable token, checked for every request.
+  Section untokenized_rules;
+  Section domain_hashes;
+  Section strings;
+  // Element hiding rules, stored as Rules whose pattern is the selector.
+  // "#@#" rules carry kRuleException.
+  Section cosmetic_rules;
+  // uint32_t indices into |cosmetic_rules|, grouped by bucket.
+  Section cosmetic_rule_indices;
+  // Rules naming domains, keyed by each of them. Power of two sized.
+  Section cosmetic_host_buckets;
+  // Generic rules keyed by the class or id their selector starts with, so
+  // they are only applied once a document uses it. Power of two sized.
+  Section cosmetic_key_buckets;
+  // Generic rules without a key, applied to every document.
+  Section unkeyed_cosmetic_rules;
+  // Bloom filter of the keys of |token_buckets| and |host_buckets|, in
+  // blocks of kKeyFilterBlockWords uint32_t words. Empty when no rule is
+  // keyed.
+  Section key_filter;
+};
+
+// The key filter is a blocked Bloom filter: every key sets its bits within
+// one 512-bit block, so ruling out a token or host that no rule is keyed by
+// reads one cache line, where a probe into the much larger bucket tables
+// would likely miss the cache. At 10 bits per key about one in a hundred
+// absent keys gets through.
+constexpr uint32_t kKeyFilterBlockWords = 16;
+constexpr uint32_t kKeyFilterBitsPerKey = 10;
+constexpr uint32_t kKeyFilterProbes = 6;
+
+inline uint32_t GetKeyFilterBlock(uint32_t hash, uint32_t block_count) {
+  return static_cast<uint32_t>((uint64_t{hash} * block_count) >> 32);
+}
+
+// The bit |probe| sets for |hash| within its block. The hash is mixed
+// first, so the bits do not follow from the high bits that chose the block.
+inline uint32_t GetKeyFilterBit(uint32_t hash, uint32_t probe) {
+  uint32_t mixed = hash * 0x85ebca6bu;
+  mixed ^= mixed >> 15;
+  uint32_t stride = (mixed >> 9) | 1;
+  return (mixed + probe * stride) & (kKeyFilterBlockWords * 32 - 1);
+}
+
+// Hash used for tokens, hosts and domains: FNV-1a over the lower case
+// bytes, never zero.
+inline uint32_t HashLowerCase(base::StringPiece text) {
+  uint32_t hash = 2166136261u;
+  for (char c : text) {
+    if (c >= 'A' && c <= 'Z') {
+      c += 'a' - 'A';
+    }
+    hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+  }
+  return hash ? hash : 1;
+}
+
+// Tokens are the runs of these characters in patterns and URLs.
+inline bool IsTokenChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+         (c >= '0' && c <= '9') || c == '%';
+}
+
+}  // namespace adblock
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_ADBLOCK_RULESET_FORMAT_H_
\ No newline at end of file
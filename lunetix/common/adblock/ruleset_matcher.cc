@@ -0,0 +1,480 @@
+#include "lunetix/common/adblock/ruleset_matcher.h"
+
+#include <algorithm>
+
+#include "base/memory/ptr_util.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+namespace adblock {
+
+namespace {
+
+constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+bool IsSeparator(char c) {
+  return !IsTokenChar(c) && c != '_' && c != '-' && c != '.';
+}
+
+char ToLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+// Glob match of |pattern| against |url| from |start|. "*" matches any run
+// of characters and "^" a separator or the end of the URL.
+bool MatchesAt(base::StringPiece pattern,
+               base::StringPiece url,
+               size_t start,
+               bool match_case,
+               bool anchor_end) {
+  size_t p = 0;
+  size_t u = start;
+  size_t star_p = kNotFound;
+  size_t star_u = 0;
+  while (true) {
+    if (p == pattern.size()) {
+      if (!anchor_end || u == url.size()) {
+        return true;
+      }
+    } else if (pattern[p] == '*') {
+      star_p = ++p;
+      star_u = u;
+      continue;
+    } else if (u < url.size()) {
+      char c = match_case ? url[u] : ToLower(url[u]);
+      if (pattern[p] == '^' ? IsSeparator(c) : pattern[p] == c) {
+        ++p;
+        ++u;
+        continue;
+      }
+    } else if (pattern[p] == '^') {
+      ++p;
+      continue;
+    }
+    // Let the last "*" absorb one more character and retry from there.
+    if (star_p == kNotFound || star_u >= url.size()) {
+      return false;
+    }
+    p = star_p;
+    u = ++star_u;
+  }
+}
+
+template <typename T>
+bool SectionFits(const Section& section, size_t size) {
+  return section.offset % 4 == 0 && section.offset <= size &&
+         section.count <= (size - section.offset) / sizeof(T);
+}
+
+bool IsPowerOfTwoOrZero(uint32_t value) {
+  return (value & (value - 1)) == 0;
+}
+
+}  // namespace
+
+struct RulesetMatcher::Request {
+  base::StringPiece url;
+  size_t host_begin;
+  size_t host_end;
+  base::StringPiece document_host;
+  ElementType element_type;
+  bool is_third_party;
+};
+
+// static
+std::unique_ptr<RulesetMatcher> RulesetMatcher::Create(
+    base::span<const uint8_t> data) {
+  if (data.size() < sizeof(RulesetHeader) ||
+      reinterpret_cast<uintptr_t>(data.data()) % 4) {
+    return nullptr;
+  }
+  auto matcher = base::WrapUnique(new RulesetMatcher(data));
+  return matcher->IsValid() ? std::move(matcher) : nullptr;
+}
+
+RulesetMatcher::RulesetMatcher(base::span<const uint8_t> data)
+    : data_(data),
+      header_(reinterpret_cast<const RulesetHeader*>(data.data())) {}
+
+RulesetMatcher::~RulesetMatcher() = default;
+
+bool RulesetMatcher::ShouldBlock(const GURL& url,
+                                 base::StringPiece document_host,
+                                 ElementType element_type,
+                                 bool is_third_party) const {
+  if (!url.is_valid() ||
+      (!url.SchemeIsHTTPOrHTTPS() && !url.SchemeIsWSOrWSS())) {
+    return false;
+  }
+  const url::Component& host = url.parsed_for_possibly_invalid_spec().host;
+  Request request = {url.possibly_invalid_spec(),
+                     static_cast<size_t>(host.begin),
+                     static_cast<size_t>(host.end()),
+                     document_host,
+                     element_type,
+                     is_third_party};
+
+  bool blocked = false;
+  auto record = [&blocked](Match match) {
+    if (match == Match::kBlock) {
+      blocked = true;
+    }
+    return match == Match::kAllow;
+  };
+
+  // Every suffix of the host: "a.ads.example", "ads.example", "example".
+  base::StringPiece url_host =
+      request.url.substr(request.host_begin, host.len);
+  while (!url_host.empty()) {
+    uint32_t hash = HashLowerCase(url_host);
+    if (MayHaveRules(hash) &&
+        record(MatchBucket(header_->host_buckets, hash, request))) {
+      return false;
+    }
+    size_t dot = url_host.find('.');
+    url_host = dot == base::StringPiece::npos ? base::StringPiece()
+                                              : url_host.substr(dot + 1);
+  }
+
+  // Every token of the URL.
+  for (size_t i = 0; i < request.url.size();) {
+    if (!IsTokenChar(request.url[i])) {
+      ++i;
+      continue;
+    }
+    size_t begin = i;
+    while (i < request.url.size() && IsTokenChar(request.url[i])) {
+      ++i;
+    }
+    uint32_t hash = HashLowerCase(request.url.substr(begin, i - begin));
+    if (MayHaveRules(hash) &&
+        record(MatchBucket(header_->token_buckets, hash, request))) {
+      return false;
+    }
+  }
+
+  const uint32_t* untokenized = At<uint32_t>(header_->untokenized_rules);
+  for (uint32_t i = 0; i < header_->untokenized_rules.count; ++i) {
+    if (record(MatchRule(untokenized[i], request))) {
+      return false;
+    }
+  }
+  return blocked;
+}
+
+bool RulesetMatcher::IsValid() const {
+  const size_t size = data_.size();
+  const RulesetHeader& header = *header_;
+  if (header.magic != kRulesetMagic || header.version != kRulesetVersion ||
+      header.file_size != size || !SectionFits<Rule>(header.rules, size) ||
+      !SectionFits<uint32_t>(header.rule_indices, size) ||
+      !SectionFits<Bucket>(header.token_buckets, size) ||
+      !SectionFits<Bucket>(header.host_buckets, size) ||
+      !SectionFits<uint32_t>(header.untokenized_rules, size) ||
+      !SectionFits<uint32_t>(header.domain_hashes, size) ||
+      !SectionFits<char>(header.strings, size) ||
+      !SectionFits<Rule>(header.cosmetic_rules, size) ||
+      !SectionFits<uint32_t>(header.cosmetic_rule_indices, size) ||
+      !SectionFits<Bucket>(header.cosmetic_host_buckets, size) ||
+      !SectionFits<Bucket>(header.cosmetic_key_buckets, size) ||
+      !SectionFits<uint32_t>(header.unkeyed_cosmetic_rules, size) ||
+      !SectionFits<uint32_t>(header.key_filter, size) ||
+      header.key_filter.count % kKeyFilterBlockWords) {
+    return false;
+  }
+
+  for (const Section* rule_section : {&header.rules, &header.cosmetic_rules}) {
+    const Rule* rules = At<Rule>(*rule_section);
+    for (uint32_t i = 0; i < rule_section->count; ++i) {
+      const Rule& rule = rules[i];
+      if (rule.pattern_offset > header.strings.count ||
+          rule.pattern_length > header.strings.count - rule.pattern_offset ||
+          rule.domains_offset > header.domain_hashes.count ||
+          uint32_t{rule.included_domain_count} + rule.excluded_domain_count >
+              header.domain_hashes.count - rule.domains_offset) {
+        return false;
+      }
+    }
+  }
+
+  auto indices_fit = [this](const Section& indices, uint32_t limit) {
+    const uint32_t* values = At<uint32_t>(indices);
+    for (uint32_t i = 0; i < indices.count; ++i) {
+      if (values[i] >= limit) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto buckets_fit = [this](const Section& table, uint32_t index_count) {
+    if (!IsPowerOfTwoOrZero(table.count)) {
+      return false;
+    }
+    const Bucket* buckets = At<Bucket>(table);
+    bool has_empty_slot = table.count == 0;
+    for (uint32_t i = 0; i < table.count; ++i) {
+      if (!buckets[i].hash) {
+        has_empty_slot = true;
+      } else if (buckets[i].first_rule > index_count ||
+                 buckets[i].rule_count > index_count - buckets[i].first_rule) {
+        return false;
+      }
+    }
+    // Probing stops at an empty slot, so a full table could loop forever.
+    return has_empty_slot;
+  };
+  return indices_fit(header.rule_indices, header.rules.count) &&
+         indices_fit(header.untokenized_rules, header.rules.count) &&
+         indices_fit(header.cosmetic_rule_indices,
+                     header.cosmetic_rules.count) &&
+         indices_fit(header.unkeyed_cosmetic_rules,
+                     header.cosmetic_rules.count) &&
+         buckets_fit(header.token_buckets, header.rule_indices.count) &&
+         buckets_fit(header.host_buckets, header.rule_indices.count) &&
+         buckets_fit(header.cosmetic_host_buckets,
+                     header.cosmetic_rule_indices.count) &&
+         buckets_fit(header.cosmetic_key_buckets,
+                     header.cosmetic_rule_indices.count);
+}
+
+bool RulesetMatcher::MayHaveRules(uint32_t hash) const {
+  const Section& filter = header_->key_filter;
+  if (!filter.count) {
+    return false;
+  }
+  const uint32_t* block =
+      At<uint32_t>(filter) +
+      GetKeyFilterBlock(hash, filter.count / kKeyFilterBlockWords) *
+          kKeyFilterBlockWords;
+  for (uint32_t probe = 0; probe < kKeyFilterProbes; ++probe) {
+    uint32_t bit = GetKeyFilterBit(hash, probe);
+    if (!(block[bit / 32] & (1u << (bit % 32)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const Bucket* RulesetMatcher::FindBucket(const Section& buckets,
+                                         uint32_t hash) const {
+  if (!buckets.count) {
+    return nullptr;
+  }
+  const Bucket* table = At<Bucket>(buckets);
+  const uint32_t mask = buckets.count - 1;
+  for (uint32_t slot = hash & mask; table[slot].hash;
+       slot = (slot + 1) & mask) {
+    if (table[slot].hash == hash) {
+      return &table[slot];
+    }
+  }
+  return nullptr;
+}
+
+RulesetMatcher::Match RulesetMatcher::MatchBucket(
+    const Section& buckets,
+    uint32_t hash,
+    const Request& request) const {
+  const Bucket* bucket = FindBucket(buckets, hash);
+  if (!bucket) {
+    return Match::kNone;
+  }
+  const uint32_t* rule_indices =
+      At<uint32_t>(header_->rule_indices) + bucket->first_rule;
+  Match result = Match::kNone;
+  for (uint32_t i = 0; i < bucket->rule_count; ++i) {
+    Match match = MatchRule(rule_indices[i], request);
+    if (match == Match::kAllow) {
+      return match;
+    }
+    if (match == Match::kBlock) {
+      result = match;
+    }
+  }
+  return result;
+}
+
+RulesetMatcher::Match RulesetMatcher::MatchRule(uint32_t rule_index,
+                                                const Request& request) const {
+  const Rule& rule = At<Rule>(header_->rules)[rule_index];
+  if (!(rule.element_types & request.element_type) ||
+      ((rule.flags & kRuleThirdPartyOnly) && !request.is_third_party) ||
+      ((rule.flags & kRuleFirstPartyOnly) && request.is_third_party) ||
+      !MatchesDomains(rule, request.document_host) ||
+      !MatchesPattern(rule, request)) {
+    return Match::kNone;
+  }
+  return (rule.flags & kRuleException) ? Match::kAllow : Match::kBlock;
+}
+
+bool RulesetMatcher::MatchesDomains(const Rule& rule,
+                                    base::StringPiece document_host) const {
+  if (!rule.included_domain_count && !rule.excluded_domain_count) {
+    return true;
+  }
+  const uint32_t* included =
+      At<uint32_t>(header_->domain_hashes) + rule.domains_offset;
+  const uint32_t* excluded = included + rule.included_domain_count;
+  bool is_included = !rule.included_domain_count;
+  // Options name registrable domains or subdomains, so every suffix of the
+  // document host is a candidate.
+  while (!document_host.empty()) {
+    uint32_t hash = HashLowerCase(document_host);
+    for (uint16_t i = 0; i < rule.excluded_domain_count; ++i) {
+      if (excluded[i] == hash) {
+        return false;
+      }
+    }
+    for (uint16_t i = 0; i < rule.included_domain_count && !is_included;
+         ++i) {
+      is_included = included[i] == hash;
+    }
+    size_t dot = document_host.find('.');
+    document_host = dot == base::StringPiece::npos
+                        ? base::StringPiece()
+                        : document_host.substr(dot + 1);
+  }
+  return is_included;
+}
+
+bool RulesetMatcher::MatchesPattern(const Rule& rule,
+                                    const Request& request) const {
+  base::StringPiece pattern = GetPattern(rule);
+  const bool match_case = (rule.flags & kRuleMatchCase) != 0;
+  const bool anchor_end = (rule.flags & kRuleAnchorEnd) != 0;
+  base::StringPiece url = request.url;
+
+  if (rule.flags & kRuleAnchorStart) {
+    return MatchesAt(pattern, url, 0, match_case, anchor_end);
+  }
+  if (rule.flags & kRuleAnchorHost) {
+    for (size_t i = request.host_begin; i < request.host_end; ++i) {
+      if ((i == request.host_begin || url[i - 1] == '.') &&
+          MatchesAt(pattern, url, i, match_case, anchor_end)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  // Unanchored: only try positions where a literal first character fits.
+  const bool literal_start =
+      !pattern.empty() && pattern[0] != '^' && pattern[0] != '*';
+  for (size_t i = 0; i <= url.size(); ++i) {
+    if (literal_start &&
+        (i == url.size() ||
+         (match_case ? url[i] : ToLower(url[i])) != pattern[0])) {
+      continue;
+    }
+    if (MatchesAt(pattern, url, i, match_case, anchor_end)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<base::StringPiece> RulesetMatcher::GetHostSelectors(
+    base::StringPiece document_host) const {
+  std::vector<uint32_t> rule_indices;
+  std::vector<base::StringPiece> exceptions;
+  GetCosmeticHostRules(document_host, &rule_indices, &exceptions);
+  const Rule* rules = At<Rule>(header_->cosmetic_rules);
+  const uint32_t* unkeyed = At<uint32_t>(header_->unkeyed_cosmetic_rules);
+  for (uint32_t i = 0; i < header_->unkeyed_cosmetic_rules.count; ++i) {
+    if (MatchesDomains(rules[unkeyed[i]], document_host)) {
+      rule_indices.push_back(unkeyed[i]);
+    }
+  }
+  return GetSelectors(std::move(rule_indices), exceptions);
+}
+
+std::vector<base::StringPiece> RulesetMatcher::GetKeyedSelectors(
+    base::StringPiece document_host,
+    const std::vector<std::string>& keys) const {
+  if (!has_keyed_cosmetic_rules()) {
+    return {};
+  }
+  std::vector<uint32_t> rule_indices;
+  const Rule* rules = At<Rule>(header_->cosmetic_rules);
+  for (const std::string& key : keys) {
+    const Bucket* bucket =
+        FindBucket(header_->cosmetic_key_buckets, HashLowerCase(key));
+    if (!bucket) {
+      continue;
+    }
+    const uint32_t* indices =
+        At<uint32_t>(header_->cosmetic_rule_indices) + bucket->first_rule;
+    for (uint32_t i = 0; i < bucket->rule_count; ++i) {
+      if (MatchesDomains(rules[indices[i]], document_host)) {
+        rule_indices.push_back(indices[i]);
+      }
+    }
+  }
+  if (rule_indices.empty()) {
+    return {};
+  }
+  // Host rules only matter for their exceptions here.
+  std::vector<uint32_t> host_rule_indices;
+  std::vector<base::StringPiece> exceptions;
+  GetCosmeticHostRules(document_host, &host_rule_indices, &exceptions);
+  return GetSelectors(std::move(rule_indices), exceptions);
+}
+
+void RulesetMatcher::GetCosmeticHostRules(
+    base::StringPiece document_host,
+    std::vector<uint32_t>* rule_indices,
+    std::vector<base::StringPiece>* exceptions) const {
+  const Rule* rules = At<Rule>(header_->cosmetic_rules);
+  base::StringPiece host = document_host;
+  while (!host.empty()) {
+    const Bucket* bucket =
+        FindBucket(header_->cosmetic_host_buckets, HashLowerCase(host));
+    if (bucket) {
+      const uint32_t* indices =
+          At<uint32_t>(header_->cosmetic_rule_indices) + bucket->first_rule;
+      for (uint32_t i = 0; i < bucket->rule_count; ++i) {
+        const Rule& rule = rules[indices[i]];
+        if (!MatchesDomains(rule, document_host)) {
+          continue;
+        }
+        if (rule.flags & kRuleException) {
+          exceptions->push_back(GetPattern(rule));
+        } else {
+          rule_indices->push_back(indices[i]);
+        }
+      }
+    }
+    size_t dot = host.find('.');
+    host = dot == base::StringPiece::npos ? base::StringPiece()
+                                          : host.substr(dot + 1);
+  }
+}
+
+std::vector<base::StringPiece> RulesetMatcher::GetSelectors(
+    std::vector<uint32_t> rule_indices,
+    const std::vector<base::StringPiece>& exceptions) const {
+  // A rule naming several parent domains of the host is found once for
+  // each of them.
+  std::sort(rule_indices.begin(), rule_indices.end());
+  rule_indices.erase(std::unique(rule_indices.begin(), rule_indices.end()),
+                     rule_indices.end());
+
+  std::vector<base::StringPiece> selectors;
+  selectors.reserve(rule_indices.size());
+  const Rule* rules = At<Rule>(header_->cosmetic_rules);
+  for (uint32_t index : rule_indices) {
+    base::StringPiece selector = GetPattern(rules[index]);
+    if (std::find(exceptions.begin(), exceptions.end(), selector) ==
+        exceptions.end()) {
+      selectors.push_back(selector);
+    }
+  }
+  return selectors;
+}
+
+base::StringPiece RulesetMatcher::GetPattern(const Rule& rule) const {
+  return base::StringPiece(At<char>(header_->strings) + rule.pattern_offset,
+                           rule.pattern_length);
+}
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef LUNETIX_COMMON_ADBLOCK_RULESET_MATCHER_H_
+#define LUNETIX_COMMON_ADBLOCK_RULESET_MATCHER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/span.h"
+#include "base/strings/string_piece.h"
+#include "lunetix/common/adblock/ruleset_format.h"
+
+class GURL;
+
+namespace lunetix {
+namespace adblock {
+
+// Matches requests against a compiled ruleset in place, typically a
+// read-only mapping of the ruleset file shared by every process. The data
+// is validated once up front so that matching can trust every offset, and
+// matching a request never allocates.
+class RulesetMatcher {
+ public:
+  // Returns null if |data| is not a well-formed ruleset. |data| must
+  // outlive the matcher.
+  static std::unique_ptr<RulesetMatcher> Create(
+      base::span<const uint8_t> data);
+
+  ~RulesetMatcher();
+
+  // Whether a request for |url| of |element_type|, made by a document on
+  // |document_host|, should be blocked. Exception rules win over blocking
+  // rules.
+  bool ShouldBlock(const GURL& url,
+                   base::StringPiece document_host,
+                   ElementType element_type,
+                   bool is_third_party) const;
+
+  // Selectors of the element hiding rules that apply to every document on
+  // |document_host|: the rules naming the host and the generic rules
+  // without a key.
+  std::vector<base::StringPiece> GetHostSelectors(
+      base::StringPiece document_host) const;
+
+  // Selectors of the generic rules keyed by one of |keys|, the classes and
+  // ids, with their "." or "#", found in a document on |document_host|.
+  std::vector<base::StringPiece> GetKeyedSelectors(
+      base::StringPiece document_host,
+      const std::vector<std::string>& keys) const;
+
+  bool has_keyed_cosmetic_rules() const {
+    return header_->cosmetic_key_buckets.count != 0;
+  }
+
+  size_t rule_count() const { return header_->rules.count; }
+  size_t cosmetic_rule_count() const { return header_->cosmetic_rules.count; }
+
+ private:
+  enum class Match { kNone, kBlock, kAllow };
+
+  struct Request;
+
+  explicit RulesetMatcher(base::span<const uint8_t> data);
+
+  bool IsValid() const;
+
+  // False if no rule is keyed by |hash|, in either the token or the host
+  // table. True may be a false positive.
+  bool MayHaveRules(uint32_t hash) const;
+
+  // Returns the entry for |hash| in |buckets|, or null.
+  const Bucket* FindBucket(const Section& buckets, uint32_t hash) const;
+
+  // Checks the rules of the bucket for |hash| in |buckets|.
+  Match MatchBucket(const Section& buckets,
+                    uint32_t hash,
+                    const Request& request) const;
+  Match MatchRule(uint32_t rule_index, const Request& request) const;
+  bool MatchesDomains(const Rule& rule, base::StringPiece document_host) const;
+  bool MatchesPattern(const Rule& rule, const Request& request) const;
+
+  // Collects the element hiding rules naming |document_host| or one of its
+  // parent domains, split into hiding rules and exception selectors.
+  void GetCosmeticHostRules(base::StringPiece document_host,
+                            std::vector<uint32_t>* rule_indices,
+                            std::vector<base::StringPiece>* exceptions) const;
+  // Returns the selectors of |rule_indices| that no exception turns off.
+  std::vector<base::StringPiece> GetSelectors(
+      std::vector<uint32_t> rule_indices,
+      const std::vector<base::StringPiece>& exceptions) const;
+  base::StringPiece GetPattern(const Rule& rule) const;
+
+  template <typename T>
+  const T* At(const Section& section) const {
+    return reinterpret_cast<const T*>(data_.data() + section.offset);
+  }
+
+  base::span<const uint8_t> data_;
+  const RulesetHeader* header_;
+
+  DISALLOW_COPY_AND_ASSIGN(RulesetMatcher);
+};
+
+}  // namespace adblock
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_ADBLOCK_RULESET_MATCHER_H_
\ No newline at end of file
@@ -0,0 +1,273 @@
+// Replays a request corpus against the content blocking engine and reports
+// how long building, loading and matching take. The sample list and corpus
+// in test/data are used unless recorded ones are given:
+//
+//   adblock_perftests --filter-list=<list> --request-corpus=<corpus>
+//
+// A corpus has one request per line, tab separated: the URL, its element
+// type as named by filter options, and the initiator origin, which is empty
+// for requests the browser makes itself.
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/containers/span.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/path_service.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/time/time.h"
+#include "lunetix/common/adblock/mapped_ruleset.h"
+#include "lunetix/common/adblock/ruleset_builder.h"
+#include "lunetix/common/adblock/ruleset_matcher.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "testing/perf/perf_result_reporter.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace lunetix {
+namespace adblock {
+
+namespace {
+
+const char kFilterListSwitch[] = "filter-list";
+const char kRequestCorpusSwitch[] = "request-corpus";
+
+const base::FilePath::CharType kTestDataDir[] =
+    FILE_PATH_LITERAL("lunetix/common/adblock/test/data");
+const base::FilePath::CharType kDefaultFilterList[] =
+    FILE_PATH_LITERAL("perf_filter_list.txt");
+const base::FilePath::CharType kDefaultRequestCorpus[] =
+    FILE_PATH_LITERAL("perf_request_corpus.tsv");
+
+// The corpus is matched this many times, so that the percentiles rest on
+// enough samples and the first pass's cold caches do not dominate them.
+constexpr int kMatchPasses = 20;
+constexpr int kLoadRepeats = 10;
+
+const char kMetricPrefix[] = "RulesetMatcher.";
+const char kMetricBuildTime[] = "build_time";
+const char kMetricRuleCount[] = "rule_count";
+// Matching reads the ruleset in place and never allocates, so the size of
+// the ruleset is all the memory the rules take.
+const char kMetricRulesetSize[] = "ruleset_size";
+const char kMetricLoadTime[] = "load_time";
+const char kMetricMatchP50[] = "match_p50";
+const char kMetricMatchP99[] = "match_p99";
+const char kMetricBlockedRequests[] = "blocked_requests";
+
+const struct {
+  const char* name;
+  ElementType type;
+} kElementTypeNames[] = {
+    {"script", kElementTypeScript},
+    {"image", kElementTypeImage},
+    {"stylesheet", kElementTypeStylesheet},
+    {"object", kElementTypeObject},
+    {"xmlhttprequest", kElementTypeXmlHttpRequest},
+    {"subdocument", kElementTypeSubdocument},
+    {"font", kElementTypeFont},
+    {"media", kElementTypeMedia},
+    {"websocket", kElementTypeWebSocket},
+    {"ping", kElementTypePing},
+};
+
+struct RecordedRequest {
+  GURL url;
+  ElementType element_type = kElementTypeOther;
+  absl::optional<url::Origin> initiator;
+};
+
+ElementType ParseElementType(base::StringPiece name) {
+  for (const auto& entry : kElementTypeNames) {
+    if (name == entry.name) {
+      return entry.type;
+    }
+  }
+  return kElementTypeOther;
+}
+
+base::FilePath GetInputPath(const char* switch_name,
+                            const base::FilePath::CharType* default_name) {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (command_line.HasSwitch(switch_name)) {
+    return command_line.GetSwitchValuePath(switch_name);
+  }
+  base::FilePath source_root;
+  base::PathService::Get(base::DIR_SOURCE_ROOT, &source_root);
+  return source_root.Append(kTestDataDir).Append(default_name);
+}
+
+base::span<const uint8_t> AsBytes(const std::string& ruleset) {
+  return base::make_span(reinterpret_cast<const uint8_t*>(ruleset.data()),
+                         ruleset.size());
+}
+
+// The decision LunetixURLLoaderThrottle makes for a subresource request.
+bool ShouldBlock(const RulesetMatcher& matcher,
+                 const RecordedRequest& request) {
+  if (!request.initiator || request.initiator->opaque()) {
+    return matcher.ShouldBlock(request.url, request.url.host_piece(),
+                               request.element_type,
+                               request.initiator.has_value());
+  }
+  bool is_third_party =
+      !net::registry_controlled_domains::SameDomainOrHost(
+          request.url, *request.initiator,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return matcher.ShouldBlock(request.url, request.initiator->host(),
+                             request.element_type, is_third_party);
+}
+
+// |samples| must be sorted.
+base::TimeDelta Percentile(const std::vector<base::TimeDelta>& samples,
+                           double fraction) {
+  size_t index = static_cast<size_t>(fraction * samples.size());
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+}  // namespace
+
+class RulesetMatcherPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    base::FilePath list_path =
+        GetInputPath(kFilterListSwitch, kDefaultFilterList);
+    ASSERT_TRUE(base::ReadFileToString(list_path, &filter_list_))
+        << list_path;
+
+    base::FilePath corpus_path =
+        GetInputPath(kRequestCorpusSwitch, kDefaultRequestCorpus);
+    std::string corpus;
+    ASSERT_TRUE(base::ReadFileToString(corpus_path, &corpus)) << corpus_path;
+    for (base::StringPiece line : base::SplitStringPiece(
+             corpus, "\n", base::KEEP_WHITESPACE,
+             base::SPLIT_WANT_NONEMPTY)) {
+      if (base::StartsWith(line, "#")) {
+        continue;
+      }
+      std::vector<base::StringPiece> fields = base::SplitStringPiece(
+          line, "\t", base::TRIM_WHITESPACE, base::SPLIT_WANT_ALL);
+      RecordedRequest request;
+      request.url = GURL(fields[0]);
+      if (!request.url.is_valid()) {
+        continue;
+      }
+      if (fields.size() > 1) {
+        request.element_type = ParseElementType(fields[1]);
+      }
+      if (fields.size() > 2 && !fields[2].empty()) {
+        request.initiator = url::Origin::Create(GURL(fields[2]));
+      }
+      requests_.push_back(std::move(request));
+    }
+    ASSERT_FALSE(requests_.empty()) << corpus_path;
+
+    // Results are reported per corpus, so runs on different traffic do not
+    // mix.
+    story_ = corpus_path.BaseName().RemoveExtension().AsUTF8Unsafe();
+  }
+
+  std::string BuildRuleset() const {
+    RulesetBuilder builder;
+    builder.AddFilterList(filter_list_);
+    return builder.Build();
+  }
+
+  perf_test::PerfResultReporter CreateReporter() const {
+    perf_test::PerfResultReporter reporter(kMetricPrefix, story_);
+    reporter.RegisterImportantMetric(kMetricBuildTime, "ms");
+    reporter.RegisterImportantMetric(kMetricRuleCount, "count");
+    reporter.RegisterImportantMetric(kMetricRulesetSize, "bytes");
+    reporter.RegisterImportantMetric(kMetricLoadTime, "ms");
+    reporter.RegisterImportantMetric(kMetricMatchP50, "us");
+    reporter.RegisterImportantMetric(kMetricMatchP99, "us");
+    reporter.RegisterImportantMetric(kMetricBlockedRequests, "count");
+    return reporter;
+  }
+
+  std::string filter_list_;
+  std::vector<RecordedRequest> requests_;
+  std::string story_;
+};
+
+TEST_F(RulesetMatcherPerfTest, Build) {
+  base::TimeTicks start = base::TimeTicks::Now();
+  RulesetBuilder builder;
+  builder.AddFilterList(filter_list_);
+  std::string ruleset = builder.Build();
+  base::TimeDelta build_time = base::TimeTicks::Now() - start;
+
+  perf_test::PerfResultReporter reporter = CreateReporter();
+  reporter.AddResult(kMetricBuildTime, build_time);
+  reporter.AddResult(kMetricRuleCount, builder.rule_count());
+  reporter.AddResult(kMetricRulesetSize, ruleset.size());
+}
+
+TEST_F(RulesetMatcherPerfTest, Load) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath ruleset_path = temp_dir.GetPath().AppendASCII("Ruleset");
+  ASSERT_TRUE(base::WriteFile(ruleset_path, BuildRuleset()));
+
+  // What the browser and every renderer do when a ruleset is published:
+  // map the file and validate it. The file was just written, so this is
+  // the warm load.
+  base::TimeDelta load_time;
+  for (int i = 0; i < kLoadRepeats; ++i) {
+    base::File file(ruleset_path,
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    base::TimeTicks start = base::TimeTicks::Now();
+    scoped_refptr<MappedRuleset> ruleset =
+        MappedRuleset::Open(std::move(file));
+    load_time += base::TimeTicks::Now() - start;
+    ASSERT_TRUE(ruleset);
+  }
+
+  CreateReporter().AddResult(kMetricLoadTime, load_time / kLoadRepeats);
+}
+
+TEST_F(RulesetMatcherPerfTest, Match) {
+  std::string ruleset = BuildRuleset();
+  std::unique_ptr<RulesetMatcher> matcher =
+      RulesetMatcher::Create(AsBytes(ruleset));
+  ASSERT_TRUE(matcher);
+
+  // Every request is timed on its own, which adds the cost of reading the
+  // clock to each sample but keeps the slow tail visible.
+  std::vector<base::TimeDelta> samples;
+  samples.reserve(requests_.size() * kMatchPasses);
+  size_t blocked_requests = 0;
+  for (int pass = 0; pass < kMatchPasses; ++pass) {
+    for (const RecordedRequest& request : requests_) {
+      base::TimeTicks start = base::TimeTicks::Now();
+      bool blocked = ShouldBlock(*matcher, request);
+      samples.push_back(base::TimeTicks::Now() - start);
+      if (pass == 0 && blocked) {
+        ++blocked_requests;
+      }
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+
+  perf_test::PerfResultReporter reporter = CreateReporter();
+  reporter.AddResult(kMetricMatchP50, Percentile(samples, 0.5));
+  reporter.AddResult(kMetricMatchP99, Percentile(samples, 0.99));
+  reporter.AddResult(kMetricBlockedRequests, blocked_requests);
+}
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "lunetix/common/adblock/ruleset_matcher.h"
+
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "lunetix/common/adblock/filter_parser.h"
+#include "lunetix/common/adblock/ruleset_builder.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+namespace adblock {
+
+namespace {
+
+const char kFilterList[] = R"(! Title: Test list
+[Adblock Plus 2.0]
+||ads.example^
+||tracker.example^$third-party
+/banner/*/ad_
+&adserver=
+|https://start.example/exact|
+||cdn.example/scripts/ads.js$script
+||images.example^$image,domain=news.example|~sports.news.example
+@@||ads.example/allowed^
+example.org##.ad-banner
+/regex[0-9]+/
+||popups.example^$popup
+##.generic-ad
+##div[data-ad]
+example.org#@#.generic-ad
+##.unwanted
+#@#.unwanted
+example.org,~shop.example.org##.promo
+example.org#?#div:-abp-has(.ad)
+example.org##+js(noeval)
+)";
+
+}  // namespace
+
+class RulesetMatcherTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    RulesetBuilder builder;
+    rule_count_ = builder.AddFilterList(kFilterList);
+    ruleset_ = builder.Build();
+    matcher_ = RulesetMatcher::Create(base::make_span(
+        reinterpret_cast<const uint8_t*>(ruleset_.data()), ruleset_.size()));
+    ASSERT_TRUE(matcher_);
+  }
+
+  bool ShouldBlock(const char* url,
+                   const char* document_host = "site.example",
+                   ElementType element_type = kElementTypeOther,
+                   bool is_third_party = true) {
+    return matcher_->ShouldBlock(GURL(url), document_host, element_type,
+                                 is_third_party);
+  }
+
+  size_t rule_count_ = 0;
+  std::string ruleset_;
+  std::unique_ptr<RulesetMatcher> matcher_;
+};
+
+TEST_F(RulesetMatcherTest, SkipsUnsupportedRules) {
+  // Comments, the header, the regular expression, the rule with an unknown
+  // option, the procedural selector and the scriptlet are left out.
+  EXPECT_EQ(rule_count_, 15u);
+  EXPECT_EQ(matcher_->rule_count(), 8u);
+  // The global exception and the rule it turns off are applied at build
+  // time.
+  EXPECT_EQ(matcher_->cosmetic_rule_count(), 5u);
+}
+
+TEST_F(RulesetMatcherTest, HostAnchor) {
+  EXPECT_TRUE(ShouldBlock("https://ads.example/"));
+  EXPECT_TRUE(ShouldBlock("https://a.b.ads.example/x.js"));
+  EXPECT_TRUE(ShouldBlock("http://ads.example:8080/x"));
+  EXPECT_FALSE(ShouldBlock("https://notads.example/"));
+  EXPECT_FALSE(ShouldBlock("https://ads.example.org/"));
+  EXPECT_FALSE(ShouldBlock("https://site.example/ads.example"));
+}
+
+TEST_F(RulesetMatcherTest, Wildcards) {
+  EXPECT_TRUE(ShouldBlock("https://site.example/banner/top/ad_1.png"));
+  EXPECT_TRUE(ShouldBlock("https://site.example/BANNER/x/y/ad_2.png"));
+  EXPECT_FALSE(ShouldBlock("https://site.example/banner/ad_1.png"));
+  EXPECT_TRUE(ShouldBlock("https://site.example/page?id=1&adserver=2"));
+}
+
+TEST_F(RulesetMatcherTest, StartAndEndAnchors) {
+  EXPECT_TRUE(ShouldBlock("https://start.example/exact"));
+  EXPECT_FALSE(ShouldBlock("https://start.example/exact/more"));
+  EXPECT_FALSE(ShouldBlock("http://start.example/exact"));
+}
+
+TEST_F(RulesetMatcherTest, ThirdParty) {
+  EXPECT_TRUE(ShouldBlock("https://tracker.example/p", "site.example",
+                          kElementTypeImage, true));
+  EXPECT_FALSE(ShouldBlock("https://tracker.example/p", "tracker.example",
+                           kElementTypeImage, false));
+}
+
+TEST_F(RulesetMatcherTest, ElementTypes) {
+  EXPECT_TRUE(ShouldBlock("https://cdn.example/scripts/ads.js", "site.example",
+                          kElementTypeScript));
+  EXPECT_FALSE(ShouldBlock("https://cdn.example/scripts/ads.js",
+                           "site.example", kElementTypeImage));
+}
+
+TEST_F(RulesetMatcherTest, DomainOption) {
+  EXPECT_TRUE(ShouldBlock("https://images.example/a.png", "news.example",
+                          kElementTypeImage));
+  EXPECT_TRUE(ShouldBlock("https://images.example/a.png", "www.news.example",
+                          kElementTypeImage));
+  EXPECT_FALSE(ShouldBlock("https://images.example/a.png",
+                           "sports.news.example", kElementTypeImage));
+  EXPECT_FALSE(ShouldBlock("https://images.example/a.png", "other.example",
+                           kElementTypeImage));
+}
+
+TEST_F(RulesetMatcherTest, ExceptionsWin) {
+  EXPECT_FALSE(ShouldBlock("https://ads.example/allowed/x.js"));
+  EXPECT_TRUE(ShouldBlock("https://ads.example/allowedx"));
+}
+
+TEST_F(RulesetMatcherTest, IgnoresOtherSchemes) {
+  EXPECT_FALSE(ShouldBlock("data:text/html,ads.example"));
+  EXPECT_FALSE(ShouldBlock("chrome://ads.example/"));
+}
+
+TEST_F(RulesetMatcherTest, HostSelectors) {
+  EXPECT_EQ(matcher_->GetHostSelectors("www.example.org"),
+            std::vector<base::StringPiece>(
+                {".ad-banner", "div[data-ad]", ".promo"}));
+  EXPECT_EQ(matcher_->GetHostSelectors("shop.example.org"),
+            std::vector<base::StringPiece>({".ad-banner", "div[data-ad]"}));
+  EXPECT_EQ(matcher_->GetHostSelectors("site.example"),
+            std::vector<base::StringPiece>({"div[data-ad]"}));
+}
+
+TEST_F(RulesetMatcherTest, KeyedSelectors) {
+  ASSERT_TRUE(matcher_->has_keyed_cosmetic_rules());
+  EXPECT_EQ(matcher_->GetKeyedSelectors("site.example",
+                                        {".generic-ad", "#missing"}),
+            std::vector<base::StringPiece>({".generic-ad"}));
+  EXPECT_TRUE(
+      matcher_->GetKeyedSelectors("site.example", {"#generic-ad"}).empty());
+  EXPECT_TRUE(
+      matcher_->GetKeyedSelectors("example.org", {".generic-ad"}).empty());
+  EXPECT_TRUE(
+      matcher_->GetKeyedSelectors("site.example", {".unwanted"}).empty());
+}
+
+TEST_F(RulesetMatcherTest, RejectsDamagedRulesets) {
+  std::string truncated = ruleset_.substr(0, ruleset_.size() - 4);
+  EXPECT_FALSE(RulesetMatcher::Create(base::make_span(
+      reinterpret_cast<const uint8_t*>(truncated.data()), truncated.size())));
+
+  std::string corrupt = ruleset_;
+  corrupt[sizeof(RulesetHeader)] = '\xff';
+  corrupt[sizeof(RulesetHeader) + 1] = '\xff';
+  corrupt[sizeof(RulesetHeader) + 2] = '\xff';
+  EXPECT_FALSE(RulesetMatcher::Create(base::make_span(
+      reinterpret_cast<const uint8_t*>(corrupt.data()), corrupt.size())));
+
+  EXPECT_FALSE(RulesetMatcher::Create(base::span<const uint8_t>()));
+}
+
+// The key filter may let absent keys through but must never drop one that
+// rules are keyed by.
+TEST(RulesetMatcherKeyFilterTest, KeepsEveryKey) {
+  constexpr int kRuleCount = 2000;
+  std::string filter_list;
+  for (int i = 0; i < kRuleCount; ++i) {
+    std::string n = base::NumberToString(i);
+    filter_list += "||host" + n + ".example^\n/path" + n + "/ad_\n";
+  }
+  RulesetBuilder builder;
+  builder.AddFilterList(filter_list);
+  std::string ruleset = builder.Build();
+  std::unique_ptr<RulesetMatcher> matcher =
+      RulesetMatcher::Create(base::make_span(
+          reinterpret_cast<const uint8_t*>(ruleset.data()), ruleset.size()));
+  ASSERT_TRUE(matcher);
+
+  for (int i = 0; i < kRuleCount; ++i) {
+    std::string n = base::NumberToString(i);
+    EXPECT_TRUE(matcher->ShouldBlock(GURL("https://a.host" + n + ".example/"),
+                                     "site.example", kElementTypeImage, true));
+    EXPECT_TRUE(matcher->ShouldBlock(
+        GURL("https://site.example/path" + n + "/ad_1.png"), "site.example",
+        kElementTypeImage, false));
+    EXPECT_FALSE(matcher->ShouldBlock(
+        GURL("https://site" + n + ".example/page" + n + "/a.png"),
+        "site.example", kElementTypeImage, true));
+  }
+}
+
+// Host anchors without a trailing separator match a prefix of the host.
+TEST(RulesetMatcherHostPrefixTest, MatchesPartialLabels) {
+  RulesetBuilder builder;
+  builder.AddFilterList("||ads.example\n||cdn-\n");
+  std::string ruleset = builder.Build();
+  std::unique_ptr<RulesetMatcher> matcher =
+      RulesetMatcher::Create(base::make_span(
+          reinterpret_cast<const uint8_t*>(ruleset.data()), ruleset.size()));
+  ASSERT_TRUE(matcher);
+
+  auto should_block = [&matcher](const char* url) {
+    return matcher->ShouldBlock(GURL(url), "site.example", kElementTypeImage,
+                                true);
+  };
+  EXPECT_TRUE(should_block("https://ads.example/x.png"));
+  EXPECT_TRUE(should_block("https://ads.example.com/x.png"));
+  EXPECT_TRUE(should_block("https://ads.example-cdn.net/x.png"));
+  EXPECT_TRUE(should_block("https://cdn-foo.example/x.png"));
+  EXPECT_TRUE(should_block("https://img.cdn-foo.example/x.png"));
+  EXPECT_FALSE(should_block("https://notads.example.com/x.png"));
+  EXPECT_FALSE(should_block("https://mycdn-foo.example/x.png"));
+}
+
+TEST(FilterParserTest, ParsesOptionsAndAnchors) {
+  NetworkFilter filter;
+  ASSERT_TRUE(ParseNetworkFilter(
+      "@@||Example.com/Path*$~script,match-case,domain=a.com|~b.a.com",
+      &filter));
+  EXPECT_EQ(filter.pattern, "Example.com/Path");
+  EXPECT_EQ(filter.flags, kRuleException | kRuleAnchorHost | kRuleMatchCase);
+  EXPECT_EQ(filter.element_types, kElementTypeAll & ~kElementTypeScript);
+  EXPECT_EQ(filter.included_domains, std::vector<std::string>({"a.com"}));
+  EXPECT_EQ(filter.excluded_domains, std::vector<std::string>({"b.a.com"}));
+}
+
+TEST(FilterParserTest, RejectsRulesMatchingEverything) {
+  NetworkFilter filter;
+  EXPECT_FALSE(ParseNetworkFilter("*", &filter));
+  EXPECT_FALSE(ParseNetworkFilter("$third-party,~third-party", &filter));
+  EXPECT_FALSE(ParseNetworkFilter("ads$~script,~image,~stylesheet,~object,"
+                                  "~xmlhttprequest,~subdocument,~font,"
+                                  "~media,~websocket,~ping,~other",
+                                  &filter));
+}
+
+TEST(FilterParserTest, ParsesCosmeticFilters) {
+  CosmeticFilter filter;
+  ASSERT_TRUE(ParseCosmeticFilter("A.com,~b.a.com##div#ad > .x", &filter));
+  EXPECT_EQ(filter.selector, "div#ad > .x");
+  EXPECT_FALSE(filter.is_exception);
+  EXPECT_EQ(filter.included_domains, std::vector<std::string>({"a.com"}));
+  EXPECT_EQ(filter.excluded_domains, std::vector<std::string>({"b.a.com"}));
+
+  ASSERT_TRUE(ParseCosmeticFilter("#@#.sponsored", &filter));
+  EXPECT_TRUE(filter.is_exception);
+  EXPECT_TRUE(filter.included_domains.empty());
+
+  EXPECT_FALSE(ParseCosmeticFilter("||ads.example^", &filter));
+  EXPECT_FALSE(ParseCosmeticFilter("a.com#$#abort-on-property-read x",
+                                   &filter));
+  EXPECT_FALSE(ParseCosmeticFilter("##^script:has-text(ad)", &filter));
+  EXPECT_FALSE(ParseCosmeticFilter("##div:has-text(Sponsored)", &filter));
+  EXPECT_FALSE(ParseCosmeticFilter("##a{} body{display:none", &filter));
+}
+
+TEST(FilterParserTest, SelectorKeys) {
+  EXPECT_EQ(GetSelectorKey(".ad-box > img"), ".ad-box");
+  EXPECT_EQ(GetSelectorKey("#top_ad.wide"), "#top_ad");
+  EXPECT_EQ(GetSelectorKey("div.ad"), "");
+  EXPECT_EQ(GetSelectorKey(".ad, .banner"), "");
+  EXPECT_EQ(GetSelectorKey(".ad\\:x"), "");
+}
+
+}  // namespace adblock
+}  // namespace lunetix
\ No newline at end of file
@@ -1,8 +1,18 @@
 #ifndef LUNETIX_COMMON_LUNETIX_CONSTANTS_H_
 #define LUNETIX_COMMON_LUNETIX_CONSTANTS_H_
 
+#include "chrome/common/chrome_isolated_world_ids.h"
+
 namespace lunetix {
 
+// Isolated worlds Lunetix runs its own scripts in. They start past the
+// last id Chrome reserves, so they cannot share a world with Chrome's
+// internal scripts or with an extension.
+enum LunetixIsolatedWorldIds {
+  ISOLATED_WORLD_ID_LUNETIX_COSMETIC_FILTERS =
+      ISOLATED_WORLD_ID_EXTENSIONS_END + 1,
+};
+
 extern const char kLunetixApplicationName[];
 extern const char kLunetixProductName[];
 extern const char kLunetixUserAgent[];
@@ -0,0 +1,162 @@
+#include "lunetix/common/net/lunetix_url_loader_throttle.h"
+
+#include <utility>
+
+#include "lunetix/common/adblock/mapped_ruleset.h"
+#include "lunetix/common/trackers/tracker_classifier.h"
+#include "net/base/net_errors.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/url_request/redirect_info.h"
+#include "services/network/public/cpp/resource_request.h"
+#include "services/network/public/mojom/fetch_api.mojom-shared.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+using network::mojom::RequestDestination;
+
+// Chrome's own update checks and crash uploads, which have no use in
+// Lunetix.
+const struct {
+  const char* host;
+  const char* path_part;
+} kBlockedServices[] = {
+    {"update.googleapis.com", "chrome"},
+    {"clients2.google.com", "cr/report"},
+};
+
+adblock::ElementType GetElementType(const network::ResourceRequest& request) {
+  switch (request.destination) {
+    case RequestDestination::kScript:
+    case RequestDestination::kWorker:
+    case RequestDestination::kSharedWorker:
+    case RequestDestination::kServiceWorker:
+    case RequestDestination::kAudioWorklet:
+    case RequestDestination::kPaintWorklet:
+      return adblock::kElementTypeScript;
+    case RequestDestination::kImage:
+      return adblock::kElementTypeImage;
+    case RequestDestination::kStyle:
+    case RequestDestination::kXslt:
+      return adblock::kElementTypeStylesheet;
+    case RequestDestination::kObject:
+    case RequestDestination::kEmbed:
+      return adblock::kElementTypeObject;
+    case RequestDestination::kIframe:
+    case RequestDestination::kFrame:
+      return adblock::kElementTypeSubdocument;
+    case RequestDestination::kFont:
+      return adblock::kElementTypeFont;
+    case RequestDestination::kAudio:
+    case RequestDestination::kVideo:
+    case RequestDestination::kTrack:
+      return adblock::kElementTypeMedia;
+    case RequestDestination::kEmpty:
+      // fetch() and XMLHttpRequest, or a beacon or ping, which are the
+      // requests that outlive their document.
+      return request.keepalive ? adblock::kElementTypePing
+                               : adblock::kElementTypeXmlHttpRequest;
+    default:
+      return adblock::kElementTypeOther;
+  }
+}
+
+bool IsBlockedService(const GURL& url) {
+  for (const auto& service : kBlockedServices) {
+    if (url.host_piece() == service.host &&
+        url.path_piece().find(service.path_part) != base::StringPiece::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+LunetixURLLoaderThrottle::LunetixURLLoaderThrottle(
+    scoped_refptr<const adblock::MappedRuleset> ruleset,
+    bool block_trackers)
+    : ruleset_(std::move(ruleset)), block_trackers_(block_trackers) {}
+
+LunetixURLLoaderThrottle::~LunetixURLLoaderThrottle() = default;
+
+void LunetixURLLoaderThrottle::DetachFromCurrentSequence() {
+  // Holds no sequence-bound state, so worker threads can take it over.
+}
+
+void LunetixURLLoaderThrottle::WillStartRequest(
+    network::ResourceRequest* request,
+    bool* defer) {
+  initiator_ = request->request_initiator;
+  element_type_ = GetElementType(*request);
+  is_main_frame_ = request->destination == RequestDestination::kDocument;
+  if (ShouldBlock(request->url)) {
+    delegate_->CancelWithError(net::ERR_BLOCKED_BY_CLIENT);
+    return;
+  }
+  // Without credentials the network service neither sends the tracker's
+  // cookies nor stores those it sets.
+  if (ShouldStripCookies(*request)) {
+    request->credentials_mode = network::mojom::CredentialsMode::kOmit;
+  }
+}
+
+void LunetixURLLoaderThrottle::WillRedirectRequest(
+    net::RedirectInfo* redirect_info,
+    const network::mojom::URLResponseHead& response_head,
+    bool* defer,
+    std::vector<std::string>* to_be_removed_request_headers,
+    net::HttpRequestHeaders* modified_request_headers,
+    net::HttpRequestHeaders* modified_cors_exempt_request_headers) {
+  if (ShouldBlock(redirect_info->new_url)) {
+    delegate_->CancelWithError(net::ERR_BLOCKED_BY_CLIENT);
+  }
+}
+
+bool LunetixURLLoaderThrottle::ShouldBlock(const GURL& url) const {
+  if (IsBlockedService(url)) {
+    return true;
+  }
+  if (is_main_frame_) {
+    return false;
+  }
+  if (block_trackers_ && initiator_ &&
+      trackers::GetTrackerAction(url, *initiator_) ==
+          trackers::TrackerAction::kBlock) {
+    return true;
+  }
+  if (!ruleset_) {
+    return false;
+  }
+
+  // Requests the browser starts on its own are first party to themselves;
+  // those from opaque origins count as third party.
+  const adblock::RulesetMatcher& matcher = ruleset_->matcher();
+  if (!initiator_ || initiator_->opaque()) {
+    return matcher.ShouldBlock(url, url.host_piece(), element_type_,
+                               initiator_.has_value());
+  }
+  bool is_third_party =
+      !net::registry_controlled_domains::SameDomainOrHost(
+          url, *initiator_,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return matcher.ShouldBlock(url, initiator_->host(), element_type_,
+                             is_third_party);
+}
+
+bool LunetixURLLoaderThrottle::ShouldStripCookies(
+    const network::ResourceRequest& request) const {
+  // Frame navigations keep their credentials mode; their cookies are left
+  // to the third-party cookie setting. Redirects keep the mode the request
+  // started with.
+  if (!block_trackers_ || !initiator_ || is_main_frame_ ||
+      request.mode == network::mojom::RequestMode::kNavigate) {
+    return false;
+  }
+  return trackers::GetTrackerAction(request.url, *initiator_) ==
+         trackers::TrackerAction::kStripCookies;
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef LUNETIX_COMMON_NET_LUNETIX_URL_LOADER_THROTTLE_H_
+#define LUNETIX_COMMON_NET_LUNETIX_URL_LOADER_THROTTLE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "lunetix/common/adblock/ruleset_format.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+#include "third_party/blink/public/common/loader/url_loader_throttle.h"
+#include "url/origin.h"
+
+class GURL;
+
+namespace lunetix {
+
+namespace adblock {
+class MappedRuleset;
+}
+
+// Request blocking on the Network Service path. The decision is made in the
+// process that starts the request, before it is sent to the network process,
+// so it costs no IPC: renderers create one for every subresource request, the
+// browser for navigations and for the requests it makes on behalf of frames
+// and workers.
+//
+// With tracker blocking on, requests to the trackers of another company than
+// the initiator's are blocked, or sent without cookies for social widgets.
+class LunetixURLLoaderThrottle : public blink::URLLoaderThrottle {
+ public:
+  // |ruleset| is null while content blocking is off.
+  LunetixURLLoaderThrottle(scoped_refptr<const adblock::MappedRuleset> ruleset,
+                           bool block_trackers);
+  ~LunetixURLLoaderThrottle() override;
+
+  // blink::URLLoaderThrottle overrides:
+  void DetachFromCurrentSequence() override;
+  void WillStartRequest(network::ResourceRequest* request,
+                        bool* defer) override;
+  void WillRedirectRequest(
+      net::RedirectInfo* redirect_info,
+      const network::mojom::URLResponseHead& response_head,
+      bool* defer,
+      std::vector<std::string>* to_be_removed_request_headers,
+      net::HttpRequestHeaders* modified_request_headers,
+      net::HttpRequestHeaders* modified_cors_exempt_request_headers) override;
+
+ private:
+  bool ShouldBlock(const GURL& url) const;
+  bool ShouldStripCookies(const network::ResourceRequest& request) const;
+
+  scoped_refptr<const adblock::MappedRuleset> ruleset_;
+  const bool block_trackers_;
+
+  // Taken from the request, so that redirects are matched as part of it.
+  absl::optional<url::Origin> initiator_;
+  adblock::ElementType element_type_ = adblock::kElementTypeOther;
+  // Top-level documents are only checked against the built-in list.
+  bool is_main_frame_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(LunetixURLLoaderThrottle);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_NET_LUNETIX_URL_LOADER_THROTTLE_H_
\ No newline at end of file
@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Compiles the tracker entity map into a perfect hash table.
+
+Domains are hashed once to pick a bucket and hashed again with the seed
+found for that bucket to pick their slot, so that every listed domain has a
+slot of its own. Looking up a host then costs two hashes and one string
+comparison per label, with no collisions to walk. The hash must match
+Hash() in tracker_classifier.cc.
+"""
+
+import argparse
+import sys
+
+CATEGORIES = {
+    'advertising': 'kAdvertising',
+    'analytics': 'kAnalytics',
+    'cryptomining': 'kCryptomining',
+    'fingerprinting': 'kFingerprinting',
+    'social': 'kSocial',
+    'content': 'kContent',
+}
+
+# Slots per domain and domains per bucket. A sparser table makes seeds
+# quicker to find and costs a few empty slots.
+LOAD_FACTOR = 0.8
+BUCKET_SIZE = 2
+MAX_SEED = 0xffff
+
+
+def fnv_hash(key, seed):
+    h = (0x811c9dc5 ^ seed) & 0xffffffff
+    for byte in key.encode('ascii'):
+        h ^= byte
+        h = (h * 0x01000193) & 0xffffffff
+    # Final mix, so that seeds differing in a few bits scatter the keys.
+    h ^= h >> 16
+    h = (h * 0x85ebca6b) & 0xffffffff
+    h ^= h >> 13
+    h = (h * 0xc2b2ae35) & 0xffffffff
+    h ^= h >> 16
+    return h
+
+
+def parse_entities(path):
+    """Returns the entity names and a list of (domain, entity, category)."""
+    entities = []
+    domains = []
+    seen = set()
+    with open(path, 'r') as f:
+        for line_number, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            if line.startswith('[') and line.endswith(']'):
+                entities.append(line[1:-1].strip())
+                continue
+
+            fields = line.split()
+            if (not entities or len(fields) != 2 or
+                    fields[0] not in CATEGORIES):
+                sys.exit(f'{path}:{line_number}: '
+                         'expected "<category> <domain>"')
+            domain = fields[1].lower()
+            if domain in seen:
+                sys.exit(f'{path}:{line_number}: duplicate domain {domain}')
+            seen.add(domain)
+            domains.append((domain, len(entities) - 1, fields[0]))
+    return entities, domains
+
+
+def build_table(keys):
+    """Returns the seed of each bucket and the key index of each slot."""
+    table_size = int(len(keys) / LOAD_FACTOR) + 1
+    num_buckets = (len(keys) + BUCKET_SIZE - 1) // BUCKET_SIZE or 1
+    buckets = [[] for _ in range(num_buckets)]
+    for index, key in enumerate(keys):
+        buckets[fnv_hash(key, 0) % num_buckets].append(index)
+
+    seeds = [0] * num_buckets
+    slots = [None] * table_size
+    # The largest buckets are placed first, while the table is still empty.
+    order = sorted(range(num_buckets), key=lambda b: -len(buckets[b]))
+    for bucket in order:
+        if not buckets[bucket]:
+            continue
+        for seed in range(1, MAX_SEED + 1):
+            positions = [fnv_hash(keys[i], seed) % table_size
+                         for i in buckets[bucket]]
+            if (len(set(positions)) == len(positions) and
+                    all(slots[p] is None for p in positions)):
+                break
+        else:
+            sys.exit('No perfect hash found; lower LOAD_FACTOR')
+        seeds[bucket] = seed
+        for index, position in zip(buckets[bucket], positions):
+            slots[position] = index
+    return seeds, slots
+
+
+def write_table(path, input_name, entities, domains, seeds, slots):
+    lines = [
+        f'// Generated by generate_tracker_table.py from {input_name}.',
+        '// Do not edit.',
+        '',
+        'const char* const kTrackerEntities[] = {',
+    ]
+    for entity in entities:
+        lines.append(f'    "{entity}",')
+    lines += ['};', '', 'const TrackerDomain kTrackerDomains[] = {']
+    for index in slots:
+        if index is None:
+            lines.append('    {nullptr, 0, TrackerCategory::kContent},')
+            continue
+        domain, entity, category = domains[index]
+        lines.append(f'    {{"{domain}", {entity}, '
+                     f'TrackerCategory::{CATEGORIES[category]}}},')
+    lines += ['};', '', 'const uint16_t kTrackerSeeds[] = {']
+    for start in range(0, len(seeds), 12):
+        row = ', '.join(str(seed) for seed in seeds[start:start + 12])
+        lines.append(f'    {row},')
+    lines += ['};', '']
+
+    with open(path, 'w') as f:
+        f.write('\n'.join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('input', help='Tracker entity map')
+    parser.add_argument('output', help='Generated table to write')
+    args = parser.parse_args()
+
+    entities, domains = parse_entities(args.input)
+    if len(entities) > 0xffff:
+        sys.exit('Too many entities')
+    seeds, slots = build_table([domain for domain, _, _ in domains])
+    input_name = args.input.replace('\\', '/').rsplit('/', 1)[-1]
+    write_table(args.output, input_name, entities, domains, seeds, slots)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,87 @@
+#include "lunetix/common/trackers/tracker_classifier.h"
+
+#include "base/stl_util.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace lunetix {
+namespace trackers {
+
+namespace {
+
+#include "lunetix/common/trackers/tracker_entities-inc.cc"
+
+constexpr size_t kTableSize = base::size(kTrackerDomains);
+constexpr size_t kNumBuckets = base::size(kTrackerSeeds);
+
+// FNV-1a with a seeded basis and a final mix. Must match fnv_hash() in
+// generate_tracker_table.py.
+uint32_t Hash(base::StringPiece key, uint32_t seed) {
+  uint32_t hash = 0x811c9dc5u ^ seed;
+  for (char c : key) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x01000193u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+const TrackerDomain* Lookup(base::StringPiece domain) {
+  uint32_t seed = kTrackerSeeds[Hash(domain, 0) % kNumBuckets];
+  const TrackerDomain& entry =
+      kTrackerDomains[Hash(domain, seed) % kTableSize];
+  if (!entry.domain || domain != entry.domain) {
+    return nullptr;
+  }
+  return &entry;
+}
+
+}  // namespace
+
+const TrackerDomain* FindTrackerDomain(base::StringPiece host) {
+  // From the full host up to the last two labels; a bare top-level domain
+  // is never listed.
+  while (true) {
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos) {
+      return nullptr;
+    }
+    if (const TrackerDomain* entry = Lookup(host)) {
+      return entry;
+    }
+    host.remove_prefix(dot + 1);
+  }
+}
+
+const char* GetTrackerEntityName(const TrackerDomain& domain) {
+  return kTrackerEntities[domain.entity];
+}
+
+TrackerAction GetTrackerAction(const GURL& url, const url::Origin& initiator) {
+  const TrackerDomain* tracker = FindTrackerDomain(url.host_piece());
+  if (!tracker || tracker->category == TrackerCategory::kContent) {
+    return TrackerAction::kAllow;
+  }
+  if (!initiator.opaque()) {
+    if (net::registry_controlled_domains::SameDomainOrHost(
+            url, initiator,
+            net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
+      return TrackerAction::kAllow;
+    }
+    const TrackerDomain* owner = FindTrackerDomain(initiator.host());
+    if (owner && owner->entity == tracker->entity) {
+      return TrackerAction::kAllow;
+    }
+  }
+  return tracker->category == TrackerCategory::kSocial
+             ? TrackerAction::kStripCookies
+             : TrackerAction::kBlock;
+}
+
+}  // namespace trackers
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef LUNETIX_COMMON_TRACKERS_TRACKER_CLASSIFIER_H_
+#define LUNETIX_COMMON_TRACKERS_TRACKER_CLASSIFIER_H_
+
+#include <stdint.h>
+
+#include "base/strings/string_piece.h"
+
+class GURL;
+
+namespace url {
+class Origin;
+}
+
+namespace lunetix {
+namespace trackers {
+
+enum class TrackerCategory : uint8_t {
+  kAdvertising,
+  kAnalytics,
+  kCryptomining,
+  kFingerprinting,
+  kSocial,
+  // Not a tracker; only names the company a domain belongs to.
+  kContent,
+};
+
+enum class TrackerAction {
+  kAllow,
+  kBlock,
+  // Sent and answered without cookies.
+  kStripCookies,
+};
+
+// One domain of the tracker entity map, which is compiled into a perfect
+// hash table at build time from tracker_entities.txt.
+struct TrackerDomain {
+  // Null for the empty slots of the table.
+  const char* domain;
+  uint16_t entity;
+  TrackerCategory category;
+};
+
+// The entry for |host|, or for the closest of its parent domains that is
+// listed, or null.
+const TrackerDomain* FindTrackerDomain(base::StringPiece host);
+
+// Name of the company that runs |domain|.
+const char* GetTrackerEntityName(const TrackerDomain& domain);
+
+// What to do with a request for |url| made by |initiator|. Requests within
+// a site, or between the sites of one company, are always allowed; an
+// opaque initiator belongs to no company.
+TrackerAction GetTrackerAction(const GURL& url, const url::Origin& initiator);
+
+}  // namespace trackers
+}  // namespace lunetix
+
+#endif  // LUNETIX_COMMON_TRACKERS_TRACKER_CLASSIFIER_H_
\ No newline at end of file
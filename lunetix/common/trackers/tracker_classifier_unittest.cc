@@ -0,0 +1,89 @@
+#include "lunetix/common/trackers/tracker_classifier.h"
+
+#include <string>
+
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace lunetix {
+namespace trackers {
+
+namespace {
+
+std::string EntityOf(base::StringPiece host) {
+  const TrackerDomain* domain = FindTrackerDomain(host);
+  return domain ? GetTrackerEntityName(*domain) : "";
+}
+
+TrackerAction ActionFor(const char* url, const char* initiator) {
+  return GetTrackerAction(GURL(url), url::Origin::Create(GURL(initiator)));
+}
+
+}  // namespace
+
+TEST(TrackerClassifierTest, FindsListedDomainsAndSubdomains) {
+  const TrackerDomain* domain = FindTrackerDomain("doubleclick.net");
+  ASSERT_TRUE(domain);
+  EXPECT_STREQ("doubleclick.net", domain->domain);
+  EXPECT_EQ(TrackerCategory::kAdvertising, domain->category);
+  EXPECT_EQ("Alphabet", EntityOf("doubleclick.net"));
+  EXPECT_EQ("Alphabet", EntityOf("stats.g.doubleclick.net"));
+  EXPECT_EQ("Meta", EntityOf("connect.facebook.net"));
+  EXPECT_EQ("Index Exchange", EntityOf("casalemedia.com"));
+}
+
+TEST(TrackerClassifierTest, ClosestListedParentWins) {
+  const TrackerDomain* domain = FindTrackerDomain("adservice.google.com");
+  ASSERT_TRUE(domain);
+  EXPECT_EQ(TrackerCategory::kAdvertising, domain->category);
+
+  domain = FindTrackerDomain("www.google.com");
+  ASSERT_TRUE(domain);
+  EXPECT_EQ(TrackerCategory::kContent, domain->category);
+}
+
+TEST(TrackerClassifierTest, IgnoresUnlistedHosts) {
+  EXPECT_FALSE(FindTrackerDomain(""));
+  EXPECT_FALSE(FindTrackerDomain("net"));
+  EXPECT_FALSE(FindTrackerDomain("example.com"));
+  EXPECT_FALSE(FindTrackerDomain("notdoubleclick.net"));
+  EXPECT_FALSE(FindTrackerDomain("doubleclick.net.example"));
+}
+
+TEST(TrackerClassifierTest, BlocksThirdPartyTrackers) {
+  EXPECT_EQ(TrackerAction::kBlock,
+            ActionFor("https://stats.g.doubleclick.net/j/collect",
+                      "https://news.example"));
+  EXPECT_EQ(TrackerAction::kBlock,
+            ActionFor("https://coinhive.com/lib/miner.js",
+                      "https://news.example"));
+  EXPECT_EQ(TrackerAction::kStripCookies,
+            ActionFor("https://www.facebook.com/plugins/like.php",
+                      "https://news.example"));
+  EXPECT_EQ(TrackerAction::kAllow,
+            ActionFor("https://fonts.gstatic.com/font.woff2",
+                      "https://news.example"));
+  EXPECT_EQ(TrackerAction::kAllow,
+            ActionFor("https://cdn.example/app.js", "https://news.example"));
+}
+
+TEST(TrackerClassifierTest, AllowsTrackersOfTheSameCompany) {
+  EXPECT_EQ(TrackerAction::kAllow,
+            ActionFor("https://doubleclick.net/ad", "https://doubleclick.net"));
+  EXPECT_EQ(TrackerAction::kAllow,
+            ActionFor("https://googleads.g.doubleclick.net/pagead",
+                      "https://www.youtube.com"));
+  EXPECT_EQ(TrackerAction::kBlock,
+            ActionFor("https://googleads.g.doubleclick.net/pagead",
+                      "https://www.facebook.com"));
+}
+
+TEST(TrackerClassifierTest, OpaqueInitiatorsBelongToNoCompany) {
+  EXPECT_EQ(TrackerAction::kBlock,
+            GetTrackerAction(GURL("https://googleads.g.doubleclick.net/"),
+                             url::Origin()));
+}
+
+}  // namespace trackers
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "lunetix/renderer/adblock/ad_block_ruleset_dealer.h"
+
+#include <utility>
+
+namespace lunetix {
+
+AdBlockRulesetDealer::AdBlockRulesetDealer() = default;
+
+AdBlockRulesetDealer::~AdBlockRulesetDealer() = default;
+
+void AdBlockRulesetDealer::BindReceiver(
+    mojo::PendingAssociatedReceiver<mojom::AdBlockRulesetObserver> receiver) {
+  receiver_.reset();
+  receiver_.Bind(std::move(receiver));
+}
+
+scoped_refptr<const adblock::MappedRuleset> AdBlockRulesetDealer::GetRuleset()
+    const {
+  base::AutoLock lock(lock_);
+  return ruleset_;
+}
+
+void AdBlockRulesetDealer::SetRuleset(base::File ruleset_file) {
+  // A file that fails to map or validate turns blocking off rather than
+  // keeping a ruleset the browser no longer uses.
+  scoped_refptr<const adblock::MappedRuleset> ruleset =
+      adblock::MappedRuleset::Open(std::move(ruleset_file));
+  
+  base::AutoLock lock(lock_);
+  ruleset_ = std::move(ruleset);
+}
+
+void AdBlockRulesetDealer::SetTrackerBlockingEnabled(bool enabled) {
+  block_trackers_.store(enabled, std::memory_order_relaxed);
+}
+
+}  // namespace lunetix
\ No newline at end of file
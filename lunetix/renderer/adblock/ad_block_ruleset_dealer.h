@@ -0,0 +1,54 @@
+#ifndef LUNETIX_RENDERER_ADBLOCK_AD_BLOCK_RULESET_DEALER_H_
+#define LUNETIX_RENDERER_ADBLOCK_AD_BLOCK_RULESET_DEALER_H_
+
+#include <atomic>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/synchronization/lock.h"
+#include "base/thread_annotations.h"
+#include "lunetix/common/adblock/mapped_ruleset.h"
+#include "lunetix/common/mojom/ad_block.mojom.h"
+#include "mojo/public/cpp/bindings/associated_receiver.h"
+#include "mojo/public/cpp/bindings/pending_associated_receiver.h"
+
+namespace lunetix {
+
+// Holds the content blocking ruleset of a renderer and the tracker blocking
+// setting, as sent by the browser. The file is mapped here, so the pages are shared with every
+// other process using the same ruleset. Throttles on any thread take a
+// reference to the current ruleset when they are created.
+class AdBlockRulesetDealer : public mojom::AdBlockRulesetObserver {
+ public:
+  AdBlockRulesetDealer();
+  ~AdBlockRulesetDealer() override;
+
+  void BindReceiver(
+      mojo::PendingAssociatedReceiver<mojom::AdBlockRulesetObserver>
+          receiver);
+
+  // Null while content blocking is off. Safe to call from any thread.
+  scoped_refptr<const adblock::MappedRuleset> GetRuleset() const;
+
+  // Safe to call from any thread.
+  bool IsTrackerBlockingEnabled() const {
+    return block_trackers_.load(std::memory_order_relaxed);
+  }
+
+  // mojom::AdBlockRulesetObserver overrides:
+  void SetRuleset(base::File ruleset_file) override;
+  void SetTrackerBlockingEnabled(bool enabled) override;
+
+ private:
+  mojo::AssociatedReceiver<mojom::AdBlockRulesetObserver> receiver_{this};
+
+  mutable base::Lock lock_;
+  scoped_refptr<const adblock::MappedRuleset> ruleset_ GUARDED_BY(lock_);
+
+  std::atomic<bool> block_trackers_{false};
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockRulesetDealer);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_RENDERER_ADBLOCK_AD_BLOCK_RULESET_DEALER_H_
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "lunetix/renderer/adblock/cosmetic_filters_agent.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "content/public/renderer/render_frame.h"
+#include "gin/converter.h"
+#include "gin/function_template.h"
+#include "lunetix/common/lunetix_constants.h"
+#include "lunetix/renderer/adblock/ad_block_ruleset_dealer.h"
+#include "third_party/blink/public/common/browser_interface_broker_proxy.h"
+#include "third_party/blink/public/platform/web_string.h"
+#include "third_party/blink/public/web/blink.h"
+#include "third_party/blink/public/web/web_document.h"
+#include "third_party/blink/public/web/web_local_frame.h"
+#include "third_party/blink/public/web/web_script_source.h"
+
+namespace lunetix {
+
+namespace {
+
+// The observer runs where page scripts cannot reach it or the report
+// function.
+constexpr int32_t kCosmeticFiltersWorldId =
+    ISOLATED_WORLD_ID_LUNETIX_COSMETIC_FILTERS;
+
+const char kReportFunctionName[] = "lunetixReportCosmeticKeys";
+
+// Reports the classes and ids of the document once, then those of added
+// or changed elements at most once a second. Keys are only reported the
+// first time they are seen, and a document stops being observed after a
+// fixed number of them.
+const char kObserverScript[] = R"js(
+(function() {
+  const kReportIntervalMs = 1000;
+  const kMaxKeys = 10000;
+  const kBatchSize = 1000;
+  const seen = new Set();
+  let pending = [];
+  let timer = 0;
+  let lastReport = 0;
+
+  function add(key) {
+    if (seen.size < kMaxKeys && !seen.has(key)) {
+      seen.add(key);
+      pending.push(key);
+    }
+  }
+
+  function collect(element) {
+    if (element.id) {
+      add('#' + element.id);
+    }
+    for (const name of element.classList) {
+      add('.' + name);
+    }
+  }
+
+  function report() {
+    timer = 0;
+    lastReport = Date.now();
+    while (pending.length) {
+      lunetixReportCosmeticKeys(pending.splice(0, kBatchSize));
+    }
+  }
+
+  function scheduleReport() {
+    if (!timer && pending.length) {
+      timer = setTimeout(
+          report, Math.max(0, lastReport + kReportIntervalMs - Date.now()));
+    }
+  }
+
+  for (const element of document.querySelectorAll('[id],[class]')) {
+    collect(element);
+  }
+  report();
+
+  const observer = new MutationObserver(mutations => {
+    for (const mutation of mutations) {
+      if (mutation.type === 'attributes') {
+        collect(mutation.target);
+        continue;
+      }
+      for (const node of mutation.addedNodes) {
+        if (node.nodeType !== Node.ELEMENT_NODE) {
+          continue;
+        }
+        collect(node);
+        for (const element of node.querySelectorAll('[id],[class]')) {
+          collect(element);
+        }
+      }
+    }
+    if (seen.size >= kMaxKeys) {
+      observer.disconnect();
+    }
+    scheduleReport();
+  });
+  observer.observe(document.documentElement, {
+    childList: true,
+    subtree: true,
+    attributes: true,
+    attributeFilter: ['id', 'class'],
+  });
+})();
+)js";
+
+}  // namespace
+
+CosmeticFiltersAgent::CosmeticFiltersAgent(
+    content::RenderFrame* render_frame,
+    const AdBlockRulesetDealer* ruleset_dealer)
+    : content::RenderFrameObserver(render_frame),
+      ruleset_dealer_(ruleset_dealer) {}
+
+CosmeticFiltersAgent::~CosmeticFiltersAgent() = default;
+
+void CosmeticFiltersAgent::DidCommitProvisionalLoad(
+    ui::PageTransition transition) {
+  ++document_id_;
+  document_url_ = GURL(render_frame()->GetWebFrame()->GetDocument().Url());
+  has_keyed_rules_ = false;
+  dom_content_loaded_ = false;
+  observer_started_ = false;
+  if (!document_url_.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+  
+  // The renderer holds the same ruleset as the browser, so documents no
+  // element hiding rule can apply to skip the round trip.
+  scoped_refptr<const adblock::MappedRuleset> ruleset =
+      ruleset_dealer_->GetRuleset();
+  if (!ruleset || !ruleset->matcher().cosmetic_rule_count()) {
+    return;
+  }
+  
+  GetHost()->GetHostStyleSheet(
+      document_url_,
+      base::BindOnce(&CosmeticFiltersAgent::OnHostStyleSheet,
+                     weak_factory_.GetWeakPtr(), document_id_));
+}
+
+void CosmeticFiltersAgent::DidDispatchDOMContentLoadedEvent() {
+  dom_content_loaded_ = true;
+  MaybeStartObserver();
+}
+
+void CosmeticFiltersAgent::DidCreateScriptContext(
+    v8::Local<v8::Context> context,
+    int32_t world_id) {
+  if (world_id != kCosmeticFiltersWorldId) {
+    return;
+  }
+  
+  v8::Isolate* isolate = blink::MainThreadIsolate();
+  v8::HandleScope handle_scope(isolate);
+  v8::Context::Scope context_scope(context);
+  v8::Local<v8::Function> report =
+      gin::CreateFunctionTemplate(
+          isolate, base::BindRepeating(&CosmeticFiltersAgent::OnKeysFound,
+                                       weak_factory_.GetWeakPtr()))
+          ->GetFunction(context)
+          .ToLocalChecked();
+  context->Global()
+      ->Set(context, gin::StringToSymbol(isolate, kReportFunctionName),
+            report)
+      .Check();
+}
+
+void CosmeticFiltersAgent::OnDestruct() {
+  delete this;
+}
+
+void CosmeticFiltersAgent::OnHostStyleSheet(int document_id,
+                                            const std::string& style_sheet,
+                                            bool has_keyed_rules) {
+  if (document_id != document_id_) {
+    return;
+  }
+  
+  InsertStyleSheet(style_sheet);
+  has_keyed_rules_ = has_keyed_rules;
+  MaybeStartObserver();
+}
+
+void CosmeticFiltersAgent::OnKeyedStyleSheet(int document_id,
+                                             const std::string& style_sheet) {
+  if (document_id == document_id_) {
+    InsertStyleSheet(style_sheet);
+  }
+}
+
+void CosmeticFiltersAgent::OnKeysFound(std::vector<std::string> keys) {
+  if (!observer_started_ || keys.empty()) {
+    return;
+  }
+  
+  GetHost()->GetKeyedStyleSheet(
+      document_url_, keys,
+      base::BindOnce(&CosmeticFiltersAgent::OnKeyedStyleSheet,
+                     weak_factory_.GetWeakPtr(), document_id_));
+}
+
+void CosmeticFiltersAgent::MaybeStartObserver() {
+  if (observer_started_ || !has_keyed_rules_ || !dom_content_loaded_) {
+    return;
+  }
+  
+  observer_started_ = true;
+  render_frame()->GetWebFrame()->ExecuteScriptInIsolatedWorld(
+      kCosmeticFiltersWorldId,
+      blink::WebScriptSource(blink::WebString::FromUTF8(kObserverScript)),
+      blink::BackForwardCacheAware::kAllow);
+}
+
+void CosmeticFiltersAgent::InsertStyleSheet(const std::string& style_sheet) {
+  if (style_sheet.empty()) {
+    return;
+  }
+  
+  // A user style sheet, so that the page's own !important rules cannot
+  // bring hidden elements back.
+  render_frame()->GetWebFrame()->GetDocument().InsertStyleSheet(
+      blink::WebString::FromUTF8(style_sheet), nullptr,
+      blink::WebCssOrigin::kUser);
+}
+
+mojom::CosmeticFiltersHost* CosmeticFiltersAgent::GetHost() {
+  if (!host_) {
+    render_frame()->GetBrowserInterfaceBroker()->GetInterface(
+        host_.BindNewPipeAndPassReceiver());
+  }
+  return host_.get();
+}
+
+}  // namespace lunetix
\ No newline at end of file
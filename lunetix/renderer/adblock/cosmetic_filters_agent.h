@@ -0,0 +1,67 @@
+#ifndef LUNETIX_RENDERER_ADBLOCK_COSMETIC_FILTERS_AGENT_H_
+#define LUNETIX_RENDERER_ADBLOCK_COSMETIC_FILTERS_AGENT_H_
+
+#include <string>
+#include <vector>
+
+#include "base/memory/weak_ptr.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "lunetix/common/mojom/cosmetic_filters.mojom.h"
+#include "mojo/public/cpp/bindings/remote.h"
+#include "url/gurl.h"
+#include "v8/include/v8.h"
+
+namespace lunetix {
+
+class AdBlockRulesetDealer;
+
+// Applies element hiding rules to the documents of a frame. Rules naming
+// the host, and generic rules every document gets, arrive as one style
+// sheet right after commit. Generic rules keyed by a class or id are only
+// asked for once a rate limited observer in an isolated world has seen the
+// class or id in the document. Nothing is inserted into documents no rule
+// applies to.
+class CosmeticFiltersAgent : public content::RenderFrameObserver {
+ public:
+  // |ruleset_dealer| lives as long as the render thread.
+  CosmeticFiltersAgent(content::RenderFrame* render_frame,
+                       const AdBlockRulesetDealer* ruleset_dealer);
+  ~CosmeticFiltersAgent() override;
+
+  // content::RenderFrameObserver overrides:
+  void DidCommitProvisionalLoad(ui::PageTransition transition) override;
+  void DidDispatchDOMContentLoadedEvent() override;
+  void DidCreateScriptContext(v8::Local<v8::Context> context,
+                              int32_t world_id) override;
+  void OnDestruct() override;
+
+ private:
+  void OnHostStyleSheet(int document_id,
+                        const std::string& style_sheet,
+                        bool has_keyed_rules);
+  void OnKeyedStyleSheet(int document_id, const std::string& style_sheet);
+  // Called from the observer script with classes and ids not seen before.
+  void OnKeysFound(std::vector<std::string> keys);
+  void MaybeStartObserver();
+  void InsertStyleSheet(const std::string& style_sheet);
+  mojom::CosmeticFiltersHost* GetHost();
+
+  // Identifies the current document so that replies for a previous one are
+  // dropped.
+  int document_id_ = 0;
+  GURL document_url_;
+  bool has_keyed_rules_ = false;
+  bool dom_content_loaded_ = false;
+  bool observer_started_ = false;
+
+  const AdBlockRulesetDealer* const ruleset_dealer_;
+  mojo::Remote<mojom::CosmeticFiltersHost> host_;
+
+  base::WeakPtrFactory<CosmeticFiltersAgent> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(CosmeticFiltersAgent);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_RENDERER_ADBLOCK_COSMETIC_FILTERS_AGENT_H_
\ No newline at end of file
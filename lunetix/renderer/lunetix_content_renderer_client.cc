@@ -1,7 +1,11 @@
 #include "lunetix/renderer/lunetix_content_renderer_client.h"
 
 #include "content/public/renderer/render_thread.h"
+#include "content/public/renderer/render_frame.h"
+#include "lunetix/renderer/adblock/cosmetic_filters_agent.h"
 #include "lunetix/renderer/lunetix_render_thread_observer.h"
+#include "lunetix/renderer/lunetix_url_loader_throttle_provider.h"
+#include "lunetix/renderer/reading_mode/readability_classifier.h"
 
 namespace lunetix {
 
@@ -12,17 +16,34 @@ LunetixContentRendererClient::~LunetixContentRendererClient() = default;
 void LunetixContentRendererClient::RenderThreadStarted() {
   ChromeContentRendererClient::RenderThreadStarted();
   
+  render_thread_observer_ = std::make_unique<LunetixRenderThreadObserver>();
   content::RenderThread* thread = content::RenderThread::Get();
-  thread->AddObserver(new LunetixRenderThreadObserver());
+  thread->AddObserver(render_thread_observer_.get());
 }
 
 void LunetixContentRendererClient::RenderFrameCreated(
     content::RenderFrame* render_frame) {
   ChromeContentRendererClient::RenderFrameCreated(render_frame);
+  
+  // Agents delete themselves when the frame goes away.
+  new CosmeticFiltersAgent(render_frame,
+                           render_thread_observer_->ruleset_dealer());
+  if (render_frame->IsMainFrame()) {
+    new ReadabilityClassifier(render_frame);
+  }
 }
 
 void LunetixContentRendererClient::WebViewCreated(blink::WebView* web_view) {
   ChromeContentRendererClient::WebViewCreated(web_view);
 }
 
+std::unique_ptr<blink::URLLoaderThrottleProvider>
+LunetixContentRendererClient::CreateURLLoaderThrottleProvider(
+    blink::URLLoaderThrottleProviderType provider_type) {
+  return std::make_unique<LunetixURLLoaderThrottleProvider>(
+      ChromeContentRendererClient::CreateURLLoaderThrottleProvider(
+          provider_type),
+      render_thread_observer_->ruleset_dealer());
+}
+
 }  // namespace lunetix
\ No newline at end of file
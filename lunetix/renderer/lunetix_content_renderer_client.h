@@ -1,10 +1,14 @@
 #ifndef LUNETIX_RENDERER_LUNETIX_CONTENT_RENDERER_CLIENT_H_
 #define LUNETIX_RENDERER_LUNETIX_CONTENT_RENDERER_CLIENT_H_
 
+#include <memory>
+
 #include "chrome/renderer/chrome_content_renderer_client.h"
 
 namespace lunetix {
 
+class LunetixRenderThreadObserver;
+
 class LunetixContentRendererClient : public ChromeContentRendererClient {
  public:
   LunetixContentRendererClient();
@@ -14,8 +18,13 @@ class LunetixContentRendererClient : public ChromeContentRendererClient {
   void RenderThreadStarted() override;
   void RenderFrameCreated(content::RenderFrame* render_frame) override;
   void WebViewCreated(blink::WebView* web_view) override;
+  std::unique_ptr<blink::URLLoaderThrottleProvider>
+  CreateURLLoaderThrottleProvider(
+      blink::URLLoaderThrottleProviderType provider_type) override;
 
  private:
+  std::unique_ptr<LunetixRenderThreadObserver> render_thread_observer_;
+
   DISALLOW_COPY_AND_ASSIGN(LunetixContentRendererClient);
 };
 
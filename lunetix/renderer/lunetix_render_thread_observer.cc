@@ -1,5 +1,8 @@
 #include "lunetix/renderer/lunetix_render_thread_observer.h"
 
+#include "base/bind.h"
+#include "third_party/blink/public/common/associated_interfaces/associated_interface_registry.h"
+
 namespace lunetix {
 
 LunetixRenderThreadObserver::LunetixRenderThreadObserver() = default;
@@ -8,12 +11,15 @@ LunetixRenderThreadObserver::~LunetixRenderThreadObserver() = default;
 
 void LunetixRenderThreadObserver::RegisterMojoInterfaces(
     blink::AssociatedInterfaceRegistry* associated_interfaces) {
-  // Register Lunetix-specific Mojo interfaces here
+  associated_interfaces->AddInterface(
+      base::BindRepeating(&AdBlockRulesetDealer::BindReceiver,
+                          base::Unretained(&ruleset_dealer_)));
 }
 
 void LunetixRenderThreadObserver::UnregisterMojoInterfaces(
     blink::AssociatedInterfaceRegistry* associated_interfaces) {
-  // Unregister Lunetix-specific Mojo interfaces here
+  associated_interfaces->RemoveInterface(
+      mojom::AdBlockRulesetObserver::Name_);
 }
 
 }  // namespace lunetix
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define LUNETIX_RENDERER_LUNETIX_RENDER_THREAD_OBSERVER_H_
 
 #include "content/public/renderer/render_thread_observer.h"
+#include "lunetix/renderer/adblock/ad_block_ruleset_dealer.h"
 
 namespace lunetix {
 
@@ -16,7 +17,13 @@ class LunetixRenderThreadObserver : public content::RenderThreadObserver {
   void UnregisterMojoInterfaces(
       blink::AssociatedInterfaceRegistry* associated_interfaces) override;
 
+  const AdBlockRulesetDealer* ruleset_dealer() const {
+    return &ruleset_dealer_;
+  }
+
  private:
+  AdBlockRulesetDealer ruleset_dealer_;
+
   DISALLOW_COPY_AND_ASSIGN(LunetixRenderThreadObserver);
 };
 
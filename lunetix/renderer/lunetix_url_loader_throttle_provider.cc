@@ -0,0 +1,40 @@
+#include "lunetix/renderer/lunetix_url_loader_throttle_provider.h"
+
+#include <utility>
+
+#include "lunetix/common/net/lunetix_url_loader_throttle.h"
+#include "lunetix/renderer/adblock/ad_block_ruleset_dealer.h"
+
+namespace lunetix {
+
+LunetixURLLoaderThrottleProvider::LunetixURLLoaderThrottleProvider(
+    std::unique_ptr<blink::URLLoaderThrottleProvider> chrome_provider,
+    const AdBlockRulesetDealer* ruleset_dealer)
+    : chrome_provider_(std::move(chrome_provider)),
+      ruleset_dealer_(ruleset_dealer) {}
+
+LunetixURLLoaderThrottleProvider::~LunetixURLLoaderThrottleProvider() = default;
+
+std::unique_ptr<blink::URLLoaderThrottleProvider>
+LunetixURLLoaderThrottleProvider::Clone() {
+  return std::make_unique<LunetixURLLoaderThrottleProvider>(
+      chrome_provider_->Clone(), ruleset_dealer_);
+}
+
+blink::WebVector<std::unique_ptr<blink::URLLoaderThrottle>>
+LunetixURLLoaderThrottleProvider::CreateThrottles(
+    int render_frame_id,
+    const blink::WebURLRequest& request) {
+  blink::WebVector<std::unique_ptr<blink::URLLoaderThrottle>> throttles =
+      chrome_provider_->CreateThrottles(render_frame_id, request);
+  throttles.emplace_back(std::make_unique<LunetixURLLoaderThrottle>(
+      ruleset_dealer_->GetRuleset(),
+      ruleset_dealer_->IsTrackerBlockingEnabled()));
+  return throttles;
+}
+
+void LunetixURLLoaderThrottleProvider::SetOnline(bool is_online) {
+  chrome_provider_->SetOnline(is_online);
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef LUNETIX_RENDERER_LUNETIX_URL_LOADER_THROTTLE_PROVIDER_H_
+#define LUNETIX_RENDERER_LUNETIX_URL_LOADER_THROTTLE_PROVIDER_H_
+
+#include <memory>
+
+#include "third_party/blink/public/platform/url_loader_throttle_provider.h"
+
+namespace lunetix {
+
+class AdBlockRulesetDealer;
+
+// Adds the Lunetix throttle to the ones Chrome creates for every request
+// of a frame or worker, so that blocking happens before the request leaves
+// the renderer.
+class LunetixURLLoaderThrottleProvider
+    : public blink::URLLoaderThrottleProvider {
+ public:
+  // |ruleset_dealer| lives as long as the render thread.
+  LunetixURLLoaderThrottleProvider(
+      std::unique_ptr<blink::URLLoaderThrottleProvider> chrome_provider,
+      const AdBlockRulesetDealer* ruleset_dealer);
+  ~LunetixURLLoaderThrottleProvider() override;
+
+  // blink::URLLoaderThrottleProvider overrides:
+  std::unique_ptr<blink::URLLoaderThrottleProvider> Clone() override;
+  blink::WebVector<std::unique_ptr<blink::URLLoaderThrottle>> CreateThrottles(
+      int render_frame_id,
+      const blink::WebURLRequest& request) override;
+  void SetOnline(bool is_online) override;
+
+ private:
+  std::unique_ptr<blink::URLLoaderThrottleProvider> chrome_provider_;
+  const AdBlockRulesetDealer* const ruleset_dealer_;
+
+  DISALLOW_COPY_AND_ASSIGN(LunetixURLLoaderThrottleProvider);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_RENDERER_LUNETIX_URL_LOADER_THROTTLE_PROVIDER_H_
\ No newline at end of file
@@ -0,0 +1,153 @@
+#include "lunetix/renderer/reading_mode/readability_classifier.h"
+
+#include <algorithm>
+
+#include "base/strings/string_util.h"
+#include "content/public/renderer/render_frame.h"
+#include "third_party/blink/public/common/browser_interface_broker_proxy.h"
+#include "third_party/blink/public/platform/web_string.h"
+#include "third_party/blink/public/platform/web_vector.h"
+#include "third_party/blink/public/web/web_document.h"
+#include "third_party/blink/public/web/web_element.h"
+#include "third_party/blink/public/web/web_local_frame.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+
+namespace {
+
+// Shorter paragraphs are usually captions, bylines or buttons.
+constexpr size_t kMinParagraphLength = 80;
+
+// Caps on the elements inspected so very large pages stay cheap.
+constexpr size_t kMaxParagraphs = 300;
+constexpr size_t kMaxLinks = 1000;
+constexpr size_t kMaxStructuredDataScripts = 10;
+
+const char kArticleSchemaSelector[] =
+    "[itemtype*='schema.org/Article'], [itemtype*='schema.org/NewsArticle'], "
+    "[itemtype*='schema.org/BlogPosting'], [itemtype*='schema.org/Report']";
+
+const char* const kArticleSchemaTypes[] = {
+    "\"Article\"", "\"NewsArticle\"", "\"BlogPosting\"", "\"Report\"",
+    "\"TechArticle\"",
+};
+
+size_t CountWords(base::StringPiece text) {
+  size_t words = 0;
+  bool in_word = false;
+  for (char c : text) {
+    if (base::IsAsciiWhitespace(c)) {
+      in_word = false;
+    } else if (!in_word) {
+      in_word = true;
+      ++words;
+    }
+  }
+  return words;
+}
+
+bool HasArticleStructuredData(const blink::WebDocument& document) {
+  blink::WebVector<blink::WebElement> scripts = document.QuerySelectorAll(
+      blink::WebString::FromASCII("script[type='application/ld+json']"));
+  for (size_t i = 0; i < scripts.size() && i < kMaxStructuredDataScripts;
+       ++i) {
+    std::string json = scripts[i].TextContent().Utf8();
+    for (const char* type : kArticleSchemaTypes) {
+      if (json.find(type) != std::string::npos) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+ReadabilityClassifier::ReadabilityClassifier(content::RenderFrame* render_frame)
+    : content::RenderFrameObserver(render_frame) {}
+
+ReadabilityClassifier::~ReadabilityClassifier() = default;
+
+void ReadabilityClassifier::DidCommitProvisionalLoad(
+    ui::PageTransition transition) {
+  classified_ = false;
+}
+
+void ReadabilityClassifier::DidFinishLoad() {
+  if (classified_ || !render_frame()->IsMainFrame()) {
+    return;
+  }
+  
+  GURL url(render_frame()->GetWebFrame()->GetDocument().Url());
+  if (!url.SchemeIsHTTPOrHTTPS()) {
+    return;
+  }
+  
+  classified_ = true;
+  GetHost()->OnReadabilityClassified(url, CollectSignals());
+}
+
+void ReadabilityClassifier::OnDestruct() {
+  delete this;
+}
+
+mojom::ReadabilitySignalsPtr ReadabilityClassifier::CollectSignals() {
+  auto signals = mojom::ReadabilitySignals::New();
+  blink::WebDocument document = render_frame()->GetWebFrame()->GetDocument();
+  if (document.Body().IsNull()) {
+    return signals;
+  }
+  
+  size_t paragraph_chars = 0;
+  blink::WebVector<blink::WebElement> paragraphs =
+      document.QuerySelectorAll(blink::WebString::FromASCII("p"));
+  for (size_t i = 0; i < paragraphs.size() && i < kMaxParagraphs; ++i) {
+    std::string text = paragraphs[i].TextContent().Utf8();
+    base::StringPiece trimmed = base::TrimWhitespaceASCII(text, base::TRIM_ALL);
+    if (trimmed.size() < kMinParagraphLength) {
+      continue;
+    }
+    signals->paragraph_count++;
+    signals->word_count += CountWords(trimmed);
+    paragraph_chars += trimmed.size();
+  }
+  
+  if (paragraph_chars > 0) {
+    size_t link_chars = 0;
+    blink::WebVector<blink::WebElement> links =
+        document.QuerySelectorAll(blink::WebString::FromASCII("p a"));
+    for (size_t i = 0; i < links.size() && i < kMaxLinks; ++i) {
+      link_chars += links[i].TextContent().length();
+    }
+    signals->link_density =
+        std::min(static_cast<float>(link_chars) / paragraph_chars, 1.0f);
+  }
+  
+  signals->has_article_element =
+      !document.QuerySelector(blink::WebString::FromASCII("article")).IsNull();
+  blink::WebElement schema_item = document.QuerySelector(
+      blink::WebString::FromASCII(kArticleSchemaSelector));
+  signals->has_article_schema =
+      !schema_item.IsNull() || HasArticleStructuredData(document);
+  
+  blink::WebElement og_type = document.QuerySelector(
+      blink::WebString::FromASCII("meta[property='og:type']"));
+  signals->has_open_graph_article =
+      !og_type.IsNull() &&
+      base::EqualsCaseInsensitiveASCII(
+          og_type.GetAttribute(blink::WebString::FromASCII("content")).Utf8(),
+          "article");
+  
+  return signals;
+}
+
+mojom::ReadabilityHost* ReadabilityClassifier::GetHost() {
+  if (!host_) {
+    render_frame()->GetBrowserInterfaceBroker()->GetInterface(
+        host_.BindNewPipeAndPassReceiver());
+  }
+  return host_.get();
+}
+
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef LUNETIX_RENDERER_READING_MODE_READABILITY_CLASSIFIER_H_
+#define LUNETIX_RENDERER_READING_MODE_READABILITY_CLASSIFIER_H_
+
+#include "content/public/renderer/render_frame_observer.h"
+#include "lunetix/common/mojom/readability.mojom.h"
+#include "mojo/public/cpp/bindings/remote.h"
+
+namespace lunetix {
+
+// Collects readability signals of main frame documents once they finish
+// loading and reports them to the browser, which scores them. Only structure
+// that is cheap to query is looked at, so pages that are not articles never
+// pay for extraction.
+class ReadabilityClassifier : public content::RenderFrameObserver {
+ public:
+  explicit ReadabilityClassifier(content::RenderFrame* render_frame);
+  ~ReadabilityClassifier() override;
+
+  // content::RenderFrameObserver overrides:
+  void DidCommitProvisionalLoad(ui::PageTransition transition) override;
+  void DidFinishLoad() override;
+  void OnDestruct() override;
+
+ private:
+  mojom::ReadabilitySignalsPtr CollectSignals();
+  mojom::ReadabilityHost* GetHost();
+
+  // Set once the current document has been reported.
+  bool classified_ = false;
+
+  mojo::Remote<mojom::ReadabilityHost> host_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadabilityClassifier);
+};
+
+}  // namespace lunetix
+
+#endif  // LUNETIX_RENDERER_READING_MODE_READABILITY_CLASSIFIER_H_
\ No newline at end of file
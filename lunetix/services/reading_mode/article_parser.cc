@@ -0,0 +1,901 @@
+#include "lunetix/services/reading_mode/article_parser.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "base/containers/flat_map.h"
+#include "base/containers/flat_set.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/strings/utf_string_conversion_utils.h"
+
+namespace lunetix {
+namespace reading_mode {
+
+namespace {
+
+constexpr int kWordsPerMinute = 200;
+constexpr size_t kMinParagraphLength = 25;
+constexpr size_t kMaxExcerptLength = 200;
+constexpr size_t kMaxAuthorLength = 100;
+constexpr size_t kMaxTreeDepth = 256;
+
+// Chunks are closed at the first top-level block boundary after this many
+// words, so the reader can lay out and mount long articles piecewise.
+constexpr size_t kChunkWordCount = 400;
+
+// Elements that never open a subtree.
+const char* const kVoidElements[] = {
+    "area", "base", "br", "col", "embed", "hr", "img", "input",
+    "link", "meta", "param", "source", "track", "wbr",
+};
+
+// Elements whose content is raw text rather than markup.
+const char* const kRawTextElements[] = {
+    "script", "style", "textarea", "title", "noscript", "xmp", "iframe",
+};
+
+// Elements that are dropped together with their content when sanitizing.
+const char* const kDroppedElements[] = {
+    "head",  "script", "style",  "noscript", "template", "svg",
+    "math",  "iframe", "object", "embed",    "canvas",   "form",
+    "button", "input", "select", "textarea", "nav",      "aside",
+    "footer", "video", "audio",  "link",     "meta",     "dialog",
+};
+
+// Elements that survive sanitization. Anything not listed here or in
+// kDroppedElements is unwrapped and only its children are kept.
+const char* const kAllowedElements[] = {
+    "p",      "br",     "hr",     "h1",   "h2",      "h3",    "h4",
+    "h5",     "h6",     "blockquote", "pre", "code",  "em",    "i",
+    "strong", "b",      "u",      "s",    "sub",     "sup",   "small",
+    "mark",   "q",      "cite",   "abbr", "ul",      "ol",    "li",
+    "dl",     "dt",     "dd",     "a",    "img",     "figure", "figcaption",
+    "table",  "thead",  "tbody",  "tfoot", "tr",     "th",    "td",
+    "caption", "time",
+};
+
+// Elements that implicitly close an open <p>.
+const char* const kParagraphClosingElements[] = {
+    "address", "article", "aside", "blockquote", "div", "dl", "figure",
+    "footer", "h1", "h2", "h3", "h4", "h5", "h6", "header", "hr", "main",
+    "nav", "ol", "p", "pre", "section", "table", "ul",
+};
+
+// Block-level children that stop a <div> from being scored as a paragraph.
+const char* const kBlockElements[] = {
+    "article", "blockquote", "div", "dl", "figure", "h1", "h2", "h3", "h4",
+    "h5", "h6", "ol", "p", "pre", "section", "table", "ul",
+};
+
+const char* const kUnlikelyHints[] = {
+    "banner", "breadcrumb", "combx", "comment", "community", "cookie",
+    "disqus", "footer", "header", "menu", "modal", "nav", "newsletter",
+    "popup", "promo", "related", "remark", "rss", "share", "shoutbox",
+    "sidebar", "social", "sponsor", "subscribe", "advert", "ad-break",
+};
+
+const char* const kMaybeHints[] = {
+    "and", "article", "body", "column", "content", "main", "shadow", "story",
+};
+
+const char* const kPositiveHints[] = {
+    "article", "blog", "body", "content", "entry", "hentry", "main", "page",
+    "post", "story", "text",
+};
+
+const char* const kNegativeHints[] = {
+    "ad-", "comment", "contact", "footer", "footnote", "masthead", "media",
+    "meta", "outbrain", "promo", "related", "scroll", "share", "shopping",
+    "sidebar", "sponsor", "tags", "taboola", "widget",
+};
+
+template <size_t N>
+bool IsOneOf(const std::string& tag, const char* const (&list)[N]) {
+  for (const char* entry : list) {
+    if (tag == entry) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <size_t N>
+bool ContainsAnyOf(const std::string& haystack, const char* const (&list)[N]) {
+  for (const char* entry : list) {
+    if (haystack.find(entry) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+struct Node {
+  std::string tag;  // Empty for text nodes.
+  std::string text;
+  base::flat_map<std::string, std::string> attributes;
+  Node* parent = nullptr;
+  std::vector<std::unique_ptr<Node>> children;
+
+  bool removed = false;
+  bool is_candidate = false;
+  double score = 0.0;
+
+  // Aggregated over the subtree after the tree is built.
+  size_t text_length = 0;
+  size_t link_text_length = 0;
+  size_t comma_count = 0;
+  bool has_block_child = false;
+
+  bool IsText() const { return tag.empty(); }
+
+  std::string Attribute(const char* name) const {
+    auto it = attributes.find(name);
+    return it != attributes.end() ? it->second : std::string();
+  }
+
+  std::string ClassAndId() const {
+    return base::ToLowerASCII(Attribute("class") + " " + Attribute("id"));
+  }
+};
+
+bool IsTagNameChar(char c) {
+  return base::IsAsciiAlpha(c) || base::IsAsciiDigit(c) || c == '-' ||
+         c == ':';
+}
+
+void AppendDecodedEntity(base::StringPiece entity, std::string* out) {
+  static const struct {
+    const char* name;
+    uint32_t code_point;
+  } kNamedEntities[] = {
+      {"amp", '&'},      {"lt", '<'},       {"gt", '>'},
+      {"quot", '"'},     {"apos", '\''},    {"nbsp", 0xA0},
+      {"mdash", 0x2014}, {"ndash", 0x2013}, {"hellip", 0x2026},
+      {"lsquo", 0x2018}, {"rsquo", 0x2019}, {"ldquo", 0x201C},
+      {"rdquo", 0x201D}, {"copy", 0xA9},    {"reg", 0xAE},
+  };
+
+  uint32_t code_point = 0;
+  if (!entity.empty() && entity[0] == '#') {
+    base::StringPiece digits = entity.substr(1);
+    bool hex = !digits.empty() && (digits[0] == 'x' || digits[0] == 'X');
+    int value = 0;
+    bool ok = hex ? base::HexStringToInt(digits.substr(1), &value)
+                  : base::StringToInt(digits, &value);
+    if (ok && value > 0 && value <= 0x10FFFF) {
+      code_point = static_cast<uint32_t>(value);
+    }
+  } else {
+    for (const auto& named : kNamedEntities) {
+      if (entity == named.name) {
+        code_point = named.code_point;
+        break;
+      }
+    }
+  }
+
+  if (!code_point) {
+    out->push_back('&');
+    out->append(entity.data(), entity.size());
+    out->push_back(';');
+    return;
+  }
+  // Non-breaking spaces are collapsed like any other whitespace.
+  if (code_point == 0xA0) {
+    code_point = ' ';
+  }
+  base::WriteUnicodeCharacter(code_point, out);
+}
+
+// Decodes character references and collapses runs of whitespace.
+std::string DecodeText(base::StringPiece raw) {
+  std::string out;
+  out.reserve(raw.size());
+  bool last_was_space = false;
+  for (size_t i = 0; i < raw.size(); ++i) {
+    char c = raw[i];
+    if (c == '&') {
+      size_t semicolon = raw.find(';', i + 1);
+      if (semicolon != base::StringPiece::npos && semicolon - i <= 10) {
+        size_t before = out.size();
+        AppendDecodedEntity(raw.substr(i + 1, semicolon - i - 1), &out);
+        if (out.size() == before + 1 && out.back() == ' ') {
+          if (last_was_space) {
+            out.pop_back();
+          }
+          last_was_space = true;
+        } else {
+          last_was_space = false;
+        }
+        i = semicolon;
+        continue;
+      }
+    }
+    if (base::IsAsciiWhitespace(c)) {
+      if (!last_was_space) {
+        out.push_back(' ');
+      }
+      last_was_space = true;
+      continue;
+    }
+    out.push_back(c);
+    last_was_space = false;
+  }
+  return out;
+}
+
+void AppendEscaped(base::StringPiece text, bool in_attribute, std::string* out) {
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        out->append("&amp;");
+        break;
+      case '<':
+        out->append("&lt;");
+        break;
+      case '>':
+        out->append("&gt;");
+        break;
+      case '"':
+        if (in_attribute) {
+          out->append("&quot;");
+        } else {
+          out->push_back(c);
+        }
+        break;
+      default:
+        out->push_back(c);
+    }
+  }
+}
+
+size_t CountWords(base::StringPiece text) {
+  size_t words = 0;
+  bool in_word = false;
+  for (char c : text) {
+    if (base::IsAsciiWhitespace(c)) {
+      in_word = false;
+    } else if (!in_word) {
+      in_word = true;
+      ++words;
+    }
+  }
+  return words;
+}
+
+// Builds a lightweight element tree out of serialized HTML. The builder is
+// deliberately forgiving: unknown end tags are ignored and mismatched ones
+// close everything up to the nearest matching open element.
+class TreeBuilder {
+ public:
+  explicit TreeBuilder(base::StringPiece html) : html_(html) {
+    root_ = std::make_unique<Node>();
+    root_->tag = "#document";
+    stack_.push_back(root_.get());
+  }
+
+  std::unique_ptr<Node> Build(std::vector<Node*>* elements) {
+    elements_ = elements;
+    size_t pos = 0;
+    while (pos < html_.size()) {
+      if (html_[pos] != '<') {
+        size_t next = html_.find('<', pos);
+        if (next == base::StringPiece::npos) {
+          next = html_.size();
+        }
+        AppendText(html_.substr(pos, next - pos));
+        pos = next;
+        continue;
+      }
+      pos = ConsumeMarkup(pos);
+    }
+    return std::move(root_);
+  }
+
+ private:
+  size_t ConsumeMarkup(size_t pos) {
+    base::StringPiece rest = html_.substr(pos);
+    if (base::StartsWith(rest, "<!--")) {
+      size_t end = html_.find("-->", pos + 4);
+      return end == base::StringPiece::npos ? html_.size() : end + 3;
+    }
+    if (base::StartsWith(rest, "<!") || base::StartsWith(rest, "<?")) {
+      size_t end = html_.find('>', pos);
+      return end == base::StringPiece::npos ? html_.size() : end + 1;
+    }
+    if (base::StartsWith(rest, "</")) {
+      size_t name_end = pos + 2;
+      while (name_end < html_.size() && IsTagNameChar(html_[name_end])) {
+        ++name_end;
+      }
+      CloseElement(base::ToLowerASCII(
+          html_.substr(pos + 2, name_end - pos - 2)));
+      size_t end = html_.find('>', name_end);
+      return end == base::StringPiece::npos ? html_.size() : end + 1;
+    }
+    if (rest.size() < 2 || !base::IsAsciiAlpha(rest[1])) {
+      AppendText(html_.substr(pos, 1));
+      return pos + 1;
+    }
+    return ConsumeStartTag(pos);
+  }
+
+  size_t ConsumeStartTag(size_t pos) {
+    size_t cursor = pos + 1;
+    while (cursor < html_.size() && IsTagNameChar(html_[cursor])) {
+      ++cursor;
+    }
+    auto node = std::make_unique<Node>();
+    node->tag = base::ToLowerASCII(html_.substr(pos + 1, cursor - pos - 1));
+
+    bool self_closing = false;
+    while (cursor < html_.size() && html_[cursor] != '>') {
+      char c = html_[cursor];
+      if (base::IsAsciiWhitespace(c)) {
+        ++cursor;
+        continue;
+      }
+      if (c == '/') {
+        self_closing = true;
+        ++cursor;
+        continue;
+      }
+      size_t name_start = cursor;
+      while (cursor < html_.size() && html_[cursor] != '=' &&
+             html_[cursor] != '>' && html_[cursor] != '/' &&
+             !base::IsAsciiWhitespace(html_[cursor])) {
+        ++cursor;
+      }
+      std::string name =
+          base::ToLowerASCII(html_.substr(name_start, cursor - name_start));
+      std::string value;
+      while (cursor < html_.size() && base::IsAsciiWhitespace(html_[cursor])) {
+        ++cursor;
+      }
+      if (cursor < html_.size() && html_[cursor] == '=') {
+        ++cursor;
+        while (cursor < html_.size() &&
+               base::IsAsciiWhitespace(html_[cursor])) {
+          ++cursor;
+        }
+        if (cursor < html_.size() &&
+            (html_[cursor] == '"' || html_[cursor] == '\'')) {
+          char quote = html_[cursor++];
+          size_t value_end = html_.find(quote, cursor);
+          if (value_end == base::StringPiece::npos) {
+            value_end = html_.size();
+          }
+          value = DecodeText(html_.substr(cursor, value_end - cursor));
+          cursor = std::min(value_end + 1, html_.size());
+        } else {
+          size_t value_start = cursor;
+          while (cursor < html_.size() && html_[cursor] != '>' &&
+                 !base::IsAsciiWhitespace(html_[cursor])) {
+            ++cursor;
+          }
+          value = DecodeText(html_.substr(value_start, cursor - value_start));
+        }
+      }
+      if (!name.empty()) {
+        node->attributes.emplace(std::move(name), std::move(value));
+      }
+    }
+    size_t tag_end = std::min(cursor + 1, html_.size());
+
+    if (IsOneOf(node->tag, kRawTextElements)) {
+      std::string closing = "</" + node->tag;
+      size_t content_end = tag_end;
+      while (true) {
+        content_end = html_.find("</", content_end);
+        if (content_end == base::StringPiece::npos) {
+          content_end = html_.size();
+          break;
+        }
+        if (base::StartsWith(html_.substr(content_end), closing,
+                             base::CompareCase::INSENSITIVE_ASCII)) {
+          break;
+        }
+        content_end += 2;
+      }
+      if (node->tag == "title") {
+        node->text =
+            DecodeText(html_.substr(tag_end, content_end - tag_end));
+      }
+      AppendElement(std::move(node), /*open=*/false);
+      size_t close = html_.find('>', content_end);
+      return close == base::StringPiece::npos ? html_.size() : close + 1;
+    }
+
+    bool open = !self_closing && !IsOneOf(node->tag, kVoidElements);
+    AppendElement(std::move(node), open);
+    return tag_end;
+  }
+
+  void AppendElement(std::unique_ptr<Node> node, bool open) {
+    if (IsOneOf(node->tag, kParagraphClosingElements) &&
+        stack_.back()->tag == "p") {
+      stack_.pop_back();
+    }
+    if (node->tag == "li" && stack_.back()->tag == "li") {
+      stack_.pop_back();
+    }
+
+    Node* parent = stack_.back();
+    node->parent = parent;
+    if (parent->removed) {
+      node->removed = true;
+    } else if (node->tag != "body" && node->tag != "article" &&
+               node->tag != "main") {
+      std::string hints = node->ClassAndId();
+      node->removed = ContainsAnyOf(hints, kUnlikelyHints) &&
+                      !ContainsAnyOf(hints, kMaybeHints);
+    }
+
+    Node* raw = node.get();
+    parent->children.push_back(std::move(node));
+    elements_->push_back(raw);
+    if (open && stack_.size() < kMaxTreeDepth) {
+      stack_.push_back(raw);
+    }
+  }
+
+  void CloseElement(const std::string& tag) {
+    for (size_t i = stack_.size() - 1; i > 0; --i) {
+      if (stack_[i]->tag == tag) {
+        stack_.resize(i);
+        return;
+      }
+    }
+  }
+
+  void AppendText(base::StringPiece raw) {
+    std::string text = DecodeText(raw);
+    // Whitespace-only runs are kept as a single separator between inline
+    // siblings and dropped everywhere else.
+    if (text.empty() || (text == " " && stack_.back()->children.empty())) {
+      return;
+    }
+    auto node = std::make_unique<Node>();
+    node->text = std::move(text);
+    node->parent = stack_.back();
+    node->removed = stack_.back()->removed;
+    stack_.back()->children.push_back(std::move(node));
+  }
+
+  base::StringPiece html_;
+  std::unique_ptr<Node> root_;
+  std::vector<Node*> stack_;
+  std::vector<Node*>* elements_ = nullptr;
+};
+
+// Post-order pass that aggregates text statistics into every element.
+void ComputeStatistics(Node* node) {
+  if (node->IsText()) {
+    node->text_length = node->removed ? 0 : node->text.size();
+    node->comma_count =
+        node->removed ? 0 : std::count(node->text.begin(), node->text.end(), ',');
+    return;
+  }
+  for (auto& child : node->children) {
+    ComputeStatistics(child.get());
+    if (child->removed) {
+      continue;
+    }
+    node->text_length += child->text_length;
+    node->comma_count += child->comma_count;
+    node->link_text_length +=
+        child->tag == "a" ? child->text_length : child->link_text_length;
+    if (!child->IsText() && IsOneOf(child->tag, kBlockElements)) {
+      node->has_block_child = true;
+    }
+  }
+}
+
+double LinkDensity(const Node* node) {
+  if (!node->text_length) {
+    return 0.0;
+  }
+  return static_cast<double>(node->link_text_length) / node->text_length;
+}
+
+int ClassWeight(const Node* node) {
+  std::string hints = node->ClassAndId();
+  if (hints.size() <= 1) {
+    return 0;
+  }
+  int weight = 0;
+  if (ContainsAnyOf(hints, kPositiveHints)) {
+    weight += 25;
+  }
+  if (ContainsAnyOf(hints, kNegativeHints)) {
+    weight -= 25;
+  }
+  return weight;
+}
+
+void InitializeCandidate(Node* node) {
+  if (node->is_candidate) {
+    return;
+  }
+  node->is_candidate = true;
+  const std::string& tag = node->tag;
+  if (tag == "div" || tag == "article" || tag == "main") {
+    node->score = 5;
+  } else if (tag == "pre" || tag == "td" || tag == "blockquote") {
+    node->score = 3;
+  } else if (tag == "address" || tag == "ol" || tag == "ul" || tag == "dl" ||
+             tag == "dd" || tag == "dt" || tag == "li" || tag == "form") {
+    node->score = -3;
+  } else if (tag == "h1" || tag == "h2" || tag == "h3" || tag == "h4" ||
+             tag == "h5" || tag == "h6" || tag == "th") {
+    node->score = -5;
+  }
+  node->score += ClassWeight(node);
+}
+
+void CollectText(const Node* node, size_t max_length, std::string* out) {
+  if (out->size() >= max_length) {
+    return;
+  }
+  if (node->IsText()) {
+    out->append(node->text);
+    return;
+  }
+  if (IsOneOf(node->tag, kDroppedElements)) {
+    return;
+  }
+  for (const auto& child : node->children) {
+    CollectText(child.get(), max_length, out);
+  }
+}
+
+std::string TrimmedText(const Node* node, size_t max_length) {
+  std::string text;
+  CollectText(node, max_length, &text);
+  base::TrimWhitespaceASCII(text, base::TRIM_ALL, &text);
+  if (text.size() > max_length) {
+    size_t cut = text.rfind(' ', max_length);
+    if (cut != std::string::npos) {
+      text.resize(cut);
+    } else {
+      // Text without spaces may end in the middle of a character.
+      base::TruncateUTF8ToByteSize(text, max_length, &text);
+    }
+    text += "\xE2\x80\xA6";  // Ellipsis.
+  }
+  return text;
+}
+
+GURL ResolveUrl(const GURL& base_url, const std::string& value) {
+  if (value.empty()) {
+    return GURL();
+  }
+  GURL resolved = base_url.is_valid() ? base_url.Resolve(value) : GURL(value);
+  return resolved.is_valid() ? resolved : GURL();
+}
+
+// Serializes the chosen content through the tag and attribute allowlist.
+class Sanitizer {
+ public:
+  Sanitizer(const GURL& document_url, ParsedArticle* article)
+      : document_url_(document_url), article_(article) {
+    article_->chunk_offsets.push_back(article_->content.size());
+  }
+
+  void Serialize(const Node* node) {
+    if (node->removed) {
+      return;
+    }
+    if (node->IsText()) {
+      AppendEscaped(node->text, /*in_attribute=*/false, &article_->content);
+      size_t words = CountWords(node->text);
+      article_->word_count += words;
+      chunk_word_count_ += words;
+      return;
+    }
+    if (IsOneOf(node->tag, kDroppedElements)) {
+      return;
+    }
+    if (!IsOneOf(node->tag, kAllowedElements)) {
+      SerializeChildren(node);
+      return;
+    }
+
+    if (node->tag == "img") {
+      SerializeImage(node);
+      return;
+    }
+
+    std::string& out = article_->content;
+    out.push_back('<');
+    out.append(node->tag);
+    if (node->tag == "a") {
+      GURL href = ResolveUrl(document_url_, node->Attribute("href"));
+      if (href.SchemeIsHTTPOrHTTPS() || href.SchemeIs("mailto")) {
+        out.append(" href=\"");
+        AppendEscaped(href.spec(), /*in_attribute=*/true, &out);
+        out.push_back('"');
+      }
+    } else if (node->tag == "td" || node->tag == "th") {
+      for (const char* span : {"colspan", "rowspan"}) {
+        int value = 0;
+        if (base::StringToInt(node->Attribute(span), &value) && value > 1 &&
+            value < 100) {
+          out.append(base::StringPrintf(" %s=\"%d\"", span, value));
+        }
+      }
+    }
+    out.push_back('>');
+
+    if (node->tag == "br" || node->tag == "hr") {
+      MaybeEndChunk(node);
+      return;
+    }
+    ++depth_;
+    SerializeChildren(node);
+    --depth_;
+    out.append("</");
+    out.append(node->tag);
+    out.push_back('>');
+    MaybeEndChunk(node);
+  }
+
+  // Drops a trailing chunk that would start at the very end of the content.
+  void Finish() {
+    std::vector<size_t>& offsets = article_->chunk_offsets;
+    while (offsets.size() > 1 && offsets.back() >= article_->content.size()) {
+      offsets.pop_back();
+    }
+  }
+
+ private:
+  // Starts a new chunk after |node| if it closed a top-level block and the
+  // current chunk is long enough. Chunks therefore never split an element.
+  void MaybeEndChunk(const Node* node) {
+    if (depth_ > 0 || chunk_word_count_ < kChunkWordCount) {
+      return;
+    }
+    if (node->tag != "hr" && !IsOneOf(node->tag, kBlockElements)) {
+      return;
+    }
+    article_->chunk_offsets.push_back(article_->content.size());
+    chunk_word_count_ = 0;
+  }
+
+  void SerializeChildren(const Node* node) {
+    for (const auto& child : node->children) {
+      Serialize(child.get());
+    }
+  }
+
+  void SerializeImage(const Node* node) {
+    // Lazy-loading pages often keep the real source in a data attribute.
+    std::string source = node->Attribute("data-src");
+    if (source.empty()) {
+      source = node->Attribute("src");
+    }
+    GURL src = ResolveUrl(document_url_, source);
+    if (!src.SchemeIsHTTPOrHTTPS()) {
+      return;
+    }
+    std::string& out = article_->content;
+    out.append("<img src=\"");
+    AppendEscaped(src.spec(), /*in_attribute=*/true, &out);
+    out.append("\" alt=\"");
+    AppendEscaped(node->Attribute("alt"), /*in_attribute=*/true, &out);
+    out.append("\" loading=\"lazy\" decoding=\"async\">");
+    if (seen_images_.insert(src.spec()).second) {
+      article_->images.push_back(src);
+    }
+  }
+
+  const GURL& document_url_;
+  ParsedArticle* article_;
+  base::flat_set<std::string> seen_images_;
+  // Number of allowed elements currently open in the output.
+  size_t depth_ = 0;
+  size_t chunk_word_count_ = 0;
+};
+
+const Node* FindFirst(const std::vector<Node*>& elements, const char* tag) {
+  for (const Node* node : elements) {
+    if (node->tag == tag) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+std::string MetaContent(const std::vector<Node*>& elements,
+                        std::initializer_list<const char*> keys) {
+  for (const char* key : keys) {
+    for (const Node* node : elements) {
+      if (node->tag != "meta") {
+        continue;
+      }
+      if (node->Attribute("property") == key || node->Attribute("name") == key) {
+        std::string content = node->Attribute("content");
+        base::TrimWhitespaceASCII(content, base::TRIM_ALL, &content);
+        if (!content.empty()) {
+          return content;
+        }
+      }
+    }
+  }
+  return std::string();
+}
+
+std::string ExtractTitle(const std::vector<Node*>& elements) {
+  std::string title = MetaContent(elements, {"og:title", "twitter:title"});
+  if (!title.empty()) {
+    return title;
+  }
+  if (const Node* node = FindFirst(elements, "title")) {
+    title = node->text;
+    base::TrimWhitespaceASCII(title, base::TRIM_ALL, &title);
+    // Strip a trailing " | Site name" when the remainder is still descriptive.
+    for (const char* separator : {" | ", " - ", " :: "}) {
+      size_t pos = title.rfind(separator);
+      if (pos != std::string::npos && CountWords(title.substr(0, pos)) >= 3) {
+        title = title.substr(0, pos);
+        break;
+      }
+    }
+    if (!title.empty()) {
+      return title;
+    }
+  }
+  if (const Node* node = FindFirst(elements, "h1")) {
+    return TrimmedText(node, kMaxExcerptLength);
+  }
+  return std::string();
+}
+
+std::string ExtractAuthor(const std::vector<Node*>& elements) {
+  std::string author = MetaContent(elements, {"author", "article:author"});
+  if (!author.empty() && !GURL(author).is_valid()) {
+    return author;
+  }
+  for (const Node* node : elements) {
+    if (node->removed || node->IsText()) {
+      continue;
+    }
+    std::string hints = node->ClassAndId();
+    if (node->Attribute("rel") == "author" ||
+        node->Attribute("itemprop") == "author" ||
+        hints.find("byline") != std::string::npos ||
+        hints.find("author") != std::string::npos) {
+      author = TrimmedText(node, kMaxAuthorLength);
+      if (!author.empty() && author.size() < kMaxAuthorLength) {
+        return author;
+      }
+    }
+  }
+  return std::string();
+}
+
+}  // namespace
+
+ParsedArticle::ParsedArticle() = default;
+ParsedArticle::ParsedArticle(ParsedArticle&& other) = default;
+ParsedArticle& ParsedArticle::operator=(ParsedArticle&& other) = default;
+ParsedArticle::~ParsedArticle() = default;
+
+ArticleParser::ArticleParser() = default;
+
+ArticleParser::~ArticleParser() = default;
+
+bool ArticleParser::Parse(base::StringPiece html,
+                          const GURL& document_url,
+                          ParsedArticle* article) {
+  std::vector<Node*> elements;
+  TreeBuilder builder(html);
+  std::unique_ptr<Node> root = builder.Build(&elements);
+  ComputeStatistics(root.get());
+
+  // Score paragraphs into their parent and grandparent.
+  std::vector<Node*> candidates;
+  for (Node* node : elements) {
+    if (node->removed) {
+      continue;
+    }
+    bool is_paragraph = node->tag == "p" || node->tag == "pre" ||
+                        node->tag == "td" ||
+                        (node->tag == "div" && !node->has_block_child);
+    if (!is_paragraph || node->text_length < kMinParagraphLength) {
+      continue;
+    }
+    double content_score =
+        1 + node->comma_count +
+        std::min<size_t>(node->text_length / 100, 3);
+
+    Node* parent = node->parent;
+    if (!parent || parent == root.get()) {
+      continue;
+    }
+    if (!parent->is_candidate) {
+      InitializeCandidate(parent);
+      candidates.push_back(parent);
+    }
+    parent->score += content_score;
+
+    Node* grandparent = parent->parent;
+    if (grandparent && grandparent != root.get()) {
+      if (!grandparent->is_candidate) {
+        InitializeCandidate(grandparent);
+        candidates.push_back(grandparent);
+      }
+      grandparent->score += content_score / 2;
+    }
+  }
+
+  const Node* top = nullptr;
+  for (Node* candidate : candidates) {
+    candidate->score *= 1.0 - LinkDensity(candidate);
+    if (!top || candidate->score > top->score) {
+      top = candidate;
+    }
+  }
+  if (!top) {
+    top = FindFirst(elements, "body");
+    if (!top || top->text_length < kMinParagraphLength) {
+      return false;
+    }
+  }
+
+  Sanitizer sanitizer(document_url, article);
+  const Node* parent = top->parent;
+  double sibling_threshold = std::max(10.0, top->score * 0.2);
+  if (parent && parent->tag != "#document") {
+    // Pull in siblings that look like they belong to the same article, such
+    // as a lead paragraph that sits outside the main content wrapper.
+    for (const auto& sibling : parent->children) {
+      if (sibling.get() == top) {
+        sanitizer.Serialize(sibling.get());
+        continue;
+      }
+      if (sibling->IsText() || sibling->removed) {
+        continue;
+      }
+      bool append = sibling->is_candidate && sibling->score >= sibling_threshold;
+      if (!append && sibling->tag == "p") {
+        append = sibling->text_length > 80 && LinkDensity(sibling.get()) < 0.25;
+      }
+      if (append) {
+        sanitizer.Serialize(sibling.get());
+      }
+    }
+  } else {
+    sanitizer.Serialize(top);
+  }
+  sanitizer.Finish();
+
+  if (!article->word_count) {
+    return false;
+  }
+
+  article->title = ExtractTitle(elements);
+  article->author = ExtractAuthor(elements);
+  article->excerpt =
+      MetaContent(elements, {"og:description", "description"});
+  if (article->excerpt.empty()) {
+    for (const Node* node : elements) {
+      if (node->tag == "p" && !node->removed &&
+          node->text_length >= kMinParagraphLength) {
+        article->excerpt = TrimmedText(node, kMaxExcerptLength);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+// static
+int ArticleParser::EstimateReadingTimeMinutes(size_t word_count) {
+  return std::max<int>(1, (word_count + kWordsPerMinute - 1) / kWordsPerMinute);
+}
+
+}  // namespace reading_mode
+}  // namespace lunetix
\ No newline at end of file
@@ -0,0 +1,54 @@
+#ifndef LUNETIX_SERVICES_READING_MODE_ARTICLE_PARSER_H_
+#define LUNETIX_SERVICES_READING_MODE_ARTICLE_PARSER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/strings/string_piece.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+namespace reading_mode {
+
+struct ParsedArticle {
+  ParsedArticle();
+  ParsedArticle(ParsedArticle&& other);
+  ParsedArticle& operator=(ParsedArticle&& other);
+  ~ParsedArticle();
+
+  std::string title;
+  std::string author;
+  std::string excerpt;
+  // Sanitized HTML of the best scoring content candidate.
+  std::string content;
+  // Offsets into |content| at which each chunk starts. Chunks only break
+  // between top-level blocks, so every chunk is well-formed on its own.
+  std::vector<size_t> chunk_offsets;
+  std::vector<GURL> images;
+  size_t word_count = 0;
+};
+
+// Readability-style article extraction that works on serialized HTML, so it
+// can run in a utility process without a DOM. The markup is tokenized into a
+// lightweight tree, paragraphs are scored into their ancestors and the best
+// candidate is serialized through a tag and attribute allowlist.
+class ArticleParser {
+ public:
+  ArticleParser();
+  ~ArticleParser();
+
+  // Returns false if |html| does not contain a readable candidate.
+  bool Parse(base::StringPiece html,
+             const GURL& document_url,
+             ParsedArticle* article);
+
+  static int EstimateReadingTimeMinutes(size_t word_count);
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ArticleParser);
+};
+
+}  // namespace reading_mode
+}  // namespace lunetix
+
+#endif  // LUNETIX_SERVICES_READING_MODE_ARTICLE_PARSER_H_
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "lunetix/services/reading_mode/article_parser.h"
+
+#include "base/strings/string_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace lunetix {
+namespace reading_mode {
+
+namespace {
+
+const char kArticleHtml[] = R"html(
+<html>
+<head>
+  <title>Why the Moon Drifts Away Every Year | Example News</title>
+  <meta name="author" content="Ada Writer">
+  <script>var tracking = "<p>not content</p>";</script>
+</head>
+<body>
+  <nav class="site-nav"><a href="/">Home</a> <a href="/world">World</a></nav>
+  <div class="sidebar">Trending: cats, dogs, more cats, and even more dogs.</div>
+  <div id="main-content" class="article-body">
+    <h1>Why the Moon Drifts Away</h1>
+    <p>The Moon moves about 3.8 centimetres further from Earth every year,
+       a fact measured with lasers bounced off mirrors left by astronauts.</p>
+    <p onclick="steal()">Tidal friction transfers angular momentum from the
+       Earth's rotation to the Moon's orbit, slowing our days slightly.</p>
+    <img data-src="/images/moon.jpg" src="placeholder.gif" alt="The Moon">
+    <p>Over billions of years, the effect adds up, and days were once far
+       shorter than they are today, according to fossil coral records.</p>
+    <iframe src="https://ads.example/frame"></iframe>
+  </div>
+  <div class="comments">Great article, thanks, I loved it, really, truly.</div>
+</body>
+</html>)html";
+
+}  // namespace
+
+class ArticleParserTest : public testing::Test {
+ protected:
+  bool Parse(const char* html, ParsedArticle* article) {
+    return parser_.Parse(html, GURL("https://news.example/science/moon"),
+                         article);
+  }
+
+  ArticleParser parser_;
+};
+
+TEST_F(ArticleParserTest, ExtractsMetadata) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(kArticleHtml, &article));
+  EXPECT_EQ(article.title, "Why the Moon Drifts Away Every Year");
+  EXPECT_EQ(article.author, "Ada Writer");
+  EXPECT_EQ(article.excerpt.find("The Moon moves"), 0u);
+  EXPECT_GT(article.word_count, 40u);
+}
+
+TEST_F(ArticleParserTest, SelectsMainContent) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(kArticleHtml, &article));
+  EXPECT_NE(article.content.find("Tidal friction"), std::string::npos);
+  EXPECT_EQ(article.content.find("Trending"), std::string::npos);
+  EXPECT_EQ(article.content.find("Great article"), std::string::npos);
+  EXPECT_EQ(article.content.find("Home"), std::string::npos);
+}
+
+TEST_F(ArticleParserTest, SanitizesContent) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(kArticleHtml, &article));
+  EXPECT_EQ(article.content.find("<script"), std::string::npos);
+  EXPECT_EQ(article.content.find("<iframe"), std::string::npos);
+  EXPECT_EQ(article.content.find("onclick"), std::string::npos);
+  EXPECT_EQ(article.content.find("not content"), std::string::npos);
+  EXPECT_EQ(article.content.find("<div"), std::string::npos);
+}
+
+TEST_F(ArticleParserTest, ResolvesImages) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(kArticleHtml, &article));
+  ASSERT_EQ(article.images.size(), 1u);
+  EXPECT_EQ(article.images[0].spec(), "https://news.example/images/moon.jpg");
+}
+
+TEST_F(ArticleParserTest, EscapesText) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse("<body><article><p>Fish &amp; chips &lt;b&gt; are a "
+                    "classic dish served all over the coast.</p></article>"
+                    "</body>",
+                    &article));
+  EXPECT_NE(article.content.find("Fish &amp; chips &lt;b&gt;"),
+            std::string::npos);
+}
+
+TEST_F(ArticleParserTest, TruncatesExcerptOnCharacterBoundary) {
+  // 67 three-byte characters without a space, so the 200 byte limit falls
+  // inside the last one.
+  std::string html = "<body><article><p>";
+  for (int i = 0; i < 67; ++i) {
+    html += "\xE6\x97\xA5";
+  }
+  html += "</p><p>Fish and chips are a classic dish served all over the "
+          "coast.</p></article></body>";
+
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(html.c_str(), &article));
+  EXPECT_TRUE(base::IsStringUTF8(article.excerpt));
+  EXPECT_EQ(article.excerpt.size(), 66u * 3 + 3);
+}
+
+TEST_F(ArticleParserTest, RejectsEmptyDocument) {
+  ParsedArticle article;
+  EXPECT_FALSE(Parse("<html><body><nav>Menu</nav></body></html>", &article));
+}
+
+TEST_F(ArticleParserTest, SplitsLongArticlesIntoChunks) {
+  std::string html = "<body><article>";
+  for (int i = 0; i < 60; ++i) {
+    html += "<p>This paragraph has exactly twenty words in it, which makes the "
+            "chunking arithmetic in this test easy to follow along.</p>";
+  }
+  html += "</article></body>";
+
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(html.c_str(), &article));
+  ASSERT_EQ(article.word_count, 1200u);
+  ASSERT_EQ(article.chunk_offsets.size(), 3u);
+  EXPECT_EQ(article.chunk_offsets[0], 0u);
+  for (size_t i = 0; i < article.chunk_offsets.size(); ++i) {
+    size_t end = i + 1 < article.chunk_offsets.size()
+                     ? article.chunk_offsets[i + 1]
+                     : article.content.size();
+    std::string chunk = article.content.substr(
+        article.chunk_offsets[i], end - article.chunk_offsets[i]);
+    EXPECT_EQ(chunk.find("<p>"), 0u);
+    EXPECT_EQ(chunk.rfind("</p>"), chunk.size() - 4);
+  }
+}
+
+TEST_F(ArticleParserTest, ShortArticleIsSingleChunk) {
+  ParsedArticle article;
+  ASSERT_TRUE(Parse(kArticleHtml, &article));
+  ASSERT_EQ(article.chunk_offsets.size(), 1u);
+  EXPECT_EQ(article.chunk_offsets[0], 0u);
+}
+
+TEST_F(ArticleParserTest, EstimateReadingTime) {
+  EXPECT_EQ(ArticleParser::EstimateReadingTimeMinutes(0), 1);
+  EXPECT_EQ(ArticleParser::EstimateReadingTimeMinutes(200), 1);
+  EXPECT_EQ(ArticleParser::EstimateReadingTimeMinutes(201), 2);
+  EXPECT_EQ(ArticleParser::EstimateReadingTimeMinutes(1000), 5);
+}
+
+}  // namespace reading_mode
+}  // namespace lunetix
\ No newline at end of file
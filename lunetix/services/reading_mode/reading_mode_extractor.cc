@@ -0,0 +1,39 @@
+#include "lunetix/services/reading_mode/reading_mode_extractor.h"
+
+#include "lunetix/services/reading_mode/article_parser.h"
+
+namespace lunetix {
+namespace reading_mode {
+
+ReadingModeExtractor::ReadingModeExtractor(
+    mojo::PendingReceiver<mojom::ReadingModeExtractor> receiver)
+    : receiver_(this, std::move(receiver)) {}
+
+ReadingModeExtractor::~ReadingModeExtractor() = default;
+
+void ReadingModeExtractor::ExtractArticle(const std::string& html,
+                                          const GURL& document_url,
+                                          ExtractArticleCallback callback) {
+  ParsedArticle parsed;
+  ArticleParser parser;
+  if (!parser.Parse(html, document_url, &parsed)) {
+    std::move(callback).Run(nullptr);
+    return;
+  }
+
+  auto article = mojom::ReadingArticle::New();
+  article->title = std::move(parsed.title);
+  article->author = std::move(parsed.author);
+  article->excerpt = std::move(parsed.excerpt);
+  article->content = std::move(parsed.content);
+  article->chunk_offsets.assign(parsed.chunk_offsets.begin(),
+                                parsed.chunk_offsets.end());
+  article->images = std::move(parsed.images);
+  article->word_count = static_cast<uint32_t>(parsed.word_count);
+  article->reading_time_minutes =
+      ArticleParser::EstimateReadingTimeMinutes(parsed.word_count);
+  std::move(callback).Run(std::move(article));
+}
+
+}  // namespace reading_mode
+}  // namespace lunetix
\ No newline at end of file
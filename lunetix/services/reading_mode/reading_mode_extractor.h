@@ -0,0 +1,33 @@
+#ifndef LUNETIX_SERVICES_READING_MODE_READING_MODE_EXTRACTOR_H_
+#define LUNETIX_SERVICES_READING_MODE_READING_MODE_EXTRACTOR_H_
+
+#include "lunetix/services/reading_mode/public/mojom/reading_mode_extractor.mojom.h"
+#include "mojo/public/cpp/bindings/pending_receiver.h"
+#include "mojo/public/cpp/bindings/receiver.h"
+
+namespace lunetix {
+namespace reading_mode {
+
+// Implementation of the reading mode extractor service. Lives on the main
+// thread of a sandboxed utility process.
+class ReadingModeExtractor : public mojom::ReadingModeExtractor {
+ public:
+  explicit ReadingModeExtractor(
+      mojo::PendingReceiver<mojom::ReadingModeExtractor> receiver);
+  ~ReadingModeExtractor() override;
+
+  // mojom::ReadingModeExtractor overrides:
+  void ExtractArticle(const std::string& html,
+                      const GURL& document_url,
+                      ExtractArticleCallback callback) override;
+
+ private:
+  mojo::Receiver<mojom::ReadingModeExtractor> receiver_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadingModeExtractor);
+};
+
+}  // namespace reading_mode
+}  // namespace lunetix
+
+#endif  // LUNETIX_SERVICES_READING_MODE_READING_MODE_EXTRACTOR_H_
\ No newline at end of file
@@ -1,11 +1,20 @@
 #!/usr/bin/env python3
 
 import os
+import re
 import sys
+import json
 import subprocess
 import argparse
 from pathlib import Path
 
+# Upper bounds for the results of the perftests, per test executable.
+PERF_BUDGETS = Path(__file__).parent / 'perf_budgets.json'
+
+# "*RESULT <metric>: <story>= <value> <units>", as printed by
+# perf_test::PerfResultReporter.
+PERF_RESULT_RE = re.compile(r'^\*?RESULT ([^:]+): ([^=]+)= (\S+) (\S+)$')
+
 def run_unit_tests(src_dir, test_filter=None):
     """Run Lunetix unit tests."""
     test_targets = [
@@ -53,6 +62,55 @@ def run_integration_tests(src_dir):
         print(f"✗ Integration tests failed with exit code {e.returncode}")
         return False
 
+def parse_perf_results(output):
+    """Map each metric printed by a perftest to its value."""
+    results = {}
+    for line in output.splitlines():
+        match = PERF_RESULT_RE.match(line.strip())
+        if match:
+            try:
+                results[match.group(1)] = float(match.group(3))
+            except ValueError:
+                pass
+    return results
+
+def run_perftests(src_dir):
+    """Run Lunetix perftests and check their results against the budgets."""
+    with open(PERF_BUDGETS, 'r') as f:
+        budgets = json.load(f)
+    
+    success = True
+    for target, target_budgets in budgets.items():
+        test_exe = src_dir / 'out' / 'Release' / f'{target}.exe'
+        
+        if not test_exe.exists():
+            print(f"⚠ Perftest not found: {test_exe}")
+            continue
+        
+        print(f"Running {target}...")
+        result = subprocess.run([str(test_exe)], cwd=src_dir,
+                                capture_output=True, text=True)
+        print(result.stdout, end='')
+        if result.returncode != 0:
+            print(f"✗ {target} failed with exit code {result.returncode}")
+            success = False
+            continue
+        
+        results = parse_perf_results(result.stdout)
+        for metric, budget in target_budgets.items():
+            value = results.get(metric)
+            if value is None:
+                print(f"✗ {metric} was not reported")
+                success = False
+            elif value > budget['max']:
+                print(f"✗ {metric}: {value} {budget['units']} is over the "
+                      f"budget of {budget['max']} {budget['units']}")
+                success = False
+            else:
+                print(f"✓ {metric}: {value} {budget['units']}")
+    
+    return success
+
 def run_performance_tests(src_dir):
     """Run Lunetix performance tests."""
     perf_cmd = [
@@ -163,6 +221,7 @@ def main():
         success &= run_integration_tests(src_dir)
     
     if args.test_type in ['performance', 'all']:
+        success &= run_perftests(src_dir)
         success &= run_performance_tests(src_dir)
     
     if args.test_type in ['security', 'all']:
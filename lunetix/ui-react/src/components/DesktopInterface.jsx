@@ -164,6 +164,7 @@ const DesktopInterface = () => {
   const QuickLink = ({ title, url, description }) => (
     <motion.button
       whileHover={{ x: 4 }}
+      onMouseEnter={() => bridge.prefetchHint(url)}
       onClick={() => handleNavigate(url)}
       className="flex items-center w-full p-3 rounded-lg hover:bg-white/50 transition-all duration-200 group"
     >
@@ -17,6 +17,7 @@ const MobileAddressBar = ({
   onReload, 
   onBack, 
   onForward,
+  onPrefetchHint,
   canGoBack = false,
   canGoForward = false,
   isLoading = false 
@@ -30,6 +31,13 @@ const MobileAddressBar = ({
     setInputValue(url);
   }, [url]);
 
+  // Hint the address being typed once typing pauses.
+  useEffect(() => {
+    if (!isFocused || !onPrefetchHint) return;
+    const timer = setTimeout(() => onPrefetchHint(inputValue), 300);
+    return () => clearTimeout(timer);
+  }, [inputValue, isFocused]);
+
   const handleSubmit = (e) => {
     e.preventDefault();
     if (inputValue.trim()) {
@@ -226,6 +226,7 @@ const MobileInterface = () => {
         onReload={() => bridge.reload()}
         onBack={() => bridge.goBack()}
         onForward={() => bridge.goForward()}
+        onPrefetchHint={(input) => bridge.prefetchHint(input)}
         canGoBack={canGoBack}
         canGoForward={canGoForward}
         isLoading={isLoading}
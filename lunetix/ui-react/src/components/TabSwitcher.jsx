@@ -1,6 +1,7 @@
-import React, { useState } from 'react';
+import React, { useState, useEffect, useMemo, useRef } from 'react';
 import { motion, AnimatePresence } from 'framer-motion';
-import { X, Plus, Grid3X3 } from 'lucide-react';
+import { X, Plus, Grid3X3, Search } from 'lucide-react';
+import browserBridge from '../utils/browserBridge';
 
 const TabSwitcher = ({ 
   isOpen, 
@@ -12,6 +13,43 @@ const TabSwitcher = ({
   onNewTab 
 }) => {
   const [hoveredTab, setHoveredTab] = useState(null);
+  const [query, setQuery] = useState('');
+  const [matchedTabIds, setMatchedTabIds] = useState(null);
+  const searchRequestRef = useRef(0);
+
+  // Matching runs against the native index; only the latest request counts.
+  useEffect(() => {
+    return browserBridge.on('tabSearchResults', ({ requestId, results }) => {
+      if (requestId === searchRequestRef.current) {
+        setMatchedTabIds(results.map(result => result.tabId));
+      }
+    });
+  }, []);
+
+  useEffect(() => {
+    if (!isOpen) {
+      setQuery('');
+    }
+  }, [isOpen]);
+
+  useEffect(() => {
+    if (!query.trim()) {
+      searchRequestRef.current = 0;
+      setMatchedTabIds(null);
+      return;
+    }
+    searchRequestRef.current = browserBridge.searchTabs(query);
+  }, [query]);
+
+  const visibleTabs = useMemo(() => {
+    if (!matchedTabIds) {
+      return tabs;
+    }
+    const tabsById = new Map(tabs.map(tab => [tab.id, tab]));
+    return matchedTabIds
+      .map(tabId => tabsById.get(tabId))
+      .filter(Boolean);
+  }, [tabs, matchedTabIds]);
 
   const overlayVariants = {
     hidden: { opacity: 0 },
@@ -222,6 +260,27 @@ const TabSwitcher = ({
               </div>
 
               <div className="flex items-center space-x-2">
+                {/* Search */}
+                <div className="flex items-center space-x-2 px-3 py-2 bg-white/60 rounded-lg border border-white/30">
+                  <Search size={16} className="text-apple-gray-500" />
+                  <input
+                    autoFocus
+                    type="text"
+                    value={query}
+                    onChange={(e) => setQuery(e.target.value)}
+                    onKeyDown={(e) => {
+                      if (e.key === 'Enter' && visibleTabs.length > 0) {
+                        onTabSelect(visibleTabs[0].id);
+                        onClose();
+                      } else if (e.key === 'Escape') {
+                        onClose();
+                      }
+                    }}
+                    placeholder="Search tabs"
+                    className="w-48 bg-transparent text-sm text-apple-gray-700 placeholder-apple-gray-500 outline-none"
+                  />
+                </div>
+
                 {/* New Tab Button */}
                 <motion.button
                   onClick={() => {
@@ -250,13 +309,13 @@ const TabSwitcher = ({
 
             {/* Tabs Grid */}
             <div className="flex-1 overflow-auto p-6">
-              {tabs.length > 0 ? (
+              {visibleTabs.length > 0 ? (
                 <motion.div 
                   className="grid grid-cols-1 sm:grid-cols-2 lg:grid-cols-3 xl:grid-cols-4 gap-4"
                   variants={containerVariants}
                 >
                   <AnimatePresence mode="popLayout">
-                    {tabs.map((tab, index) => (
+                    {visibleTabs.map((tab, index) => (
                       <TabCard key={tab.id} tab={tab} index={index} />
                     ))}
                   </AnimatePresence>
@@ -270,7 +329,7 @@ const TabSwitcher = ({
                     <Grid3X3 size={32} className="text-apple-gray-500" />
                   </div>
                   <h3 className="text-lg font-semibold text-apple-gray-700 mb-2">
-                    No tabs open
+                    {matchedTabIds ? 'No matching tabs' : 'No tabs open'}
                   </h3>
                   <p className="text-apple-gray-500 mb-6">
                     Create a new tab to get started
@@ -114,6 +114,24 @@ class LunetixBrowserBridge {
     this.sendToBackend('navigation', { action: 'stop' });
   }
 
+  /**
+   * Hint that a navigation to url is likely, e.g. while the address is
+   * typed or a link is hovered, so the backend can preconnect to it and to
+   * the origins its pages need. Input that is not a host or URL is ignored.
+   */
+  prefetchHint(input) {
+    const text = (input || '').trim();
+    if (!text || /\s/.test(text)) return;
+
+    const url = /^https?:\/\//i.test(text) ? text : `https://${text}`;
+    try {
+      if (!new URL(url).hostname.includes('.')) return;
+    } catch (error) {
+      return;
+    }
+    this.sendToBackend('prefetchHint', { url });
+  }
+
   /**
    * Tab Management
    */
@@ -133,6 +151,20 @@ class LunetixBrowserBridge {
     this.sendToBackend('tab', { action: 'update', tabId, properties });
   }
 
+  /**
+   * Fuzzy search over open tabs. Results arrive as a 'tabSearchResults'
+   * message carrying the returned requestId, best matches first.
+   */
+  searchTabs(query, maxResults = 50) {
+    this.searchRequestId = (this.searchRequestId || 0) + 1;
+    this.sendToBackend('tabSearch', {
+      query,
+      maxResults,
+      requestId: this.searchRequestId
+    });
+    return this.searchRequestId;
+  }
+
   /**
    * Window Management
    */
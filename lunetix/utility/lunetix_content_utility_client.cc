@@ -1,7 +1,20 @@
 #include "lunetix/utility/lunetix_content_utility_client.h"
 
+#include "lunetix/services/reading_mode/reading_mode_extractor.h"
+#include "mojo/public/cpp/bindings/service_factory.h"
+
 namespace lunetix {
 
+namespace {
+
+auto RunReadingModeExtractor(
+    mojo::PendingReceiver<reading_mode::mojom::ReadingModeExtractor> receiver) {
+  return std::make_unique<reading_mode::ReadingModeExtractor>(
+      std::move(receiver));
+}
+
+}  // namespace
+
 LunetixContentUtilityClient::LunetixContentUtilityClient() = default;
 
 LunetixContentUtilityClient::~LunetixContentUtilityClient() = default;
@@ -13,6 +26,7 @@ void LunetixContentUtilityClient::UtilityThreadStarted() {
 void LunetixContentUtilityClient::RegisterMainThreadServices(
     mojo::ServiceFactory& services) {
   ChromeContentUtilityClient::RegisterMainThreadServices(services);
+  services.Add(RunReadingModeExtractor);
 }
 
 void LunetixContentUtilityClient::RegisterIOThreadServices(